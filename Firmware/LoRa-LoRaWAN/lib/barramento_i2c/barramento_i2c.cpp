@@ -0,0 +1,338 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  barramento_i2c.cpp
+ *
+ *    Description:  -
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 23:44:52
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include "barramento_i2c.hpp"
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#ifdef BARRAMENTO_I2C_DMA
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#endif
+
+/* Um objeto por controlador, indexado por i2c_hw_index() */
+static BarramentoI2C barramentos[2];
+
+BarramentoI2C *barramento_i2c(i2c_inst_t *i2c) {
+    BarramentoI2C *b = &barramentos[i2c_hw_index(i2c)];
+    b->i2c = i2c;
+    return b;
+}
+
+
+/* ============================================================================
+ *  Baud por dispositivo
+ * ============================================================================
+*/
+
+/**
+ * @brief Maior SCL que o clk_peri atual permite, até o baud pedido
+*/
+static uint32_t baud_efetivo(uint32_t baud) {
+    uint32_t maximo = clock_get_hz(clk_peri) / BARRAMENTO_I2C_CLK_POR_SCL;
+    return (baud < maximo) ? baud : maximo;
+}
+
+/**
+ * @brief Programa o divisor de SCL apenas se o baud ou o clk_peri mudaram desde a
+ *        última programação (dispositivos de velocidades diferentes se alternando)
+*/
+static void ajusta_baud(BarramentoI2C *b, uint32_t baud) {
+    uint32_t efetivo = baud_efetivo(baud);
+    uint32_t clk_peri_hz = clock_get_hz(clk_peri);
+    if (efetivo == b->baud && clk_peri_hz == b->clk_peri_hz) return;
+
+    i2c_set_baudrate(b->i2c, efetivo);
+    b->baud = efetivo;
+    b->clk_peri_hz = clk_peri_hz;
+    b->trocas_baud++;
+}
+
+void reajusta_barramento_i2c(i2c_inst_t *i2c, uint32_t baud) {
+    BarramentoI2C *b = barramento_i2c(i2c);
+    uint32_t efetivo = baud_efetivo(baud);
+
+    i2c_set_baudrate(i2c, efetivo);
+    b->baud = efetivo;
+    b->clk_peri_hz = clock_get_hz(clk_peri);
+}
+
+/**
+ * @brief Prazo de uma transferência: o dobro do tempo nominal (9 bits por byte, mais
+ *        o byte de endereço) somado a BARRAMENTO_I2C_FOLGA_US
+*/
+static uint32_t prazo_us(const BarramentoI2C *b, size_t bytes) {
+    uint32_t nominal = (uint32_t)(((uint64_t)(bytes + 1) * 9 * 1000000 + b->baud - 1) / b->baud);
+    return 2 * nominal + BARRAMENTO_I2C_FOLGA_US;
+}
+
+
+/* ============================================================================
+ *  Inicialização
+ * ============================================================================
+*/
+
+#ifdef BARRAMENTO_I2C_DMA
+/* O handler só mascara as interrupções do controlador: o fim da transação é lido em
+   IC_RAW_INTR_STAT, e a entrada no handler basta para tirar o núcleo do __wfe() */
+static void irq_i2c0(void) { i2c_get_hw(i2c0)->intr_mask = 0; }
+static void irq_i2c1(void) { i2c_get_hw(i2c1)->intr_mask = 0; }
+
+static void prepara_dma(BarramentoI2C *b) {
+    b->canal_tx = dma_claim_unused_channel(true);
+    b->canal_rx = dma_claim_unused_channel(true);
+
+    uint irq = (b->i2c == i2c0) ? I2C0_IRQ : I2C1_IRQ;
+    i2c_get_hw(b->i2c)->intr_mask = 0;
+    irq_set_exclusive_handler(irq, (b->i2c == i2c0) ? irq_i2c0 : irq_i2c1);
+    irq_set_enabled(irq, true);
+}
+#endif
+
+/**
+ * @brief Configura o controlador e os pinos na primeira chamada.
+ *
+ * Cada driver chama esta função na sua inicialização; antes, cada um refazia o
+ * i2c_init() e o gpio_set_function() dos mesmos pinos.
+*/
+void inicializa_barramento_i2c(i2c_inst_t *i2c, uint sda_pin, uint scl_pin) {
+    BarramentoI2C *b = barramento_i2c(i2c);
+    if (b->inicializado) return;
+
+    b->sda_pin = sda_pin;
+    b->scl_pin = scl_pin;
+
+    /* Inicializando o controlador no baud padrão (guardado como pedido: o i2c_init() devolve
+       o SCL real, arredondado pelo divisor, e a comparação em ajusta_baud() falharia) */
+    b->baud = baud_efetivo(BARRAMENTO_I2C_BAUD_PADRAO);
+    i2c_init(i2c, b->baud);
+    b->clk_peri_hz = clock_get_hz(clk_peri);
+
+    /* Configurando pinos SDA e SCL para função I2C */
+    gpio_set_function(sda_pin, GPIO_FUNC_I2C);
+    gpio_set_function(scl_pin, GPIO_FUNC_I2C);
+
+    /* Habilitando resistores de pull-up nos pinos SDA e SCL */
+    // gpio_pull_up(sda_pin);
+    // gpio_pull_up(scl_pin);
+
+#ifdef BARRAMENTO_I2C_DMA
+    prepara_dma(b);
+#endif
+    b->inicializado = true;
+}
+
+
+/* ============================================================================
+ *  Recuperação do barramento
+ * ============================================================================
+*/
+
+/**
+ * @brief Gera os pulsos de SCL e o STOP por GPIO em dreno aberto.
+ *
+ * Um escravo reiniciado (ou o MCU) no meio de um byte pode ficar segurando SDA
+ * à espera dos pulsos que faltam. Com os pinos como GPIO, a saída em 0 puxa a
+ * linha e a entrada a solta para o pull-up. Cada pulso deixa o escravo avançar
+ * um bit; quando SDA sobe, o STOP devolve todos os escravos ao estado ocioso.
+*/
+bool recupera_barramento_i2c(i2c_inst_t *i2c) {
+    BarramentoI2C *b = barramento_i2c(i2c);
+    if (!b->inicializado) return false;
+    b->recuperacoes++;
+
+    /* Assumindo os pinos como GPIO: entradas (linhas soltas) com o latch de saída em 0 */
+    gpio_init(b->sda_pin);
+    gpio_init(b->scl_pin);
+
+    for (uint i = 0; i < BARRAMENTO_I2C_PULSOS_RECUPERACAO && !gpio_get(b->sda_pin); i++) {
+        gpio_set_dir(b->scl_pin, GPIO_OUT);
+        busy_wait_us_32(BARRAMENTO_I2C_MEIO_PERIODO_US);
+        gpio_set_dir(b->scl_pin, GPIO_IN);
+        busy_wait_us_32(BARRAMENTO_I2C_MEIO_PERIODO_US);
+    }
+
+    /* STOP: SDA sobe enquanto SCL está em nível alto */
+    gpio_set_dir(b->scl_pin, GPIO_OUT);
+    gpio_set_dir(b->sda_pin, GPIO_OUT);
+    busy_wait_us_32(BARRAMENTO_I2C_MEIO_PERIODO_US);
+    gpio_set_dir(b->scl_pin, GPIO_IN);
+    busy_wait_us_32(BARRAMENTO_I2C_MEIO_PERIODO_US);
+    gpio_set_dir(b->sda_pin, GPIO_IN);
+    busy_wait_us_32(BARRAMENTO_I2C_MEIO_PERIODO_US);
+
+    bool livre = gpio_get(b->sda_pin) && gpio_get(b->scl_pin);
+
+    /* Devolvendo os pinos ao controlador, reiniciado para descartar o estado da transação abortada */
+    i2c_deinit(i2c);
+    i2c_init(i2c, b->baud);
+    b->clk_peri_hz = clock_get_hz(clk_peri);
+    gpio_set_function(b->sda_pin, GPIO_FUNC_I2C);
+    gpio_set_function(b->scl_pin, GPIO_FUNC_I2C);
+
+#ifdef BARRAMENTO_I2C_DMA
+    i2c_get_hw(i2c)->intr_mask = 0;
+#endif
+    return livre;
+}
+
+
+/* ============================================================================
+ *  Transações
+ * ============================================================================
+*/
+
+#ifdef BARRAMENTO_I2C_DMA
+/**
+ * @brief Executa a transação inteira por DMA e mantém o núcleo em __wfe() até o STOP.
+ *
+ * Cada byte vira uma palavra de IC_DATA_CMD: os de escrita com o dado, os de
+ * leitura com CMD (o primeiro com RESTART) e o último com STOP. O canal TX
+ * alimenta a FIFO pelo DREQ e o canal RX esvazia a FIFO de leitura na RAM.
+ * O controlador gera STOP ao fim e também após um NACK (TX_ABRT), então
+ * STOP_DET marca o fim em ambos os casos; um escravo segurando SDA impede o
+ * START e o prazo do __wfe() encerra a espera.
+ *
+ * @return Bytes transferidos, PICO_ERROR_GENERIC (NACK) ou PICO_ERROR_TIMEOUT
+*/
+static int transacao_dma(BarramentoI2C *b, uint8_t endereco, const uint8_t *escrita, size_t n_escrita,
+                         uint8_t *leitura, size_t n_leitura) {
+    static uint32_t comandos[BARRAMENTO_I2C_MAX_DMA];
+    size_t n = n_escrita + n_leitura;
+    if (n == 0 || n > BARRAMENTO_I2C_MAX_DMA) return PICO_ERROR_GENERIC;
+
+    /* Montando as palavras de comando */
+    for (size_t i = 0; i < n_escrita; i++) {
+        comandos[i] = escrita[i];
+    }
+    for (size_t i = 0; i < n_leitura; i++) {
+        comandos[n_escrita + i] = I2C_IC_DATA_CMD_CMD_BITS
+                                | ((i == 0 && n_escrita) ? I2C_IC_DATA_CMD_RESTART_BITS : 0);
+    }
+    comandos[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    /* Trocando o endereço do escravo (IC_TAR só muda com o controlador desabilitado) */
+    i2c_hw_t *hw = i2c_get_hw(b->i2c);
+    hw->enable = 0;
+    hw->tar = endereco;
+    hw->enable = 1;
+
+    /* Limpando STOP_DET e TX_ABRT da transação anterior e habilitando as duas interrupções */
+    (void)hw->clr_intr;
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+
+    if (n_leitura) {
+        dma_channel_config rx = dma_channel_get_default_config(b->canal_rx);
+        channel_config_set_transfer_data_size(&rx, DMA_SIZE_8);
+        channel_config_set_read_increment(&rx, false);
+        channel_config_set_write_increment(&rx, true);
+        channel_config_set_dreq(&rx, i2c_get_dreq(b->i2c, false));
+        dma_channel_configure(b->canal_rx, &rx, leitura, &hw->data_cmd, n_leitura, true);
+    }
+
+    dma_channel_config tx = dma_channel_get_default_config(b->canal_tx);
+    channel_config_set_transfer_data_size(&tx, DMA_SIZE_32);
+    channel_config_set_read_increment(&tx, true);
+    channel_config_set_write_increment(&tx, false);
+    channel_config_set_dreq(&tx, i2c_get_dreq(b->i2c, true));
+    dma_channel_configure(b->canal_tx, &tx, &hw->data_cmd, comandos, n, true);
+
+    /* Núcleo parado enquanto os bytes passam; a interrupção de STOP_DET ou TX_ABRT o acorda */
+    absolute_time_t prazo = make_timeout_time_us(prazo_us(b, n + (n_escrita && n_leitura)));
+    while (!(hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS)) {
+        if (best_effort_wfe_or_timeout(prazo)) break;
+    }
+
+    hw->intr_mask = 0;
+    uint32_t estado = hw->raw_intr_stat;
+    bool concluida = (estado & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS) && !(estado & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS);
+
+    if (!concluida) {
+        dma_channel_abort(b->canal_tx);
+        if (n_leitura) dma_channel_abort(b->canal_rx);
+    }
+    (void)hw->clr_intr;
+
+    if (!(estado & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS)) return PICO_ERROR_TIMEOUT;
+    if (!concluida) return PICO_ERROR_GENERIC;
+
+    /* O último byte lido chega à RAM logo após o STOP */
+    while (n_leitura && dma_channel_is_busy(b->canal_rx)) {
+        tight_loop_contents();
+    }
+    return (int)n;
+}
+#else
+/**
+ * @brief Executa a transação com as funções *_timeout_us do SDK (núcleo em espera ativa)
+ *
+ * @return Bytes transferidos, PICO_ERROR_GENERIC (NACK) ou PICO_ERROR_TIMEOUT
+*/
+static int transacao_cpu(BarramentoI2C *b, uint8_t endereco, const uint8_t *escrita, size_t n_escrita,
+                         uint8_t *leitura, size_t n_leitura) {
+    int ret;
+    if (n_escrita) {
+        /* Sem STOP quando há leitura a seguir: ela começa com START repetido */
+        ret = i2c_write_timeout_us(b->i2c, endereco, escrita, n_escrita, n_leitura != 0, prazo_us(b, n_escrita));
+        if (ret != (int)n_escrita) return (ret == PICO_ERROR_TIMEOUT) ? ret : PICO_ERROR_GENERIC;
+    }
+    if (n_leitura) {
+        ret = i2c_read_timeout_us(b->i2c, endereco, leitura, n_leitura, false, prazo_us(b, n_leitura));
+        if (ret != (int)n_leitura) return (ret == PICO_ERROR_TIMEOUT) ? ret : PICO_ERROR_GENERIC;
+    }
+    return (int)(n_escrita + n_leitura);
+}
+#endif
+
+/**
+ * @brief Transação no baud do dispositivo, com prazo e recuperação.
+ *
+ * Um NACK é devolvido ao driver sem novas tentativas: para o SHT30 ele indica
+ * conversão em andamento. Apenas o estouro do prazo (escravo segurando SDA ou
+ * SCL) aciona a recuperação, seguida de uma nova tentativa da transação inteira,
+ * de modo que a parte de escrita (registrador inicial, comando) também é refeita.
+*/
+bool barramento_i2c_transacao(i2c_inst_t *i2c, uint8_t endereco, uint32_t baud,
+                              const uint8_t *escrita, size_t n_escrita,
+                              uint8_t *leitura, size_t n_leitura) {
+    BarramentoI2C *b = barramento_i2c(i2c);
+    if (!b->inicializado || (n_escrita + n_leitura) == 0) return false;
+
+    for (uint tentativa = 0; tentativa < 2; tentativa++) {
+        ajusta_baud(b, baud);
+
+#ifdef BARRAMENTO_I2C_DMA
+        int ret = transacao_dma(b, endereco, escrita, n_escrita, leitura, n_leitura);
+#else
+        int ret = transacao_cpu(b, endereco, escrita, n_escrita, leitura, n_leitura);
+#endif
+        if (ret == (int)(n_escrita + n_leitura)) {
+            b->transacoes++;
+            return true;
+        }
+        if (ret != PICO_ERROR_TIMEOUT) {
+            b->nacks++;
+            return false;
+        }
+
+        b->timeouts++;
+        if (!recupera_barramento_i2c(i2c)) return false;
+    }
+    return false;
+}
+
+/*****************************END OF FILE**************************************/
@@ -0,0 +1,110 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  barramento_i2c.hpp
+ *
+ *    Description:  Barramento I2C compartilhado pelos drivers (DS3231 e SHT30): um
+ *                  objeto por controlador, com baud por dispositivo, transações com
+ *                  prazo, recuperação por 9 pulsos de SCL e transferência por DMA.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 23:41:18
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#ifndef BARRAMENTO_I2C_HPP
+#define BARRAMENTO_I2C_HPP
+
+#include <Arduino.h>
+#include "hardware/i2c.h"
+
+/****************************************************************************
+**                          CONFIGURAÇÃO DO BARRAMENTO
+*****************************************************************************/
+
+/* Baud programado no início (o do dispositivo mais lento: DS3231 em Fast-mode) */
+#define BARRAMENTO_I2C_BAUD_PADRAO        (400 * 1000)
+
+/* Menor razão entre clk_peri e SCL (IC_CLK mínimo do datasheet, a mesma de clock_despertar):
+   em clk_peri de 12 MHz o SCL fica limitado a 400 kHz, mesmo para um dispositivo Fm+ */
+#define BARRAMENTO_I2C_CLK_POR_SCL        30
+
+/* Folga somada ao dobro do tempo nominal da transação antes de considerá-la travada */
+#define BARRAMENTO_I2C_FOLGA_US           1000
+
+/* Recuperação: pulsos de SCL (8 bits e o ACK de um byte interrompido) a 100 kHz */
+#define BARRAMENTO_I2C_PULSOS_RECUPERACAO 9
+#define BARRAMENTO_I2C_MEIO_PERIODO_US    5
+
+/* Maior transação por DMA (bytes escritos + lidos), em palavras de comando de 32 bits */
+#define BARRAMENTO_I2C_MAX_DMA            32
+
+/* Estado de um controlador I2C e dos pinos ligados a ele */
+typedef struct {
+    i2c_inst_t *i2c;
+    uint sda_pin;
+    uint scl_pin;
+    bool inicializado;
+    uint32_t baud;              /* Baud programado por último (já limitado pelo clk_peri) */
+    uint32_t clk_peri_hz;       /* clk_peri em que esse baud foi programado */
+#ifdef BARRAMENTO_I2C_DMA
+    int canal_tx;               /* Palavras de comando para IC_DATA_CMD */
+    int canal_rx;               /* Bytes lidos de IC_DATA_CMD para a RAM */
+#endif
+
+    /* Contadores acumulados desde o boot */
+    uint32_t transacoes;        /* Transações concluídas com sucesso */
+    uint32_t nacks;             /* Endereço ou dado sem ACK (sensor ocupado, ausente...) */
+    uint32_t timeouts;          /* Transações que estouraram o prazo */
+    uint32_t recuperacoes;      /* Sequências de 9 pulsos de SCL aplicadas */
+    uint32_t trocas_baud;       /* Reprogramações do divisor de SCL */
+} BarramentoI2C;
+
+/****************************************************************************
+**                            FUNÇÕES AUXILIARES DE USO
+*****************************************************************************/
+
+/**
+ * @brief Objeto do barramento de um controlador (i2c0 ou i2c1)
+*/
+BarramentoI2C *barramento_i2c(i2c_inst_t *i2c);
+
+/**
+ * @brief Configura os pinos e o controlador uma única vez; as chamadas seguintes
+ *        (um driver por dispositivo) não refazem o i2c_init()
+*/
+void inicializa_barramento_i2c(i2c_inst_t *i2c, uint sda_pin, uint scl_pin);
+
+/**
+ * @brief Escreve n_escrita bytes e, se n_leitura > 0, lê n_leitura com START repetido,
+ *        no baud do dispositivo e com prazo. Um barramento travado é recuperado e a
+ *        transação repetida uma vez
+ *
+ * @param baud Maior SCL aceito pelo dispositivo (limitado pelo clk_peri atual)
+ * @return true se todos os bytes foram transferidos com ACK
+*/
+bool barramento_i2c_transacao(i2c_inst_t *i2c, uint8_t endereco, uint32_t baud,
+                              const uint8_t *escrita, size_t n_escrita,
+                              uint8_t *leitura, size_t n_leitura);
+
+/**
+ * @brief Libera um escravo que prende SDA em nível baixo: até 9 pulsos de SCL por GPIO,
+ *        um STOP e a reinicialização do controlador
+ *
+ * @return true se SDA e SCL ficaram livres
+*/
+bool recupera_barramento_i2c(i2c_inst_t *i2c);
+
+/**
+ * @brief Reprograma o baud após uma troca de clk_peri (usada por clock_despertar)
+*/
+void reajusta_barramento_i2c(i2c_inst_t *i2c, uint32_t baud);
+
+#endif
+/*****************************END OF FILE**************************************/
@@ -0,0 +1,77 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  bateria.cpp
+ *
+ *    Description:  -
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 23:59:59
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include "bateria.hpp"
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+
+#define XOSC_HZ (XOSC_MHZ * MHZ)
+
+#if BATERIA_GPIO < 26 || BATERIA_GPIO > 29
+#error "BATERIA_GPIO deve ser uma das entradas do ADC (GPIO 26 a 29)"
+#endif
+
+uint8_t nivel_bateria_lorawan(uint16_t tensao_mv) {
+  if (tensao_mv >= BATERIA_EXTERNA_MV) return BATERIA_NIVEL_EXTERNA;
+  if (tensao_mv <= BATERIA_VAZIA_MV) return 1;
+  if (tensao_mv >= BATERIA_CHEIA_MV) return 254;
+  return (uint8_t)(1 + (uint32_t)(tensao_mv - BATERIA_VAZIA_MV) * 253 / (BATERIA_CHEIA_MV - BATERIA_VAZIA_MV));
+}
+
+/**
+ * @brief Mede VSYS pelo divisor com o ADC ligado só durante as conversões.
+ *
+ * O clk_adc vem do XOSC, que está ligado em todo despertar: o perfil dos
+ * sensores (CLOCK_DESPERTAR_PERFIS) e o sleep_run_from_xosc() deixam o clk_adc
+ * parado, e religar o PLL_USB só para o ADC custaria mais que a própria medição.
+ * A 12 MHz o ADC leva 8 us por conversão, e o conjunto fica em ~150 us.
+*/
+bool mede_bateria(LeituraBateria *leitura) {
+  leitura->tensao_mv = 0;
+  leitura->nivel = BATERIA_NIVEL_DESCONHECIDO;
+
+  if (!clock_configure(clk_adc, 0, CLOCKS_CLK_ADC_CTRL_AUXSRC_VALUE_XOSC_CLKSRC, XOSC_HZ, XOSC_HZ)) {
+    return false;
+  }
+  adc_init();
+  adc_gpio_init(BATERIA_GPIO);
+  adc_select_input(BATERIA_GPIO - 26);
+
+  /* A primeira conversão após ligar o ADC é descartada */
+  (void)adc_read();
+  uint32_t soma = 0;
+  for (uint i = 0; i < BATERIA_AMOSTRAS; i++) {
+    soma += adc_read();
+  }
+
+  /* Desligando o ADC e parando o clk_adc logo após as conversões */
+  adc_hw->cs &= ~ADC_CS_EN_BITS;
+  clock_stop(clk_adc);
+
+  /* Soma de 12 bits x BATERIA_AMOSTRAS para mV no pino e, pelo divisor, em VSYS (arredondando) */
+  uint64_t denominador = 4096ULL * BATERIA_AMOSTRAS * BATERIA_DIVISOR_DEN;
+  uint64_t tensao = ((uint64_t)soma * BATERIA_VREF_MV * BATERIA_DIVISOR_NUM + denominador / 2) / denominador;
+  if (tensao < BATERIA_MINIMA_MV) {
+    return false;
+  }
+  leitura->tensao_mv = (tensao > UINT16_MAX) ? UINT16_MAX : (uint16_t)tensao;
+  leitura->nivel = nivel_bateria_lorawan(leitura->tensao_mv);
+  return true;
+}
+
+/*****************************END OF FILE**************************************/
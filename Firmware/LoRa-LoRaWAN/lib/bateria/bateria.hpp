@@ -0,0 +1,95 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  bateria.hpp
+ *
+ *    Description:  Tensão da bateria (VSYS) por divisor resistivo em um canal do ADC,
+ *                  com sobreamostragem. O ADC e o clk_adc só ficam ligados durante
+ *                  as conversões, e o resultado é convertido para o nível de
+ *                  bateria do DevStatusAns do LoRaWAN.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 23:59:59
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#ifndef BATERIA_HPP
+#define BATERIA_HPP
+
+#include <Arduino.h>
+
+/****************************************************************************
+**                          CONFIGURAÇÃO DA MEDIÇÃO
+*****************************************************************************/
+
+/* GPIO do divisor (26 a 29, canais 0 a 3 do ADC). Na Pico, VSYS/3 já fica na GPIO 29;
+   na RP2040 Zero o divisor é externo */
+#ifndef BATERIA_GPIO
+#define BATERIA_GPIO                29
+#endif
+
+/* Divisor resistivo: VSYS = tensão no pino x NUM / DEN (200k/100k na Pico) */
+#ifndef BATERIA_DIVISOR_NUM
+#define BATERIA_DIVISOR_NUM         3
+#endif
+#ifndef BATERIA_DIVISOR_DEN
+#define BATERIA_DIVISOR_DEN         1
+#endif
+
+/* Conversões somadas por medição: 16 rendem 2 bits a mais sobre os 12 do ADC e diluem
+   os saltos de DNL do RP2040 (errata E11); a 12 MHz cada conversão leva 8 us */
+#define BATERIA_AMOSTRAS            16
+
+/* Referência do ADC (ADC_VREF ligado ao 3V3) */
+#define BATERIA_VREF_MV             3300
+
+/* Faixa da bateria (Li-ion 1S) mapeada nos níveis 1 a 254 do DevStatusAns. Acima de
+   BATERIA_EXTERNA_MV, VSYS vem do USB (nível 0, alimentação externa) */
+#ifndef BATERIA_VAZIA_MV
+#define BATERIA_VAZIA_MV            3300
+#endif
+#ifndef BATERIA_CHEIA_MV
+#define BATERIA_CHEIA_MV            4200
+#endif
+#define BATERIA_EXTERNA_MV          4500
+
+/* Abaixo disso o RP2040 não estaria rodando (VSYS mínima do regulador): pino sem divisor */
+#define BATERIA_MINIMA_MV           1800
+
+/* Níveis especiais do DevStatusAns (LoRaWAN 1.0.4, seção 5.5) */
+#define BATERIA_NIVEL_EXTERNA       0
+#define BATERIA_NIVEL_DESCONHECIDO  255
+
+/* Última medição */
+typedef struct {
+    uint16_t tensao_mv;         /* VSYS em mV */
+    uint8_t nivel;              /* Nível do DevStatusAns (0 externa, 1 a 254, 255 desconhecido) */
+} LeituraBateria;
+
+/****************************************************************************
+**                            FUNÇÕES AUXILIARES DE USO
+*****************************************************************************/
+
+/**
+ * @brief Mede VSYS: liga o clk_adc a partir do XOSC e o ADC, soma BATERIA_AMOSTRAS
+ *        conversões (a primeira é descartada) e desliga os dois em seguida
+ *
+ * @return false se o clk_adc não pôde ser ligado ou a tensão ficou abaixo de
+ *         BATERIA_MINIMA_MV (divisor ausente);
+ *         nesse caso o nível fica BATERIA_NIVEL_DESCONHECIDO
+*/
+bool mede_bateria(LeituraBateria *leitura);
+
+/**
+ * @brief Nível de bateria do DevStatusAns para uma tensão de VSYS
+*/
+uint8_t nivel_bateria_lorawan(uint16_t tensao_mv);
+
+#endif
+/*****************************END OF FILE**************************************/
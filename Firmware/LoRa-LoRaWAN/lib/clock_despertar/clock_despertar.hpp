@@ -0,0 +1,77 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  clock_despertar.hpp
+ *
+ *    Description:  Perfis de clock da fase acordada. O despertar parte dos clocks do
+ *                  sono (XOSC ou ROSC, PLLs desligados) e sobe só até o necessário
+ *                  para o ciclo, em vez de sempre executar clocks_init().
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 18:12:40
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#ifndef CLOCK_DESPERTAR_HPP
+#define CLOCK_DESPERTAR_HPP
+
+#include <Arduino.h>
+#include "hardware/uart.h"
+#include "hardware/i2c.h"
+#include "hardware/spi.h"
+
+#if defined(CLOCK_GOVERNADOR) && !defined(CLOCK_DESPERTAR_PERFIS)
+#error "CLOCK_GOVERNADOR requer CLOCK_DESPERTAR_PERFIS"
+#endif
+
+/* Frequência de clk_sys no perfil do MAC LoRaWAN: AES/MIC e gravação da sessão */
+#ifndef CLOCK_MAC_MHZ
+#define CLOCK_MAC_MHZ 24
+#endif
+
+/* Frequência de clk_sys no perfil do rádio: SPI do SX1276 (até 10 MHz) e AES do MAC */
+#ifndef CLOCK_RADIO_MHZ
+#define CLOCK_RADIO_MHZ 48
+#endif
+
+/* Espera pela nova tensão do núcleo antes de subir o clock (CLOCK_GOVERNADOR) */
+#ifndef CLOCK_VREG_ASSENTAMENTO_US
+#define CLOCK_VREG_ASSENTAMENTO_US 100
+#endif
+
+/* Perfis em ordem crescente de clock: cada um usa o menor degrau (XOSC, CLOCK_MAC_MHZ,
+   CLOCK_RADIO_MHZ, 125 MHz) a partir do seu que atenda os periféricos informados */
+typedef enum {
+    CLOCK_PERFIL_SENSOR,    /* clk_sys = clk_peri = XOSC (12 MHz), PLLs desligados */
+    CLOCK_PERFIL_MAC,       /* clk_sys = clk_peri = PLL_SYS em CLOCK_MAC_MHZ, PLL_USB desligado */
+    CLOCK_PERFIL_RADIO,     /* clk_sys = clk_peri = PLL_SYS em CLOCK_RADIO_MHZ, PLL_USB desligado */
+    CLOCK_PERFIL_COMPLETO   /* clocks_init(): 125 MHz, USB e ADC em 48 MHz */
+} PerfilClock;
+
+/* Periféricos cujo divisor depende de clk_peri, reajustados a cada troca de perfil
+   (instância NULL = não usado) */
+typedef struct {
+    uart_inst_t *uart;
+    uint32_t uart_baud;
+    i2c_inst_t *i2c;
+    uint32_t i2c_baud;
+    spi_inst_t *spi;
+    uint32_t spi_baud;
+} PerifericosClock;
+
+/* Reconfigura os clocks para o perfil e reajusta os divisores dos periféricos. clk_ref
+   fica sempre no XOSC, mantendo o tick de 1 us do timer. Com CLOCK_GOVERNADOR a tensão
+   do núcleo acompanha o clock: sobe antes dele e desce depois */
+void aplica_perfil_clock(PerfilClock perfil, const PerifericosClock *perifericos);
+
+/* Perfil aplicado por último (CLOCK_PERFIL_COMPLETO após o boot) */
+PerfilClock perfil_clock_atual(void);
+
+#endif
+/*****************************END OF FILE**************************************/
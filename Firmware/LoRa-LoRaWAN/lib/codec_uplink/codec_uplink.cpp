@@ -0,0 +1,339 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  codec_uplink.cpp
+ *
+ *    Description:  -
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 11:05:41
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include "codec_uplink.hpp"
+
+
+/* ============================================================================
+ *  Conversões para ponto fixo
+ * ============================================================================
+*/
+
+/**
+ * @brief Arredonda para o inteiro mais próximo e satura no intervalo [min, max]
+*/
+static int32_t arredonda_satura(float valor, int32_t min, int32_t max) {
+    float arredondado = (valor >= 0.0f) ? valor + 0.5f : valor - 0.5f;
+    if (arredondado <= (float)min) return min;
+    if (arredondado >= (float)max) return max;
+    return (int32_t)arredondado;
+}
+
+static uint16_t temperatura_fixa(float temperatura) {
+    return (uint16_t)(int16_t)arredonda_satura(temperatura * CODEC_ESCALA_TEMPERATURA, INT16_MIN, INT16_MAX);
+}
+
+static uint8_t umidade_fixa(float umidade) {
+    return (uint8_t)arredonda_satura(umidade * CODEC_ESCALA_UMIDADE, 0, 100 * CODEC_ESCALA_UMIDADE);
+}
+
+static void escreve_u16(uint8_t *buf, uint16_t valor) {
+    buf[0] = (uint8_t)(valor >> 8);
+    buf[1] = (uint8_t)(valor & 0xFF);
+}
+
+static uint16_t le_u16(const uint8_t *buf) {
+    return (uint16_t)((buf[0] << 8) | buf[1]);
+}
+
+/* Inteiro com sinal -> sem sinal, com módulos pequenos em valores pequenos (0, -1, 1, -2...) */
+static uint32_t zigzag(int32_t valor) {
+    return (valor >= 0) ? (uint32_t)valor << 1 : ((uint32_t)(-(valor + 1)) << 1) | 1;
+}
+
+static int32_t dezigzag(uint32_t valor) {
+    return (valor & 1) ? -(int32_t)(valor >> 1) - 1 : (int32_t)(valor >> 1);
+}
+
+static size_t tamanho_varint(uint32_t valor) {
+    size_t tam = 1;
+    while (valor >= 0x80) {
+        valor >>= 7;
+        tam++;
+    }
+    return tam;
+}
+
+static size_t escreve_varint(uint8_t *buf, uint32_t valor) {
+    size_t tam = 0;
+    while (valor >= 0x80) {
+        buf[tam++] = (uint8_t)(valor | 0x80);
+        valor >>= 7;
+    }
+    buf[tam++] = (uint8_t)valor;
+    return tam;
+}
+
+/**
+ * @brief Lê um varint de até 3 bytes (21 bits, suficientes para os campos da série)
+ * @return Bytes consumidos (0 se truncado ou longo demais)
+*/
+static size_t le_varint(const uint8_t *buf, size_t tam, uint32_t *valor) {
+    *valor = 0;
+    for (size_t i = 0; i < tam && i < 3; i++) {
+        *valor |= (uint32_t)(buf[i] & 0x7F) << (7 * i);
+        if (!(buf[i] & 0x80)) return i + 1;
+    }
+    return 0;
+}
+
+
+/* ============================================================================
+ *  Codificação e decodificação
+ * ============================================================================
+*/
+
+/**
+ * @brief Codifica a leitura no esquema indicado pela porta.
+ *
+ * Temperatura e umidade são arredondadas para a resolução do esquema e saturadas
+ * nos limites do campo, evitando que uma leitura fora da faixa dê a volta.
+ *
+ * @param porta    fPort / esquema (CODEC_PORTA_TH, CODEC_PORTA_THR ou CODEC_PORTA_THB)
+ * @param leitura  Leitura a ser codificada
+ * @param buf      Buffer de saída
+ * @param tam_buf  Tamanho disponível em buf
+ * @return Quantidade de bytes do payload, ou 0 em caso de erro
+*/
+size_t codifica_leitura(uint8_t porta, const LeituraEstacao *leitura, uint8_t *buf, size_t tam_buf) {
+    size_t tam;
+    switch (porta) {
+        case CODEC_PORTA_TH:  tam = CODEC_TAM_TH;  break;
+        case CODEC_PORTA_THR: tam = CODEC_TAM_THR; break;
+        case CODEC_PORTA_THB: tam = CODEC_TAM_THB; break;
+        default: return 0;
+    }
+    if (tam_buf < tam) return 0;
+
+    escreve_u16(&buf[0], temperatura_fixa(leitura->temperatura));
+    buf[2] = umidade_fixa(leitura->umidade);
+
+    if (porta == CODEC_PORTA_THR) {
+        escreve_u16(&buf[3], leitura->tombos_chuva);
+    } else if (porta == CODEC_PORTA_THB) {
+        escreve_u16(&buf[3], leitura->bateria_mv);
+    }
+    return tam;
+}
+
+/**
+ * @brief Decodifica um payload recebido na porta indicada
+ *
+ * @return false se a porta for desconhecida ou o tamanho não corresponder ao esquema
+*/
+bool decodifica_leitura(uint8_t porta, const uint8_t *buf, size_t tam, LeituraEstacao *leitura) {
+    if (porta == CODEC_PORTA_TH && tam != CODEC_TAM_TH) return false;
+    if (porta == CODEC_PORTA_THR && tam != CODEC_TAM_THR) return false;
+    if (porta == CODEC_PORTA_THB && tam != CODEC_TAM_THB) return false;
+    if (porta != CODEC_PORTA_TH && porta != CODEC_PORTA_THR && porta != CODEC_PORTA_THB) return false;
+
+    leitura->temperatura = (float)(int16_t)le_u16(&buf[0]) / CODEC_ESCALA_TEMPERATURA;
+    leitura->umidade = (float)buf[2] / CODEC_ESCALA_UMIDADE;
+    leitura->tombos_chuva = (porta == CODEC_PORTA_THR) ? le_u16(&buf[3]) : 0;
+    leitura->bateria_mv = (porta == CODEC_PORTA_THB) ? le_u16(&buf[3]) : 0;
+    return true;
+}
+
+/**
+ * @brief Codifica o resumo de N amostras (porta CODEC_PORTA_RESUMO_TH).
+ *
+ * Os campos usam a mesma resolução e saturação da porta CODEC_PORTA_TH.
+*/
+size_t codifica_resumo(const ResumoEstacao *resumo, uint8_t *buf, size_t tam_buf) {
+    if (tam_buf < CODEC_TAM_RESUMO_TH) return 0;
+
+    escreve_u16(&buf[0], temperatura_fixa(resumo->temp_min));
+    escreve_u16(&buf[2], temperatura_fixa(resumo->temp_media));
+    escreve_u16(&buf[4], temperatura_fixa(resumo->temp_max));
+    buf[6] = umidade_fixa(resumo->umid_min);
+    buf[7] = umidade_fixa(resumo->umid_media);
+    buf[8] = umidade_fixa(resumo->umid_max);
+    buf[9] = resumo->amostras;
+    return CODEC_TAM_RESUMO_TH;
+}
+
+bool decodifica_resumo(const uint8_t *buf, size_t tam, ResumoEstacao *resumo) {
+    if (tam != CODEC_TAM_RESUMO_TH) return false;
+
+    resumo->temp_min = (float)(int16_t)le_u16(&buf[0]) / CODEC_ESCALA_TEMPERATURA;
+    resumo->temp_media = (float)(int16_t)le_u16(&buf[2]) / CODEC_ESCALA_TEMPERATURA;
+    resumo->temp_max = (float)(int16_t)le_u16(&buf[4]) / CODEC_ESCALA_TEMPERATURA;
+    resumo->umid_min = (float)buf[6] / CODEC_ESCALA_UMIDADE;
+    resumo->umid_media = (float)buf[7] / CODEC_ESCALA_UMIDADE;
+    resumo->umid_max = (float)buf[8] / CODEC_ESCALA_UMIDADE;
+    resumo->amostras = buf[9];
+    return true;
+}
+
+size_t codec_tamanho_esquema(uint8_t porta) {
+    switch (porta) {
+        case CODEC_PORTA_TH:        return CODEC_TAM_TH;
+        case CODEC_PORTA_THR:       return CODEC_TAM_THR;
+        case CODEC_PORTA_RESUMO_TH: return CODEC_TAM_RESUMO_TH;
+        case CODEC_PORTA_THB:       return CODEC_TAM_THB;
+        default:                    return 0;
+    }
+}
+
+/**
+ * @brief Acrescenta uma leitura atrasada ao lote (porta CODEC_PORTA_LOTE).
+ *
+ * A idade é relativa ao envio: o servidor obtém o horário da leitura subtraindo-a
+ * do horário de recepção, sem depender de o RTC do nó estar acertado.
+ *
+ * @param idade_seg Segundos entre a leitura e o envio (saturada em CODEC_IDADE_MAX_LOTE)
+ * @param porta     Esquema do payload da leitura
+ * @param payload   Leitura codificada no esquema da porta
+ * @param buf       Posição livre do lote
+ * @param tam_buf   Espaço restante no lote
+*/
+size_t codifica_item_lote(uint32_t idade_seg, uint8_t porta, const uint8_t *payload,
+                          uint8_t *buf, size_t tam_buf) {
+    size_t tam = codec_tamanho_esquema(porta);
+    if (tam == 0 || tam_buf < CODEC_TAM_CAB_ITEM_LOTE + tam) return 0;
+
+    if (idade_seg > CODEC_IDADE_MAX_LOTE) idade_seg = CODEC_IDADE_MAX_LOTE;
+    buf[0] = (uint8_t)(idade_seg >> 16);
+    buf[1] = (uint8_t)(idade_seg >> 8);
+    buf[2] = (uint8_t)idade_seg;
+    buf[3] = porta;
+    for (size_t i = 0; i < tam; i++) buf[CODEC_TAM_CAB_ITEM_LOTE + i] = payload[i];
+    return CODEC_TAM_CAB_ITEM_LOTE + tam;
+}
+
+size_t decodifica_item_lote(const uint8_t *buf, size_t tam, uint32_t *idade_seg, uint8_t *porta,
+                            const uint8_t **payload) {
+    if (tam < CODEC_TAM_CAB_ITEM_LOTE) return 0;
+    size_t tam_esquema = codec_tamanho_esquema(buf[3]);
+    if (tam_esquema == 0 || tam < CODEC_TAM_CAB_ITEM_LOTE + tam_esquema) return 0;
+
+    *idade_seg = ((uint32_t)buf[0] << 16) | ((uint32_t)buf[1] << 8) | buf[2];
+    *porta = buf[3];
+    *payload = &buf[CODEC_TAM_CAB_ITEM_LOTE];
+    return CODEC_TAM_CAB_ITEM_LOTE + tam_esquema;
+}
+
+/* ============================================================================
+ *  Série de amostras (delta + varint)
+ * ============================================================================
+*/
+
+void amostra_serie(const LeituraEstacao *leitura, AmostraSerie *amostra) {
+    if (leitura == NULL) {
+        amostra->temperatura = 0;
+        amostra->umidade = CODEC_AMOSTRA_AUSENTE;
+        return;
+    }
+    amostra->temperatura = (int16_t)temperatura_fixa(leitura->temperatura);
+    amostra->umidade = umidade_fixa(leitura->umidade);
+}
+
+/* Códigos da amostra: diferenças em zigzag, com o código 0 da temperatura reservado à ausência */
+static void codigos_amostra(const AmostraSerie *anterior, const AmostraSerie *amostra,
+                            uint32_t *cod_temp, uint32_t *cod_umid) {
+    int32_t temp_ant = anterior ? anterior->temperatura : 0;
+    int32_t umid_ant = anterior ? anterior->umidade : 0;
+    *cod_temp = zigzag(amostra->temperatura - temp_ant) + 1;
+    *cod_umid = zigzag(amostra->umidade - umid_ant);
+}
+
+size_t tamanho_amostra_serie(const AmostraSerie *anterior, const AmostraSerie *amostra) {
+    if (amostra->umidade == CODEC_AMOSTRA_AUSENTE) return 1;
+
+    uint32_t cod_temp, cod_umid;
+    codigos_amostra(anterior, amostra, &cod_temp, &cod_umid);
+    return tamanho_varint(cod_temp) + tamanho_varint(cod_umid);
+}
+
+/**
+ * @brief Codifica a série de amostras (porta CODEC_PORTA_SERIE_TH).
+ *
+ * As amostras são consecutivas, a um intervalo fixo; o horário de cada uma vem do
+ * horário de recepção, do atraso e da posição na série. Uma amostra ausente ocupa
+ * um byte e mantém a contagem do tempo. Com o buffer cheio as amostras restantes
+ * ficam de fora (o atraso do cabeçalho cresce na mesma proporção).
+*/
+size_t codifica_serie(const AmostraSerie *amostras, size_t n, uint32_t intervalo_seg, uint8_t atraso,
+                      uint8_t *buf, size_t tam_buf, size_t *codificadas) {
+    *codificadas = 0;
+    if (tam_buf < CODEC_TAM_CAB_SERIE) return 0;
+    if (n > 0xFF) n = 0xFF;
+    if (intervalo_seg > CODEC_INTERVALO_MAX_SERIE) intervalo_seg = CODEC_INTERVALO_MAX_SERIE;
+
+    size_t tam = CODEC_TAM_CAB_SERIE;
+    const AmostraSerie *anterior = NULL;
+    size_t i;
+    for (i = 0; i < n; i++) {
+        if (tam + tamanho_amostra_serie(anterior, &amostras[i]) > tam_buf) break;
+
+        if (amostras[i].umidade == CODEC_AMOSTRA_AUSENTE) {
+            buf[tam++] = 0;
+            continue;
+        }
+        uint32_t cod_temp, cod_umid;
+        codigos_amostra(anterior, &amostras[i], &cod_temp, &cod_umid);
+        tam += escreve_varint(&buf[tam], cod_temp);
+        tam += escreve_varint(&buf[tam], cod_umid);
+        anterior = &amostras[i];
+    }
+    if (i == 0) return 0;
+
+    uint32_t atraso_total = atraso + (n - i);
+    buf[0] = (uint8_t)i;
+    buf[1] = (uint8_t)(intervalo_seg >> 16);
+    buf[2] = (uint8_t)(intervalo_seg >> 8);
+    buf[3] = (uint8_t)intervalo_seg;
+    buf[4] = (atraso_total > 0xFF) ? 0xFF : (uint8_t)atraso_total;
+    *codificadas = i;
+    return tam;
+}
+
+size_t decodifica_serie(const uint8_t *buf, size_t tam, uint32_t *intervalo_seg, uint8_t *atraso,
+                        AmostraSerie *amostras, size_t max) {
+    if (tam < CODEC_TAM_CAB_SERIE || buf[0] > max) return 0;
+
+    size_t n = buf[0];
+    *intervalo_seg = ((uint32_t)buf[1] << 16) | ((uint32_t)buf[2] << 8) | buf[3];
+    *atraso = buf[4];
+
+    int32_t temp = 0, umid = 0;
+    size_t pos = CODEC_TAM_CAB_SERIE;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t cod_temp, cod_umid;
+        size_t lidos = le_varint(&buf[pos], tam - pos, &cod_temp);
+        if (lidos == 0) return 0;
+        pos += lidos;
+
+        if (cod_temp == 0) {
+            amostras[i].temperatura = 0;
+            amostras[i].umidade = CODEC_AMOSTRA_AUSENTE;
+            continue;
+        }
+        lidos = le_varint(&buf[pos], tam - pos, &cod_umid);
+        if (lidos == 0) return 0;
+        pos += lidos;
+
+        temp += dezigzag(cod_temp - 1);
+        umid += dezigzag(cod_umid);
+        amostras[i].temperatura = (int16_t)temp;
+        amostras[i].umidade = (uint8_t)umid;
+    }
+    return (pos == tam) ? n : 0;
+}
+
+/*****************************END OF FILE**************************************/
@@ -0,0 +1,186 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  codec_uplink.hpp
+ *
+ *    Description:  Codificação binária em ponto fixo do payload de uplink. O fPort
+ *                  identifica o esquema (versão) do payload.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 11:02:18
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#ifndef CODEC_UPLINK_HPP
+#define CODEC_UPLINK_HPP
+
+/* Sem dependência do Arduino: a biblioteca também é compilada no host (decodificador) */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/****************************************************************************
+**                  ESQUEMAS DE PAYLOAD (fPort = versão)
+*****************************************************************************/
+
+/*
+ * Porta 1 - temperatura + umidade (3 bytes)
+ *   [0..1] temperatura, int16 big-endian, 0,01 °C
+ *   [2]    umidade, uint8, 0,5 %UR
+ *
+ * Porta 2 - temperatura + umidade + chuva (5 bytes)
+ *   [0..2] idêntico à porta 1
+ *   [3..4] tombos do pluviômetro no intervalo, uint16 big-endian
+ *
+ * Porta 3 - resumo de N amostras de temperatura e umidade (10 bytes)
+ *   [0..5] temperatura mínima, média e máxima, int16 big-endian, 0,01 °C
+ *   [6..8] umidade mínima, média e máxima, uint8, 0,5 %UR
+ *   [9]    quantidade de amostras do resumo
+ *
+ * Porta 4 - lote de leituras atrasadas (store-and-forward), itens concatenados
+ *   [0..2] idade da leitura no envio, uint24 big-endian, segundos (saturada)
+ *   [3]    porta do esquema da leitura (1, 2, 3 ou 6)
+ *   [4..]  payload da leitura, com o tamanho do esquema
+ *
+ * Porta 5 - série de N amostras consecutivas de temperatura e umidade (delta + varint)
+ *   [0]    amostras na série (inclui as ausentes)
+ *   [1..3] intervalo entre amostras, uint24 big-endian, segundos
+ *   [4]    atraso: intervalos entre a última amostra e o envio
+ *   [5..]  por amostra, diferenças para a amostra presente anterior (a primeira, para zero)
+ *          nas resoluções da porta 1, em varint (7 bits por byte, LSB primeiro):
+ *          zigzag(Δtemperatura) + 1, onde 0 indica amostra ausente (sem o campo seguinte),
+ *          e zigzag(Δumidade)
+ *
+ * Porta 6 - temperatura + umidade + bateria (5 bytes)
+ *   [0..2] idêntico à porta 1
+ *   [3..4] tensão da bateria (VSYS), uint16 big-endian, mV
+*/
+#define CODEC_PORTA_TH                1
+#define CODEC_PORTA_THR               2
+#define CODEC_PORTA_RESUMO_TH         3
+#define CODEC_PORTA_LOTE              4
+#define CODEC_PORTA_SERIE_TH          5
+#define CODEC_PORTA_THB               6
+
+#define CODEC_TAM_TH                  3
+#define CODEC_TAM_THR                 5
+#define CODEC_TAM_RESUMO_TH           10
+#define CODEC_TAM_THB                 5
+#define CODEC_TAM_CAB_ITEM_LOTE       4
+#define CODEC_IDADE_MAX_LOTE          0xFFFFFFUL
+#define CODEC_TAM_CAB_SERIE           5
+#define CODEC_TAM_MAX_AMOSTRA_SERIE   5     /* Pior caso: 3 bytes de temperatura + 2 de umidade */
+#define CODEC_INTERVALO_MAX_SERIE     0xFFFFFFUL
+
+/* Resolução dos campos em ponto fixo */
+#define CODEC_ESCALA_TEMPERATURA      100   /* 0,01 °C */
+#define CODEC_ESCALA_UMIDADE          2     /* 0,5 %UR */
+
+/* Leitura da estação em unidades de engenharia */
+typedef struct {
+    float temperatura;      /* Temperatura em graus Celsius */
+    float umidade;          /* Umidade relativa em porcentagem */
+    uint16_t tombos_chuva;  /* Tombos da báscula do pluviômetro no intervalo */
+    uint16_t bateria_mv;    /* Tensão da bateria em mV */
+} LeituraEstacao;
+
+/* Resumo (mínimo, média e máximo) de várias amostras entre envios */
+typedef struct {
+    float temp_min, temp_media, temp_max;   /* Temperatura em graus Celsius */
+    float umid_min, umid_media, umid_max;   /* Umidade relativa em porcentagem */
+    uint8_t amostras;                       /* Amostras consideradas no resumo */
+} ResumoEstacao;
+
+
+/* Amostra da série em ponto fixo (resolução da porta 1) */
+typedef struct {
+    int16_t temperatura;                    /* 0,01 °C */
+    uint8_t umidade;                        /* 0,5 %UR; CODEC_AMOSTRA_AUSENTE = sem leitura */
+} AmostraSerie;
+
+#define CODEC_AMOSTRA_AUSENTE         0xFF
+
+
+/****************************************************************************
+**                            FUNÇÕES AUXILIARES DE USO
+*****************************************************************************/
+
+/**
+ * @brief Codifica a leitura no esquema indicado pela porta
+ * @return Quantidade de bytes escritos em buf (0 se porta desconhecida ou buffer pequeno)
+*/
+size_t codifica_leitura(uint8_t porta, const LeituraEstacao *leitura, uint8_t *buf, size_t tam_buf);
+
+/**
+ * @brief Decodifica um payload recebido na porta indicada
+ * @return true se o tamanho corresponde ao esquema da porta
+*/
+bool decodifica_leitura(uint8_t porta, const uint8_t *buf, size_t tam, LeituraEstacao *leitura);
+
+/**
+ * @brief Codifica o resumo de amostras no esquema da porta CODEC_PORTA_RESUMO_TH
+ * @return Quantidade de bytes escritos em buf (0 se o buffer for pequeno)
+*/
+size_t codifica_resumo(const ResumoEstacao *resumo, uint8_t *buf, size_t tam_buf);
+
+/**
+ * @brief Decodifica um payload recebido na porta CODEC_PORTA_RESUMO_TH
+ * @return true se o tamanho corresponde ao esquema
+*/
+bool decodifica_resumo(const uint8_t *buf, size_t tam, ResumoEstacao *resumo);
+
+/**
+ * @brief Tamanho do payload de uma leitura no esquema da porta (0 se desconhecida)
+*/
+size_t codec_tamanho_esquema(uint8_t porta);
+
+/**
+ * @brief Acrescenta ao lote uma leitura já codificada no esquema da porta
+ * @return Quantidade de bytes escritos em buf (0 se porta desconhecida ou sem espaço)
+*/
+size_t codifica_item_lote(uint32_t idade_seg, uint8_t porta, const uint8_t *payload,
+                          uint8_t *buf, size_t tam_buf);
+
+/**
+ * @brief Lê o item do lote no início de buf
+ * @return Quantidade de bytes do item (0 se truncado ou porta desconhecida)
+*/
+size_t decodifica_item_lote(const uint8_t *buf, size_t tam, uint32_t *idade_seg, uint8_t *porta,
+                            const uint8_t **payload);
+
+/**
+ * @brief Converte a leitura para a amostra da série (NULL = amostra ausente)
+*/
+void amostra_serie(const LeituraEstacao *leitura, AmostraSerie *amostra);
+
+/**
+ * @brief Bytes que a amostra ocupa na série, dada a amostra presente anterior
+ *        (NULL para a primeira)
+*/
+size_t tamanho_amostra_serie(const AmostraSerie *anterior, const AmostraSerie *amostra);
+
+/**
+ * @brief Codifica na porta CODEC_PORTA_SERIE_TH as amostras mais antigas que couberem em buf
+ *
+ * @param atraso      Intervalos entre a última amostra do vetor e o envio
+ * @param codificadas Amostras incluídas, a partir da primeira do vetor
+ * @return Quantidade de bytes do payload (0 se nenhuma amostra couber)
+*/
+size_t codifica_serie(const AmostraSerie *amostras, size_t n, uint32_t intervalo_seg, uint8_t atraso,
+                      uint8_t *buf, size_t tam_buf, size_t *codificadas);
+
+/**
+ * @brief Decodifica um payload recebido na porta CODEC_PORTA_SERIE_TH
+ * @return Quantidade de amostras (0 se o payload for inválido ou não couber em max)
+*/
+size_t decodifica_serie(const uint8_t *buf, size_t tam, uint32_t *intervalo_seg, uint8_t *atraso,
+                        AmostraSerie *amostras, size_t max);
+
+#endif
+/*****************************END OF FILE**************************************/
@@ -20,6 +20,7 @@
 #define DS3231_HPP
 #include <Arduino.h>
 #include "hardware/i2c.h"
+#include "../barramento_i2c/barramento_i2c.hpp"
 
 /****************************************************************************
 **                MACRO REGISTER ADDRESS CONFIG DS3231
@@ -28,6 +29,9 @@
 /* Slave Addr DS3231 */
 const uint8_t DS3231_I2C_ADDR = 0x68;
 
+/* Maior SCL aceito pelo DS3231 (Fast-mode) */
+#define DS3231_I2C_BAUD               (400 * 1000)
+
 /* Timekeeping Registers (0x00–0x06) */
 #define DS3231_REG_SECONDS            0x00  // Segundos (BCD)
 #define DS3231_REG_MINUTES            0x01  // Minutos (BCD)
@@ -57,6 +61,9 @@ const uint8_t DS3231_I2C_ADDR = 0x68;
 #define DS3231_REG_TEMP_MSB           0x11  // Parte inteira da temperatura (signed)
 #define DS3231_REG_TEMP_LSB           0x12  // Parte fracionária da temperatura (bits 7:6)
 
+/* Quantidade de registradores (0x00–0x12); o ponteiro interno volta a 0x00 após o último */
+#define DS3231_NUM_REGS               0x13
+
 /****************************************************************************
 **                BIT MASKS FOR CONTROL AND STATUS REGISTERS
 *****************************************************************************/
@@ -89,13 +96,29 @@ typedef struct {
     uint8_t horas;
 } HoraRTC;
 
+/*
+ * Grade absoluta de despertares: os alarmes caem em fase_seg + k * periodo_min,
+ * contados a partir de 00:00 do RTC. Como o período divide o dia, os horários se
+ * repetem de forma idêntica a cada 24 h e não há deriva entre ciclos.
+*/
+typedef struct {
+    uint16_t periodo_min;   /* Divisor de 1440 (ex.: 5, 10, 15, 60; 1440 = diário) */
+    uint32_t fase_seg;      /* Deslocamento dentro do período (escalonamento entre nós ou hora do envio diário) */
+} GradeAlarme;
+
+#define DS3231_MINUTOS_POR_DIA        1440
+#define DS3231_SEGUNDOS_POR_DIA       86400UL
+
+/* Antecedência mínima do próximo horário da grade em relação à hora lida */
+#define DS3231_MARGEM_GRADE_SEG       2
+
 
 /****************************************************************************
 **                            FUNÇÕES AUXILIARES DE USO
 *****************************************************************************/
 
 /**
- * @brief Inicializa o DS3231 com pinos I2C e frequência de 400kHz
+ * @brief Inicializa o DS3231 no barramento I2C compartilhado (pinos configurados uma vez)
 */
 void inicializa_ds3231(DS3231 *mod_rtc, i2c_inst_t *i2c, uint8_t endereco, uint sda_pin, uint scl_pin);
 
@@ -109,6 +132,16 @@ bool ds3231_read_reg(i2c_inst_t *i2c, uint8_t reg_addr, uint8_t *dest);
  */
 bool ds3231_write_reg(i2c_inst_t *i2c, uint8_t reg_addr, uint8_t value);
 
+/**
+ * @brief Lê n registradores consecutivos em uma única transação I2C
+*/
+bool ds3231_read_regs(i2c_inst_t *i2c, uint8_t reg_inicial, uint8_t *dest, size_t n);
+
+/**
+ * @brief Escreve n registradores consecutivos em uma única transação I2C
+*/
+bool ds3231_write_regs(i2c_inst_t *i2c, uint8_t reg_inicial, const uint8_t *src, size_t n);
+
 
 /**
  * @brief Converte de decimal para BCD
@@ -125,6 +158,11 @@ uint8_t bcd_to_decimal(uint8_t val);
 */
 bool hora_atual_rtc(i2c_inst_t *i2c, HoraRTC *hora);
 
+/**
+ * @brief Retorna data e hora do RTC em segundos desde 01/01/2000 00:00
+*/
+bool segundos_rtc(i2c_inst_t *i2c, uint32_t *segundos);
+
 /**
  * @brief Configura o alarme para um horário exato (minuto e segundo)
 */
@@ -135,5 +173,30 @@ bool alarme_para_horario(i2c_inst_t *i2c, uint8_t min, uint8_t seg);
 */
 bool agenda_alarme_em(i2c_inst_t *i2c, uint8_t offset_min, uint8_t offset_seg);
 
+/**
+ * @brief Se o alarme 1 disparou, limpa a flag A1F e agenda o próximo (máximo de 2 transações I2C)
+*/
+bool reagenda_alarme_disparado(i2c_inst_t *i2c, uint8_t offset_min, uint8_t offset_seg);
+
+/**
+ * @brief Verifica se o período divide o dia e se a fase cabe em um período
+*/
+bool grade_alarme_valida(const GradeAlarme *grade);
+
+/**
+ * @brief Próximo horário da grade (segundos desde 00:00) após agora_seg + DS3231_MARGEM_GRADE_SEG
+*/
+uint32_t proximo_horario_grade(const GradeAlarme *grade, uint32_t agora_seg);
+
+/**
+ * @brief Agenda o próximo despertar da grade absoluta (horas, minutos e segundos comparados)
+*/
+bool agenda_alarme_grade(i2c_inst_t *i2c, const GradeAlarme *grade);
+
+/**
+ * @brief Se o alarme habilitado disparou, limpa as flags e agenda o próximo horário da grade
+*/
+bool reagenda_grade_disparada(i2c_inst_t *i2c, const GradeAlarme *grade);
+
 /*****************************END OF FILE**************************************/
 #endif
@@ -0,0 +1,97 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  orcamento_airtime.cpp
+ *
+ *    Description:  -
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 22:11:04
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include "orcamento_airtime.hpp"
+
+
+/* ============================================================================
+ *  Gerenciamento do orçamento
+ * ============================================================================
+*/
+
+void inicializa_orcamento_airtime(OrcamentoAirtime *orcamento, uint32_t ms_por_hora, uint32_t agora_seg) {
+    orcamento->ms_por_hora = ms_por_hora;
+    orcamento->credito_ms = (int32_t)ms_por_hora;
+    orcamento->resto = 0;
+    orcamento->atualizado_seg = agora_seg;
+    orcamento->toa_estimado_ms = 0;
+    orcamento->airtime_total_ms = 0;
+    orcamento->uplinks = 0;
+    orcamento->adiados = 0;
+}
+
+/**
+ * @brief Credita o orçamento pelo tempo decorrido no RTC.
+ *
+ * O crédito é calculado em segundos inteiros do RTC, e não pelo millis(): o
+ * temporizador do MCU fica parado durante o sono. Um RTC que volta no tempo
+ * (acerto do relógio) apenas reinicia a referência, sem creditar nada.
+*/
+void atualiza_orcamento_airtime(OrcamentoAirtime *orcamento, uint32_t agora_seg) {
+    if (agora_seg < orcamento->atualizado_seg) {
+        orcamento->atualizado_seg = agora_seg;
+        return;
+    }
+
+    /* Limitando o intervalo a uma hora: além dela o balde já estaria cheio */
+    uint32_t decorrido = agora_seg - orcamento->atualizado_seg;
+    if (decorrido > ORCAMENTO_SEGUNDOS_HORA) decorrido = ORCAMENTO_SEGUNDOS_HORA;
+    orcamento->atualizado_seg = agora_seg;
+
+    /* A fração de milissegundo que sobra da divisão fica para a próxima atualização */
+    uint64_t numerador = (uint64_t)decorrido * orcamento->ms_por_hora + orcamento->resto;
+    int64_t total = orcamento->credito_ms + (int64_t)(numerador / ORCAMENTO_SEGUNDOS_HORA);
+    orcamento->resto = (uint32_t)(numerador % ORCAMENTO_SEGUNDOS_HORA);
+
+    if (total >= (int64_t)orcamento->ms_por_hora) {
+        orcamento->credito_ms = (int32_t)orcamento->ms_por_hora;
+        orcamento->resto = 0;
+    } else {
+        orcamento->credito_ms = (int32_t)total;
+    }
+}
+
+uint32_t falta_orcamento_airtime(const OrcamentoAirtime *orcamento) {
+    int32_t falta = (int32_t)orcamento->toa_estimado_ms - orcamento->credito_ms;
+    return (falta > 0) ? (uint32_t)falta : 0;
+}
+
+/**
+ * @brief Tempo até o crédito cobrir o que falta, na mesma taxa de atualiza_orcamento_airtime().
+ *
+ * Cada segundo credita ms_por_hora/3600 ms: faltam falta * 3600 frações (já descontado o
+ * resto acumulado), arredondadas para cima em segundos inteiros.
+*/
+uint32_t espera_orcamento_airtime(const OrcamentoAirtime *orcamento) {
+    uint32_t falta_ms = falta_orcamento_airtime(orcamento);
+    if (falta_ms == 0) return 0;
+    if (orcamento->ms_por_hora == 0) return UINT32_MAX;
+
+    uint64_t numerador = (uint64_t)falta_ms * ORCAMENTO_SEGUNDOS_HORA - orcamento->resto;
+    uint64_t espera = (numerador + orcamento->ms_por_hora - 1) / orcamento->ms_por_hora;
+    return (espera > UINT32_MAX) ? UINT32_MAX : (uint32_t)espera;
+}
+
+void desconta_orcamento_airtime(OrcamentoAirtime *orcamento, uint32_t toa_ms) {
+    orcamento->credito_ms -= (int32_t)toa_ms;
+    orcamento->toa_estimado_ms = toa_ms;
+    orcamento->airtime_total_ms += toa_ms;
+    orcamento->uplinks++;
+}
+
+/*****************************END OF FILE**************************************/
@@ -0,0 +1,84 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  orcamento_airtime.hpp
+ *
+ *    Description:  Orçamento de tempo no ar (airtime) por hora, contado no relógio
+ *                  do RTC: decide se o próximo uplink cabe no orçamento e quanto
+ *                  falta quando não cabe.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 22:08:36
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#ifndef ORCAMENTO_AIRTIME_HPP
+#define ORCAMENTO_AIRTIME_HPP
+
+/* Sem dependência do Arduino: a lógica também é compilada no host */
+#include <stdint.h>
+#include <stdbool.h>
+
+/****************************************************************************
+**                          CONFIGURAÇÃO DO ORÇAMENTO
+*****************************************************************************/
+
+/* Segundos em uma hora (período do orçamento) */
+#define ORCAMENTO_SEGUNDOS_HORA       3600UL
+
+/*
+ * Balde de crédito: o crédito cresce ms_por_hora a cada hora do RTC, até uma hora de
+ * orçamento acumulada, e cada uplink desconta o seu tempo no ar. A média em qualquer
+ * janela longa fica dentro do orçamento, com rajadas limitadas a uma hora dele.
+*/
+typedef struct {
+    uint32_t ms_por_hora;                 /* Orçamento de tempo no ar por hora (ms) */
+    int32_t  credito_ms;                  /* Crédito disponível (negativo = uplink maior que o estimado) */
+    uint32_t resto;                       /* Fração de ms ainda não creditada (em ms/3600) */
+    uint32_t atualizado_seg;              /* Horário do RTC da última atualização do crédito */
+    uint32_t toa_estimado_ms;             /* Tempo no ar do último uplink (estimativa do próximo) */
+    uint32_t airtime_total_ms;            /* Tempo no ar acumulado desde o boot */
+    uint32_t uplinks;                     /* Uplinks descontados desde o boot */
+    uint32_t adiados;                     /* Envios adiados por falta de crédito */
+} OrcamentoAirtime;
+
+/****************************************************************************
+**                            FUNÇÕES AUXILIARES DE USO
+*****************************************************************************/
+
+/**
+ * @brief Inicia o orçamento com o crédito de uma hora
+ *
+ * @param ms_por_hora Tempo no ar permitido por hora (ms)
+ * @param agora_seg   Horário do RTC (segundos_rtc)
+*/
+void inicializa_orcamento_airtime(OrcamentoAirtime *orcamento, uint32_t ms_por_hora, uint32_t agora_seg);
+
+/**
+ * @brief Credita o orçamento pelo tempo decorrido no RTC desde a última atualização
+*/
+void atualiza_orcamento_airtime(OrcamentoAirtime *orcamento, uint32_t agora_seg);
+
+/**
+ * @brief Crédito que falta para o próximo uplink (toa_estimado_ms); 0 se ele cabe no orçamento
+*/
+uint32_t falta_orcamento_airtime(const OrcamentoAirtime *orcamento);
+
+/**
+ * @brief Segundos do RTC até o crédito cobrir o próximo uplink; 0 se ele já cabe no orçamento
+*/
+uint32_t espera_orcamento_airtime(const OrcamentoAirtime *orcamento);
+
+/**
+ * @brief Desconta do crédito o tempo no ar de um uplink e o guarda como estimativa do próximo
+*/
+void desconta_orcamento_airtime(OrcamentoAirtime *orcamento, uint32_t toa_ms);
+
+#endif
+/*****************************END OF FILE**************************************/
@@ -68,6 +68,57 @@ uint rosc_find_freq(uint32_t low_mhz, uint32_t high_mhz);
 
 void rosc_set_div(uint32_t div);
 
+/*! \brief Number of drive strength levels searched by rosc_calibrate()
+ *  \ingroup hardware_rosc
+ *
+ * Each of the 8 delay stages takes 0 to 3 drive strength bits (thermometer coded), so levels go from 0 to 24.
+ */
+#define ROSC_DRIVE_LEVELS 25u
+
+/*! \brief  Delay stage code for a given drive strength level
+ *  \ingroup hardware_rosc
+ *
+ * The bits are spread evenly across the stages, so the frequency rises with the level.
+ *
+ * \param level 0 to ROSC_DRIVE_LEVELS - 1
+ */
+uint32_t rosc_code_for_level(uint level);
+
+/*! \brief  Calibrate the Ring Oscillator against clk_ref
+ *  \ingroup hardware_rosc
+ *
+ * Binary search over the drive strength level for the fastest setting not above target_khz, using at most
+ * 6 frequency counts. The divider is set to 1 and the range is left as it is. The chosen code and its
+ * measured frequency are kept in RAM (retained while sleeping or dormant) for rosc_restore_calibration()
+ * and for sleep_run_from_rosc().
+ *
+ * clk_ref must be running from the XOSC: the ROSC can't be measured against itself.
+ *
+ * \param target_khz Upper bound for the ROSC frequency
+ * \return Measured frequency of the chosen setting, in kHz
+ */
+uint32_t rosc_calibrate(uint32_t target_khz);
+
+/*! \brief  Reapply the cached calibration, checking it with a single frequency count
+ *  \ingroup hardware_rosc
+ *
+ * Falls back to rosc_calibrate() when there is no calibration for target_khz yet or the ROSC has
+ * drifted (voltage, temperature) more than tolerance_khz from the cached frequency.
+ *
+ * \return Measured frequency, in kHz
+ */
+uint32_t rosc_restore_calibration(uint32_t target_khz, uint32_t tolerance_khz);
+
+/*! \brief  Delay stage code chosen by the last calibration (0 if never calibrated)
+ *  \ingroup hardware_rosc
+ */
+uint32_t rosc_calibrated_code(void);
+
+/*! \brief  Measured ROSC frequency of the last calibration, in kHz (0 if never calibrated)
+ *  \ingroup hardware_rosc
+ */
+uint32_t rosc_calibrated_khz(void);
+
 inline static void rosc_clear_bad_write(void) {
     hw_clear_bits(&rosc_hw->status, ROSC_STATUS_BADWRITE_BITS);
 }
@@ -0,0 +1,399 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  registro_leituras.cpp
+ *
+ *    Description:  -
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 20:34:52
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include "registro_leituras.hpp"
+#include <stddef.h>
+#include <string.h>
+
+#if defined(ARDUINO_ARCH_RP2040)
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "../sessao_lorawan/sessao_lorawan.hpp"
+#endif
+
+/* Buffer de trabalho: cada registro é programado com a sua página inteira */
+static uint8_t pagina_buf[REGISTRO_TAMANHO_PAGINA];
+
+
+/* ============================================================================
+ *  Funções internas
+ * ============================================================================
+*/
+
+/**
+ * @brief Calcula o CRC-16/CCITT (polinômio 0x1021, valor inicial 0xFFFF)
+*/
+static uint16_t crc16_ccitt(const uint8_t *dados, size_t n, uint16_t crc) {
+    for (size_t i = 0; i < n; i++) {
+        crc ^= (uint16_t)dados[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint16_t crc_registro(const RegistroFlash *reg) {
+    return crc16_ccitt((const uint8_t *)reg, offsetof(RegistroFlash, crc), 0xFFFF);
+}
+
+static uint32_t avanca(const RegistroLeituras *registro, uint32_t pos) {
+    return (pos + 1) % registro->capacidade;
+}
+
+static bool le_registro(const RegistroLeituras *registro, uint32_t pos, RegistroFlash *reg) {
+    return registro->meio->le(pos * REGISTRO_TAMANHO, (uint8_t *)reg, sizeof(*reg));
+}
+
+static bool registro_valido(const RegistroFlash *reg) {
+    if (reg->sequencia == 0xFFFFFFFFUL) return false;
+    if (reg->tipo != REGISTRO_TIPO_LEITURA && reg->tipo != REGISTRO_TIPO_CONFIRMACAO) return false;
+    if (reg->tam > REGISTRO_TAM_DADOS) return false;
+    return crc_registro(reg) == reg->crc;
+}
+
+static bool leitura_pendente(const RegistroLeituras *registro, const RegistroFlash *reg) {
+    return registro_valido(reg) && reg->tipo == REGISTRO_TIPO_LEITURA && reg->sequencia > registro->confirmada;
+}
+
+static bool posicao_em_branco(const RegistroFlash *reg) {
+    const uint8_t *bytes = (const uint8_t *)reg;
+    for (size_t i = 0; i < sizeof(*reg); i++) {
+        if (bytes[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Apaga o setor que começa em pos, contabilizando as pendentes perdidas.
+ *
+ * Com o registro cheio o setor seguinte à cabeça guarda as leituras mais antigas:
+ * elas são descartadas e a pendente mais antiga passa para o setor seguinte.
+*/
+static bool prepara_setor(RegistroLeituras *registro, uint32_t pos) {
+    bool continha_pendente = false;
+    for (uint32_t i = 0; i < REGISTRO_POR_SETOR && registro->pendentes; i++) {
+        RegistroFlash reg;
+        if (le_registro(registro, pos + i, &reg) && leitura_pendente(registro, &reg)) {
+            registro->pendentes--;
+            registro->descartadas++;
+            continha_pendente = true;
+        }
+    }
+    if (continha_pendente) {
+        registro->pendente = (pos + REGISTRO_POR_SETOR) % registro->capacidade;
+    }
+
+    if (!registro->meio->apaga_setor(pos * REGISTRO_TAMANHO)) return false;
+    registro->apagamentos++;
+    return true;
+}
+
+/**
+ * @brief Grava o registro na cabeça, atribuindo a próxima sequência.
+ *
+ * Posições com resíduo de uma gravação interrompida são puladas; ao entrar em um
+ * setor ele é apagado. O laço é limitado a um setor, já que a entrada no setor
+ * seguinte sempre oferece uma posição apagada.
+ *
+ * @param pos_gravada Posição em que o registro ficou
+ * @return true se o registro foi gravado e conferido
+*/
+static bool grava_registro(RegistroLeituras *registro, RegistroFlash *reg, uint32_t *pos_gravada) {
+    for (uint32_t tentativa = 0; tentativa <= REGISTRO_POR_SETOR; tentativa++) {
+        uint32_t pos = registro->cabeca;
+        RegistroFlash atual;
+
+        if (pos % REGISTRO_POR_SETOR == 0) {
+            if (!prepara_setor(registro, pos)) return false;
+        } else if (!le_registro(registro, pos, &atual) || !posicao_em_branco(&atual)) {
+            registro->cabeca = avanca(registro, pos);
+            continue;
+        }
+
+        reg->sequencia = registro->sequencia + 1;
+        reg->crc = crc_registro(reg);
+
+        /* Programando a página inteira: os bytes 0xFF não alteram os registros vizinhos */
+        uint32_t offset = pos * REGISTRO_TAMANHO;
+        uint32_t pagina = offset - (offset % REGISTRO_TAMANHO_PAGINA);
+        memset(pagina_buf, 0xFF, sizeof(pagina_buf));
+        memcpy(&pagina_buf[offset - pagina], reg, sizeof(*reg));
+        if (!registro->meio->programa(pagina, pagina_buf, sizeof(pagina_buf))) return false;
+
+        registro->cabeca = avanca(registro, pos);
+
+        /* Conferindo a gravação; uma posição defeituosa é abandonada */
+        if (!le_registro(registro, pos, &atual) || memcmp(&atual, reg, sizeof(atual)) != 0) continue;
+
+        registro->sequencia = reg->sequencia;
+        *pos_gravada = pos;
+        return true;
+    }
+    return false;
+}
+
+
+/* ============================================================================
+ *  Gerenciamento do registro
+ * ============================================================================
+*/
+
+/**
+ * @brief Varre a região e reconstrói o estado do registro.
+ *
+ * A cabeça fica após o registro de maior sequência; a confirmação vale pela maior
+ * sequência confirmada encontrada. São pendentes as leituras acima dela. Executada
+ * apenas no boot: durante o sono o estado permanece na RAM.
+*/
+void inicializa_registro_leituras(RegistroLeituras *registro, const ArmazenamentoRegistro *meio) {
+    memset(registro, 0, sizeof(*registro));
+    registro->meio = meio;
+    registro->capacidade = meio->tamanho() / REGISTRO_TAMANHO;
+
+    uint32_t pos_recente = 0;
+    for (uint32_t pos = 0; pos < registro->capacidade; pos++) {
+        RegistroFlash reg;
+        if (!le_registro(registro, pos, &reg) || !registro_valido(&reg)) continue;
+
+        if (reg.sequencia > registro->sequencia) {
+            registro->sequencia = reg.sequencia;
+            pos_recente = pos;
+        }
+        if (reg.tipo == REGISTRO_TIPO_CONFIRMACAO && reg.valor > registro->confirmada) {
+            registro->confirmada = reg.valor;
+        }
+    }
+    if (registro->sequencia != 0) {
+        registro->cabeca = avanca(registro, pos_recente);
+    }
+
+    /* Localizando a leitura pendente mais antiga */
+    uint32_t seq_antiga = 0xFFFFFFFFUL;
+    registro->pendente = registro->cabeca;
+    for (uint32_t pos = 0; pos < registro->capacidade; pos++) {
+        RegistroFlash reg;
+        if (!le_registro(registro, pos, &reg) || !leitura_pendente(registro, &reg)) continue;
+
+        registro->pendentes++;
+        if (reg.sequencia < seq_antiga) {
+            seq_antiga = reg.sequencia;
+            registro->pendente = pos;
+        }
+    }
+}
+
+/**
+ * @brief Acrescenta uma leitura codificada ao registro.
+ *
+ * @param segundos Carimbo do RTC da leitura (segundos_rtc)
+ * @param porta    Esquema do payload (fPort)
+ * @param dados    Payload codificado
+ * @param tam      Tamanho do payload (até REGISTRO_TAM_DADOS)
+ * @return true se a leitura foi gravada e conferida
+*/
+bool registra_leitura(RegistroLeituras *registro, uint32_t segundos, uint8_t porta,
+                      const uint8_t *dados, size_t tam) {
+    if (tam > REGISTRO_TAM_DADOS) return false;
+
+    RegistroFlash reg;
+    memset(&reg, 0xFF, sizeof(reg));
+    reg.valor = segundos;
+    reg.tipo = REGISTRO_TIPO_LEITURA;
+    reg.porta = porta;
+    reg.tam = (uint8_t)tam;
+    memcpy(reg.dados, dados, tam);
+
+    uint32_t pos;
+    if (!grava_registro(registro, &reg, &pos)) return false;
+
+    if (registro->pendentes == 0) registro->pendente = pos;
+    registro->pendentes++;
+    return true;
+}
+
+uint32_t cursor_pendentes(const RegistroLeituras *registro) {
+    return registro->pendentes ? registro->pendente : registro->cabeca;
+}
+
+/**
+ * @brief Próxima leitura pendente a partir do cursor (confirmações e leituras já
+ *        entregues são puladas)
+*/
+bool proxima_pendente(const RegistroLeituras *registro, uint32_t *cursor, LeituraRegistrada *leitura) {
+    while (*cursor != registro->cabeca) {
+        uint32_t pos = *cursor;
+        *cursor = avanca(registro, pos);
+
+        RegistroFlash reg;
+        if (!le_registro(registro, pos, &reg) || !leitura_pendente(registro, &reg)) continue;
+
+        leitura->sequencia = reg.sequencia;
+        leitura->segundos = reg.valor;
+        leitura->porta = reg.porta;
+        leitura->tam = reg.tam;
+        memcpy(leitura->dados, reg.dados, reg.tam);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Grava a confirmação das leituras até a sequência indicada.
+ *
+ * A confirmação é um registro a mais no fim do registro (nada é regravado), e a
+ * pendente mais antiga avança para a primeira leitura acima da sequência.
+*/
+bool confirma_leituras(RegistroLeituras *registro, uint32_t sequencia) {
+    if (sequencia <= registro->confirmada) return true;
+
+    RegistroFlash reg;
+    memset(&reg, 0xFF, sizeof(reg));
+    reg.valor = sequencia;
+    reg.tipo = REGISTRO_TIPO_CONFIRMACAO;
+    reg.tam = 0;
+
+    uint32_t pos;
+    if (!grava_registro(registro, &reg, &pos)) return false;
+
+    /* Descontando as leituras entregues, ainda com a confirmação anterior */
+    uint32_t cursor = cursor_pendentes(registro);
+    LeituraRegistrada leitura;
+    while (registro->pendentes && proxima_pendente(registro, &cursor, &leitura)) {
+        if (leitura.sequencia > sequencia) {
+            registro->pendente = (cursor + registro->capacidade - 1) % registro->capacidade;
+            break;
+        }
+        registro->pendentes--;
+    }
+    registro->confirmada = sequencia;
+    if (registro->pendentes == 0) registro->pendente = registro->cabeca;
+    return true;
+}
+
+
+/* ============================================================================
+ *  Meio de armazenamento em RAM
+ * ============================================================================
+*/
+
+#define REGISTRO_TAMANHO_RAM  (REGISTRO_SETORES_RAM * REGISTRO_TAMANHO_SETOR)
+
+/* Região simulada, inicializada como flash apagada no primeiro acesso */
+static uint8_t ram_regiao[REGISTRO_TAMANHO_RAM];
+static bool ram_inicializada = false;
+
+static void ram_prepara(void) {
+    if (!ram_inicializada) {
+        memset(ram_regiao, 0xFF, sizeof(ram_regiao));
+        ram_inicializada = true;
+    }
+}
+
+static bool ram_le(uint32_t offset, uint8_t *dest, size_t n) {
+    if (offset + n > REGISTRO_TAMANHO_RAM) return false;
+    ram_prepara();
+    memcpy(dest, &ram_regiao[offset], n);
+    return true;
+}
+
+static bool ram_apaga_setor(uint32_t offset) {
+    if (offset % REGISTRO_TAMANHO_SETOR || offset >= REGISTRO_TAMANHO_RAM) return false;
+    ram_prepara();
+    memset(&ram_regiao[offset], 0xFF, REGISTRO_TAMANHO_SETOR);
+    return true;
+}
+
+static bool ram_programa(uint32_t offset, const uint8_t *src, size_t n) {
+    if (offset + n > REGISTRO_TAMANHO_RAM || offset % REGISTRO_TAMANHO_PAGINA) return false;
+    ram_prepara();
+    /* Reproduzindo a semântica da flash NOR: gravação só leva bits de 1 para 0 */
+    for (size_t i = 0; i < n; i++) {
+        ram_regiao[offset + i] &= src[i];
+    }
+    return true;
+}
+
+static uint32_t ram_tamanho(void) {
+    return REGISTRO_TAMANHO_RAM;
+}
+
+const ArmazenamentoRegistro armazenamento_registro_ram = {
+    ram_le,
+    ram_apaga_setor,
+    ram_programa,
+    ram_tamanho,
+};
+
+
+/* ============================================================================
+ *  Meio de armazenamento em flash (RP2040)
+ * ============================================================================
+*/
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+/* Partição de sistema de arquivos, definida pelo linker do core arduino-pico */
+extern uint8_t _FS_start;
+extern uint8_t _FS_end;
+
+/* O registro ocupa a partição até a região da sessão (últimos setores) */
+static uint32_t flash_tamanho(void) {
+    uint32_t tamanho = (uint32_t)(&_FS_end - &_FS_start) - SESSAO_TAMANHO_REGIAO;
+    return tamanho - (tamanho % REGISTRO_TAMANHO_SETOR);
+}
+
+static inline uint32_t flash_offset(uint32_t offset) {
+    return (uint32_t)((uintptr_t)&_FS_start - XIP_BASE) + offset;
+}
+
+static bool flash_le(uint32_t offset, uint8_t *dest, size_t n) {
+    if (offset + n > flash_tamanho()) return false;
+    memcpy(dest, &_FS_start + offset, n);
+    return true;
+}
+
+static bool flash_apaga_setor(uint32_t offset) {
+    if (offset % REGISTRO_TAMANHO_SETOR || offset >= flash_tamanho()) return false;
+
+    /* Desabilitando interrupções enquanto o XIP está indisponível */
+    uint32_t ints = save_and_disable_interrupts();
+    flash_range_erase(flash_offset(offset), FLASH_SECTOR_SIZE);
+    restore_interrupts(ints);
+    return true;
+}
+
+static bool flash_programa(uint32_t offset, const uint8_t *src, size_t n) {
+    if (offset + n > flash_tamanho() || offset % FLASH_PAGE_SIZE || n % FLASH_PAGE_SIZE) return false;
+
+    uint32_t ints = save_and_disable_interrupts();
+    flash_range_program(flash_offset(offset), src, n);
+    restore_interrupts(ints);
+    return true;
+}
+
+const ArmazenamentoRegistro armazenamento_registro_flash = {
+    flash_le,
+    flash_apaga_setor,
+    flash_programa,
+    flash_tamanho,
+};
+
+#endif
+
+/*****************************END OF FILE**************************************/
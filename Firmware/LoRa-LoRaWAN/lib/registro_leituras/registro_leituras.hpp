@@ -0,0 +1,147 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  registro_leituras.hpp
+ *
+ *    Description:  Registro circular (append-only) das leituras em flash para
+ *                  store-and-forward: as leituras ficam pendentes até um uplink
+ *                  confirmado e são reenviadas em lotes quando o enlace volta.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 20:31:07
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#ifndef REGISTRO_LEITURAS_HPP
+#define REGISTRO_LEITURAS_HPP
+
+#include <Arduino.h>
+
+/****************************************************************************
+**                      CONFIGURAÇÃO DO ARMAZENAMENTO
+*****************************************************************************/
+
+/* Tamanho de um setor de flash (menor unidade apagável) */
+#define REGISTRO_TAMANHO_SETOR        4096
+
+/* Tamanho de uma página de flash (unidade de programação) */
+#define REGISTRO_TAMANHO_PAGINA       256
+
+/* Tamanho de cada registro (divisor da página: 8 registros por página) */
+#define REGISTRO_TAMANHO              32
+
+/* Registros por setor */
+#define REGISTRO_POR_SETOR            (REGISTRO_TAMANHO_SETOR / REGISTRO_TAMANHO)
+
+/* Bytes de payload guardados por leitura (o maior esquema do codec tem 10) */
+#define REGISTRO_TAM_DADOS            19
+
+/* Setores do meio em RAM usado no host */
+#define REGISTRO_SETORES_RAM          4
+
+/* Tipos de registro */
+#define REGISTRO_TIPO_LEITURA         0xA5   /* Leitura codificada, pendente até ser confirmada */
+#define REGISTRO_TIPO_CONFIRMACAO     0x5A   /* Leituras até 'valor' entregues ao servidor */
+
+/*
+ * Registro gravado na flash. Cada um é programado uma única vez, sobre posições
+ * apagadas; uma gravação interrompida deixa o CRC inválido e é ignorada. A
+ * sequência é compartilhada por leituras e confirmações (maior = mais recente).
+*/
+typedef struct {
+    uint32_t sequencia;                   /* Contador monotônico (0xFFFFFFFF = posição apagada) */
+    uint32_t valor;                       /* Leitura: carimbo do RTC (s); confirmação: sequência confirmada */
+    uint8_t  tipo;                        /* REGISTRO_TIPO_* */
+    uint8_t  porta;                       /* Esquema do payload (fPort) */
+    uint8_t  tam;                         /* Bytes usados em dados */
+    uint8_t  dados[REGISTRO_TAM_DADOS];   /* Leitura codificada (codec_uplink) */
+    uint16_t crc;                         /* CRC-16/CCITT dos campos anteriores */
+} RegistroFlash;
+
+/**
+ * @brief Operações de acesso à região do registro.
+ *
+ * Os deslocamentos são relativos ao início da região, cujo tamanho (múltiplo do
+ * setor) é informado por tamanho(). A programação é feita em páginas inteiras.
+*/
+typedef struct {
+    bool (*le)(uint32_t offset, uint8_t *dest, size_t n);
+    bool (*apaga_setor)(uint32_t offset);
+    bool (*programa)(uint32_t offset, const uint8_t *src, size_t n);
+    uint32_t (*tamanho)(void);
+} ArmazenamentoRegistro;
+
+/* Estado do registro, mantido na RAM (preservada durante o sono) */
+typedef struct {
+    const ArmazenamentoRegistro *meio;    /* Meio de armazenamento utilizado */
+    uint32_t capacidade;                  /* Posições de registro na região */
+    uint32_t cabeca;                      /* Próxima posição a gravar */
+    uint32_t sequencia;                   /* Sequência do registro mais recente (0 = vazio) */
+    uint32_t confirmada;                  /* Maior sequência de leitura já entregue */
+    uint32_t pendente;                    /* Posição da leitura pendente mais antiga */
+    uint32_t pendentes;                   /* Leituras gravadas e ainda não confirmadas */
+    uint32_t descartadas;                 /* Pendentes sobrescritas desde o boot (registro cheio) */
+    uint32_t apagamentos;                 /* Setores apagados desde o boot */
+} RegistroLeituras;
+
+/* Leitura pendente devolvida pela iteração */
+typedef struct {
+    uint32_t sequencia;
+    uint32_t segundos;                    /* Carimbo do RTC (segundos_rtc) */
+    uint8_t  porta;
+    uint8_t  tam;
+    uint8_t  dados[REGISTRO_TAM_DADOS];
+} LeituraRegistrada;
+
+/****************************************************************************
+**                            FUNÇÕES AUXILIARES DE USO
+*****************************************************************************/
+
+/**
+ * @brief Varre a região e reconstrói cabeça, confirmação e pendentes
+*/
+void inicializa_registro_leituras(RegistroLeituras *registro, const ArmazenamentoRegistro *meio);
+
+/**
+ * @brief Acrescenta uma leitura codificada ao registro (uma página programada; um setor
+ *        apagado a cada REGISTRO_POR_SETOR registros)
+*/
+bool registra_leitura(RegistroLeituras *registro, uint32_t segundos, uint8_t porta,
+                      const uint8_t *dados, size_t tam);
+
+/**
+ * @brief Posição inicial para percorrer as leituras pendentes
+*/
+uint32_t cursor_pendentes(const RegistroLeituras *registro);
+
+/**
+ * @brief Próxima leitura pendente a partir do cursor, da mais antiga para a mais recente
+ * @return false ao chegar na cabeça
+*/
+bool proxima_pendente(const RegistroLeituras *registro, uint32_t *cursor, LeituraRegistrada *leitura);
+
+/**
+ * @brief Grava a confirmação das leituras até a sequência indicada (inclusive)
+*/
+bool confirma_leituras(RegistroLeituras *registro, uint32_t sequencia);
+
+/**
+ * @brief Meio de armazenamento em RAM (dublê para testes no host, REGISTRO_SETORES_RAM setores)
+*/
+extern const ArmazenamentoRegistro armazenamento_registro_ram;
+
+#if defined(ARDUINO_ARCH_RP2040)
+/**
+ * @brief Meio de armazenamento na partição de sistema de arquivos, antes da sessão LoRaWAN
+*/
+extern const ArmazenamentoRegistro armazenamento_registro_flash;
+#endif
+
+#endif
+/*****************************END OF FILE**************************************/
@@ -0,0 +1,302 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  sessao_lorawan.cpp
+ *
+ *    Description:  -
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 09:14:02
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include "sessao_lorawan.hpp"
+#include <string.h>
+
+#if defined(ARDUINO_ARCH_RP2040)
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#endif
+
+/* Quantidade de slots disponíveis na região reservada */
+#define SESSAO_NUM_SLOTS  (SESSAO_TAMANHO_REGIAO / SESSAO_TAMANHO_SLOT)
+
+/* Buffer de trabalho para leitura e gravação de um slot completo */
+static uint8_t slot_buf[SESSAO_TAMANHO_SLOT];
+
+
+/* ============================================================================
+ *  Funções internas
+ * ============================================================================
+*/
+
+/**
+ * @brief Calcula o CRC-16/CCITT (polinômio 0x1021, valor inicial 0xFFFF)
+*/
+static uint16_t crc16_ccitt(const uint8_t *dados, size_t n, uint16_t crc) {
+    for (size_t i = 0; i < n; i++) {
+        crc ^= (uint16_t)dados[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief Lê o slot indicado para o buffer de trabalho e valida cabeçalho e CRC
+*/
+static bool le_slot_valido(const SessaoLoRaWAN *sessao, int16_t slot) {
+    if (!sessao->meio->le((uint32_t)slot * SESSAO_TAMANHO_SLOT, slot_buf, SESSAO_TAMANHO_SLOT))
+        return false;
+
+    CabecalhoSessao cab;
+    memcpy(&cab, slot_buf, sizeof(cab));
+
+    if (cab.magica != SESSAO_MAGICA) return false;
+    if ((size_t)cab.tam_nonces + cab.tam_sessao > SESSAO_CARGA_MAX) return false;
+
+    uint16_t crc = crc16_ccitt(&slot_buf[sizeof(cab)], cab.tam_nonces + cab.tam_sessao, 0xFFFF);
+    return (crc == cab.crc);
+}
+
+/**
+ * @brief Verifica se o slot indicado está apagado (todos os bytes em 0xFF)
+*/
+static bool slot_em_branco(const SessaoLoRaWAN *sessao, int16_t slot) {
+    if (!sessao->meio->le((uint32_t)slot * SESSAO_TAMANHO_SLOT, slot_buf, SESSAO_TAMANHO_SLOT))
+        return false;
+
+    for (size_t i = 0; i < SESSAO_TAMANHO_SLOT; i++) {
+        if (slot_buf[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+
+/* ============================================================================
+ *  Gerenciamento da sessão
+ * ============================================================================
+*/
+
+/**
+ * @brief Inicializa o gerenciador e localiza o registro mais recente no meio.
+ *
+ * Percorre todos os slots e seleciona o de maior sequência com CRC válido.
+ *
+ * @param sessao Ponteiro para a estrutura de controle da sessão
+ * @param meio   Meio de armazenamento (flash no RP2040 ou RAM no host)
+*/
+void inicializa_sessao_lorawan(SessaoLoRaWAN *sessao, const ArmazenamentoSessao *meio) {
+    sessao->meio = meio;
+    sessao->slot_atual = -1;
+    sessao->sequencia = 0;
+    sessao->gravacoes = 0;
+
+    for (int16_t slot = 0; slot < SESSAO_NUM_SLOTS; slot++) {
+        if (!le_slot_valido(sessao, slot)) continue;
+
+        CabecalhoSessao cab;
+        memcpy(&cab, slot_buf, sizeof(cab));
+
+        /* Mantendo o registro de maior sequência (mais recente) */
+        if (sessao->slot_atual < 0 || cab.sequencia > sessao->sequencia) {
+            sessao->slot_atual = slot;
+            sessao->sequencia = cab.sequencia;
+        }
+    }
+}
+
+/**
+ * @brief Grava os buffers de nonces e sessão no slot seguinte ao mais recente.
+ *
+ * Os slots são usados em sequência circular (nivelamento de desgaste). Um setor
+ * só é apagado quando a gravação entra nele, de modo que o registro anterior,
+ * localizado em outro setor, continua válido caso a energia caia no meio da operação.
+ *
+ * @return true se o registro foi gravado e conferido com sucesso
+*/
+bool salva_sessao_lorawan(SessaoLoRaWAN *sessao, const uint8_t *nonces, size_t tam_nonces,
+                          const uint8_t *buf_sessao, size_t tam_sessao) {
+    if (tam_nonces + tam_sessao > SESSAO_CARGA_MAX) return false;
+
+    /* Selecionando o próximo slot de forma circular */
+    int16_t slot = (sessao->slot_atual + 1) % SESSAO_NUM_SLOTS;
+    const int16_t slots_por_setor = SESSAO_TAMANHO_SETOR / SESSAO_TAMANHO_SLOT;
+
+    /* Slot no meio de um setor com resíduo (gravação interrompida): pulando para o próximo setor */
+    if ((slot % slots_por_setor) != 0 && !slot_em_branco(sessao, slot)) {
+        slot = ((slot / slots_por_setor + 1) * slots_por_setor) % SESSAO_NUM_SLOTS;
+    }
+
+    /* Apagando o setor ao entrar nele */
+    if ((slot % slots_por_setor) == 0) {
+        if (!sessao->meio->apaga_setor((uint32_t)slot * SESSAO_TAMANHO_SLOT)) return false;
+    }
+
+    /* Montando o registro completo no buffer de trabalho */
+    CabecalhoSessao cab;
+    cab.magica = SESSAO_MAGICA;
+    cab.sequencia = sessao->sequencia + 1;
+    cab.tam_nonces = (uint16_t)tam_nonces;
+    cab.tam_sessao = (uint16_t)tam_sessao;
+    cab.crc = crc16_ccitt(nonces, tam_nonces, 0xFFFF);
+    cab.crc = crc16_ccitt(buf_sessao, tam_sessao, cab.crc);
+    cab.reservado = 0xFFFF;
+
+    memset(slot_buf, 0xFF, SESSAO_TAMANHO_SLOT);
+    memcpy(slot_buf, &cab, sizeof(cab));
+    memcpy(&slot_buf[sizeof(cab)], nonces, tam_nonces);
+    memcpy(&slot_buf[sizeof(cab) + tam_nonces], buf_sessao, tam_sessao);
+
+    if (!sessao->meio->programa((uint32_t)slot * SESSAO_TAMANHO_SLOT, slot_buf, SESSAO_TAMANHO_SLOT))
+        return false;
+
+    /* Conferindo a gravação antes de considerar o slot como atual */
+    if (!le_slot_valido(sessao, slot)) return false;
+
+    sessao->slot_atual = slot;
+    sessao->sequencia = cab.sequencia;
+    sessao->gravacoes++;
+    return true;
+}
+
+/**
+ * @brief Recupera os buffers do registro mais recente.
+ *
+ * @return false se não houver registro válido ou se os tamanhos não coincidirem
+ *         (ex.: versão diferente do RadioLib)
+*/
+bool restaura_sessao_lorawan(SessaoLoRaWAN *sessao, uint8_t *nonces, size_t tam_nonces,
+                             uint8_t *buf_sessao, size_t tam_sessao) {
+    if (sessao->slot_atual < 0) return false;
+    if (!le_slot_valido(sessao, sessao->slot_atual)) return false;
+
+    CabecalhoSessao cab;
+    memcpy(&cab, slot_buf, sizeof(cab));
+    if (cab.tam_nonces != tam_nonces || cab.tam_sessao != tam_sessao) return false;
+
+    memcpy(nonces, &slot_buf[sizeof(cab)], tam_nonces);
+    memcpy(buf_sessao, &slot_buf[sizeof(cab) + tam_nonces], tam_sessao);
+    return true;
+}
+
+/**
+ * @brief Apaga toda a região reservada, descartando a sessão armazenada
+*/
+bool apaga_sessao_lorawan(SessaoLoRaWAN *sessao) {
+    for (uint32_t offset = 0; offset < SESSAO_TAMANHO_REGIAO; offset += SESSAO_TAMANHO_SETOR) {
+        if (!sessao->meio->apaga_setor(offset)) return false;
+    }
+    sessao->slot_atual = -1;
+    sessao->sequencia = 0;
+    return true;
+}
+
+
+/* ============================================================================
+ *  Meio de armazenamento em RAM
+ * ============================================================================
+*/
+
+/* Região simulada, inicializada como flash apagada no primeiro acesso */
+static uint8_t ram_regiao[SESSAO_TAMANHO_REGIAO];
+static bool ram_inicializada = false;
+
+static void ram_prepara(void) {
+    if (!ram_inicializada) {
+        memset(ram_regiao, 0xFF, sizeof(ram_regiao));
+        ram_inicializada = true;
+    }
+}
+
+static bool ram_le(uint32_t offset, uint8_t *dest, size_t n) {
+    if (offset + n > SESSAO_TAMANHO_REGIAO) return false;
+    ram_prepara();
+    memcpy(dest, &ram_regiao[offset], n);
+    return true;
+}
+
+static bool ram_apaga_setor(uint32_t offset) {
+    if (offset % SESSAO_TAMANHO_SETOR || offset >= SESSAO_TAMANHO_REGIAO) return false;
+    ram_prepara();
+    memset(&ram_regiao[offset], 0xFF, SESSAO_TAMANHO_SETOR);
+    return true;
+}
+
+static bool ram_programa(uint32_t offset, const uint8_t *src, size_t n) {
+    if (offset + n > SESSAO_TAMANHO_REGIAO) return false;
+    ram_prepara();
+    /* Reproduzindo a semântica da flash NOR: gravação só leva bits de 1 para 0 */
+    for (size_t i = 0; i < n; i++) {
+        ram_regiao[offset + i] &= src[i];
+    }
+    return true;
+}
+
+const ArmazenamentoSessao armazenamento_sessao_ram = {
+    ram_le,
+    ram_apaga_setor,
+    ram_programa,
+};
+
+
+/* ============================================================================
+ *  Meio de armazenamento em flash (RP2040)
+ * ============================================================================
+*/
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+/* Fim da partição de sistema de arquivos, definido pelo linker do core arduino-pico */
+extern uint8_t _FS_end;
+
+/* A sessão ocupa os últimos setores da partição (board_build.filesystem_size) */
+static inline const uint8_t *flash_regiao(void) {
+    return &_FS_end - SESSAO_TAMANHO_REGIAO;
+}
+
+static inline uint32_t flash_offset(uint32_t offset) {
+    return (uint32_t)((uintptr_t)flash_regiao() - XIP_BASE) + offset;
+}
+
+static bool flash_le(uint32_t offset, uint8_t *dest, size_t n) {
+    if (offset + n > SESSAO_TAMANHO_REGIAO) return false;
+    memcpy(dest, flash_regiao() + offset, n);
+    return true;
+}
+
+static bool flash_apaga_setor(uint32_t offset) {
+    if (offset % SESSAO_TAMANHO_SETOR || offset >= SESSAO_TAMANHO_REGIAO) return false;
+
+    /* Desabilitando interrupções enquanto o XIP está indisponível */
+    uint32_t ints = save_and_disable_interrupts();
+    flash_range_erase(flash_offset(offset), FLASH_SECTOR_SIZE);
+    restore_interrupts(ints);
+    return true;
+}
+
+static bool flash_programa(uint32_t offset, const uint8_t *src, size_t n) {
+    if (offset + n > SESSAO_TAMANHO_REGIAO || n % FLASH_PAGE_SIZE) return false;
+
+    uint32_t ints = save_and_disable_interrupts();
+    flash_range_program(flash_offset(offset), src, n);
+    restore_interrupts(ints);
+    return true;
+}
+
+const ArmazenamentoSessao armazenamento_sessao_flash = {
+    flash_le,
+    flash_apaga_setor,
+    flash_programa,
+};
+
+#endif
+
+/*****************************END OF FILE**************************************/
@@ -0,0 +1,120 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  sessao_lorawan.hpp
+ *
+ *    Description:  Persistência da sessão LoRaWAN (buffers de nonces e sessão do
+ *                  RadioLib) em flash com nivelamento de desgaste.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 09:12:40
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#ifndef SESSAO_LORAWAN_HPP
+#define SESSAO_LORAWAN_HPP
+
+#include <Arduino.h>
+
+/****************************************************************************
+**                      CONFIGURAÇÃO DO ARMAZENAMENTO
+*****************************************************************************/
+
+/* Tamanho de um setor de flash (menor unidade apagável) */
+#define SESSAO_TAMANHO_SETOR          4096
+
+/* Tamanho de cada slot de gravação (múltiplo de 256 bytes, página da flash) */
+#define SESSAO_TAMANHO_SLOT           512
+
+/* Quantidade de setores reservados para a sessão (mínimo 2 para não perder o último registro ao apagar) */
+#define SESSAO_NUM_SETORES            2
+
+/* Tamanho total da região reservada para a sessão */
+#define SESSAO_TAMANHO_REGIAO         (SESSAO_NUM_SETORES * SESSAO_TAMANHO_SETOR)
+
+/* Gravando a sessão na flash apenas a cada N uplinks (o fCntUp é avançado ao menos em N ao restaurar) */
+#define SESSAO_INTERVALO_GRAVACAO     8
+
+/* Assinatura do registro na flash ("LWS1") */
+#define SESSAO_MAGICA                 0x3153574CUL
+
+/* Cabeçalho gravado no início de cada slot */
+typedef struct {
+    uint32_t magica;        /* Identificando um slot válido */
+    uint32_t sequencia;     /* Contador monotônico de gravações (maior = mais recente) */
+    uint16_t tam_nonces;    /* Tamanho do buffer de nonces gravado após o cabeçalho */
+    uint16_t tam_sessao;    /* Tamanho do buffer de sessão gravado após os nonces */
+    uint16_t crc;           /* CRC-16/CCITT dos buffers de nonces e sessão */
+    uint16_t reservado;
+} CabecalhoSessao;
+
+/* Maior carga útil (nonces + sessão) que cabe em um slot */
+#define SESSAO_CARGA_MAX              (SESSAO_TAMANHO_SLOT - sizeof(CabecalhoSessao))
+
+/**
+ * @brief Operações de acesso ao meio de armazenamento da sessão.
+ *
+ * Os deslocamentos são relativos ao início da região reservada. A implementação
+ * em flash é usada no RP2040; a implementação em RAM permite validar o
+ * comportamento do armazenamento no host (Linux).
+*/
+typedef struct {
+    bool (*le)(uint32_t offset, uint8_t *dest, size_t n);
+    bool (*apaga_setor)(uint32_t offset);
+    bool (*programa)(uint32_t offset, const uint8_t *src, size_t n);
+} ArmazenamentoSessao;
+
+/* Estado do gerenciador de sessão */
+typedef struct {
+    const ArmazenamentoSessao *meio;  /* Meio de armazenamento utilizado */
+    int16_t  slot_atual;              /* Slot com o registro mais recente (-1 se vazio) */
+    uint32_t sequencia;               /* Sequência do registro mais recente */
+    uint32_t gravacoes;               /* Gravações realizadas desde o boot */
+} SessaoLoRaWAN;
+
+/****************************************************************************
+**                            FUNÇÕES AUXILIARES DE USO
+*****************************************************************************/
+
+/**
+ * @brief Inicializa o gerenciador e localiza o registro mais recente no meio
+*/
+void inicializa_sessao_lorawan(SessaoLoRaWAN *sessao, const ArmazenamentoSessao *meio);
+
+/**
+ * @brief Grava os buffers de nonces e sessão no próximo slot livre
+*/
+bool salva_sessao_lorawan(SessaoLoRaWAN *sessao, const uint8_t *nonces, size_t tam_nonces,
+                          const uint8_t *buf_sessao, size_t tam_sessao);
+
+/**
+ * @brief Recupera os buffers do registro mais recente e válido
+*/
+bool restaura_sessao_lorawan(SessaoLoRaWAN *sessao, uint8_t *nonces, size_t tam_nonces,
+                             uint8_t *buf_sessao, size_t tam_sessao);
+
+/**
+ * @brief Invalida a sessão armazenada (força nova ativação no próximo boot)
+*/
+bool apaga_sessao_lorawan(SessaoLoRaWAN *sessao);
+
+/**
+ * @brief Meio de armazenamento em RAM (dublê para testes no host)
+*/
+extern const ArmazenamentoSessao armazenamento_sessao_ram;
+
+#if defined(ARDUINO_ARCH_RP2040)
+/**
+ * @brief Meio de armazenamento nos últimos setores da partição de sistema de arquivos
+*/
+extern const ArmazenamentoSessao armazenamento_sessao_flash;
+#endif
+
+#endif
+/*****************************END OF FILE**************************************/
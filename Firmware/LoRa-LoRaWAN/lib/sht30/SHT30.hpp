@@ -21,18 +21,87 @@
 
 #include <Arduino.h>
 #include "hardware/i2c.h"
+#include "../barramento_i2c/barramento_i2c.hpp"
 #define UART_ID uart0
 
+/* SCL usado com o SHT30: ele aceita Fast-mode Plus (1 MHz). O barramento limita o valor
+   pelo clk_peri atual; use 400 kHz se os pull-ups não garantirem as bordas do Fm+ */
+#ifndef SHT30_I2C_BAUD
+#define SHT30_I2C_BAUD (1000 * 1000)
+#endif
+
+/* Repetibilidade da medição single shot (maior repetibilidade = conversão mais longa) */
+typedef enum {
+    SHT30_REPETIBILIDADE_BAIXA,   /* 0x2416, até 4,5 ms */
+    SHT30_REPETIBILIDADE_MEDIA,   /* 0x240B, até 6,5 ms */
+    SHT30_REPETIBILIDADE_ALTA     /* 0x2400, até 15,5 ms */
+} RepetibilidadeSHT30;
+
+/* Frequência do modo de aquisição periódica (medições por segundo) */
+typedef enum {
+    SHT30_MPS_0_5,                /* 0,5 mps (uma medição a cada 2 s) */
+    SHT30_MPS_1,
+    SHT30_MPS_2,
+    SHT30_MPS_4,
+    SHT30_MPS_10
+} FrequenciaSHT30;
+
+/* Resultado da tentativa de coleta de uma medição em andamento */
+typedef enum {
+    SHT30_PRONTO,                 /* Medição lida e convertida */
+    SHT30_OCUPADO,                /* Conversão em andamento (ou, no modo periódico, sem amostra nova) */
+    SHT30_ERRO                    /* Falha no barramento, CRC inválido ou nenhuma medição iniciada */
+} ResultadoSHT30;
+
 /* Definindo estrutura para armazenar os dados e configuração do sensor SHT30 */
 typedef struct {
     float temperatura;   /* Armazenando temperatura medida em graus Celsius */
     float umidade;       /* Armazenando umidade relativa em porcentagem */
     uint8_t endereco;    /* Armazenando endereço I2C do sensor */
     i2c_inst_t *i2c;     /* Armazenando instância de I2C utilizada na comunicação */
+    bool medindo;        /* Indicando conversão iniciada e ainda não coletada */
+    uint64_t pronto_us;  /* Instante (time_us_64) em que a conversão termina */
+    RepetibilidadeSHT30 repetibilidade;  /* Repetibilidade da última medição iniciada */
+    bool periodico;      /* Sensor em aquisição periódica (aceita apenas Fetch e Break) */
+    FrequenciaSHT30 frequencia;          /* Frequência do modo periódico ativo */
+
+    /* Contadores de erro acumulados desde a inicialização */
+    uint32_t falhas_i2c;        /* Comando ou leitura sem resposta (NACK / transferência curta) */
+    uint32_t falhas_crc;        /* Palavras de temperatura ou umidade com CRC inválido */
+    uint32_t resets;            /* Soft resets enviados durante as novas tentativas */
+    uint32_t leituras_perdidas; /* Leituras abandonadas após esgotar as tentativas */
 } SensorSHT30;
 
+/* Novas tentativas (com soft reset) antes de abandonar a leitura no ciclo */
+#define SHT30_MAX_TENTATIVAS          3
+
+/* Acumulador de amostras (mínimo, média e máximo) entre envios */
+typedef struct {
+    uint16_t amostras;
+    float temp_min, temp_max, temp_soma;
+    float umid_min, umid_max, umid_soma;
+} AcumuladorSHT30;
+
 void inicializa_sensor_sht30(SensorSHT30 *sensor, i2c_inst_t *i2c, uint8_t endereco, uint sda_pin, uint scl_pin);
 bool ler_sensor_sht30(SensorSHT30 *sensor);
 void exibe_dados_sht30(SensorSHT30 *sensor);
+
+/* API assíncrona: inicia a conversão e coleta depois, sem clock stretching */
+bool sht30_start_measurement(SensorSHT30 *sensor, RepetibilidadeSHT30 repetibilidade);
+ResultadoSHT30 sht30_try_fetch(SensorSHT30 *sensor);
+bool sht30_wait_fetch(SensorSHT30 *sensor);
+bool sht30_soft_reset(SensorSHT30 *sensor);
+uint8_t sht30_crc8(const uint8_t *dados, size_t n);
+
+/* Aquisição periódica: o sensor mede sozinho e o MCU coleta com Fetch Data (0xE000) */
+bool sht30_start_periodic(SensorSHT30 *sensor, FrequenciaSHT30 frequencia, RepetibilidadeSHT30 repetibilidade);
+ResultadoSHT30 sht30_fetch_periodic(SensorSHT30 *sensor);
+bool sht30_stop_periodic(SensorSHT30 *sensor);
+
+/* Estatística de N amostras antes do envio */
+void sht30_zera_acumulador(AcumuladorSHT30 *acumulador);
+void sht30_acumula(AcumuladorSHT30 *acumulador, const SensorSHT30 *sensor);
+float sht30_media_temperatura(const AcumuladorSHT30 *acumulador);
+float sht30_media_umidade(const AcumuladorSHT30 *acumulador);
 #endif
 /*****************************END OF FILE**************************************/
\ No newline at end of file
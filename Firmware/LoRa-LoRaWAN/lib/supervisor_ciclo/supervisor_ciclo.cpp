@@ -0,0 +1,121 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  supervisor_ciclo.cpp
+ *
+ *    Description:  -
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 23:59:37
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include "supervisor_ciclo.hpp"
+#include <stdio.h>
+#include "pico/time.h"
+#include "hardware/watchdog.h"
+
+/*
+ * Registradores scratch (zerados na energização, preservados no reset do watchdog):
+ *   0: SUPERVISOR_MAGICO | fase em andamento
+ *   1: ciclo em andamento
+ *   2: prazo armado (ms)
+ *   3: SUPERVISOR_MAGICO | resets pelo watchdog desde a energização
+*/
+#define SCRATCH_FASE        0
+#define SCRATCH_CICLO       1
+#define SCRATCH_PRAZO       2
+#define SCRATCH_REINICIOS   3
+
+static FalhaSupervisor falha_anterior;
+static uint32_t limite_ciclo_ms;
+static uint32_t ciclo_atual;
+static uint64_t inicio_ciclo_us;
+
+static bool scratch_valido(uint indice) {
+    return (watchdog_hw->scratch[indice] & SUPERVISOR_MASCARA_MAGICO) == SUPERVISOR_MAGICO;
+}
+
+/**
+ * @brief Grava a fase nos scratch e rearma o watchdog com o prazo informado
+*/
+static void arma(FasePerfil fase, uint32_t prazo_ms) {
+    if (prazo_ms > SUPERVISOR_PRAZO_MAXIMO_MS) prazo_ms = SUPERVISOR_PRAZO_MAXIMO_MS;
+    if (prazo_ms == 0) prazo_ms = 1;
+
+    watchdog_hw->scratch[SCRATCH_FASE] = SUPERVISOR_MAGICO | (uint32_t)fase;
+    watchdog_hw->scratch[SCRATCH_CICLO] = ciclo_atual;
+    watchdog_hw->scratch[SCRATCH_PRAZO] = prazo_ms;
+    watchdog_enable(prazo_ms, true);
+}
+
+const FalhaSupervisor *inicializa_supervisor(uint32_t ciclo_max_ms) {
+    uint32_t reinicios = scratch_valido(SCRATCH_REINICIOS)
+                       ? (watchdog_hw->scratch[SCRATCH_REINICIOS] & ~SUPERVISOR_MASCARA_MAGICO) : 0;
+
+    /* Reset pelo watchdog armado aqui (não por watchdog_reboot() nem pelo pino RUN)
+       com uma fase gravada por este supervisor */
+    falha_anterior.ocorreu = watchdog_enable_caused_reboot() && scratch_valido(SCRATCH_FASE);
+    if (falha_anterior.ocorreu) {
+        falha_anterior.fase = (uint8_t)(watchdog_hw->scratch[SCRATCH_FASE] & ~SUPERVISOR_MASCARA_MAGICO);
+        falha_anterior.ciclo = watchdog_hw->scratch[SCRATCH_CICLO];
+        falha_anterior.prazo_ms = watchdog_hw->scratch[SCRATCH_PRAZO];
+        if (reinicios < 0xFFFF) reinicios++;
+    }
+    falha_anterior.reinicios = reinicios;
+    watchdog_hw->scratch[SCRATCH_REINICIOS] = SUPERVISOR_MAGICO | reinicios;
+
+    limite_ciclo_ms = ciclo_max_ms;
+    ciclo_atual = 0;
+    inicio_ciclo_us = time_us_64();
+    arma(PERFIL_BOOT, SUPERVISOR_PRAZO_BOOT_MS);
+    return &falha_anterior;
+}
+
+void supervisor_inicia_ciclo(void) {
+    ciclo_atual++;
+    inicio_ciclo_us = time_us_64();
+    arma(PERFIL_CLOCKS, SUPERVISOR_PRAZO_CLOCKS_MS);
+}
+
+uint32_t supervisor_tempo_ciclo_ms(void) {
+    return (uint32_t)((time_us_64() - inicio_ciclo_us) / 1000);
+}
+
+void supervisor_fase(FasePerfil fase, uint32_t prazo_ms) {
+    /* O ciclo inteiro fica limitado a limite_ciclo_ms, por mais fases que ele tenha */
+    if (ciclo_atual > 0) {
+        uint32_t decorrido = supervisor_tempo_ciclo_ms();
+        uint32_t restante = (decorrido < limite_ciclo_ms) ? limite_ciclo_ms - decorrido : 0;
+        if (prazo_ms > restante) prazo_ms = restante;
+    }
+    arma(fase, prazo_ms);
+}
+
+void supervisor_fase_entre_ciclos(FasePerfil fase, uint32_t prazo_ms) {
+    arma(fase, prazo_ms);
+}
+
+void supervisor_dorme(void) {
+    watchdog_disable();
+    watchdog_hw->scratch[SCRATCH_FASE] = SUPERVISOR_MAGICO | PERFIL_DORMIR;
+}
+
+void supervisor_informa_falha(uart_inst_t *uart) {
+    if (!falha_anterior.ocorreu) return;
+
+    char linha[96];
+    snprintf(linha, sizeof(linha), "Reset pelo watchdog: fase %s, ciclo %lu, prazo %lu ms (%lu resets)\n\r",
+             perfil_nome_fase(falha_anterior.fase), (unsigned long)falha_anterior.ciclo,
+             (unsigned long)falha_anterior.prazo_ms, (unsigned long)falha_anterior.reinicios);
+    uart_puts(uart, linha);
+    uart_tx_wait_blocking(uart);
+}
+
+/*****************************END OF FILE**************************************/
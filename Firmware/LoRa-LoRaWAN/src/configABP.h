@@ -13,7 +13,14 @@
 #define RADIO_BOARD_RASPBERRYPI_PICO
 #include <RadioBoards.h>
 
+#if defined(MODE_DEEP_SLEEP) && defined(CLOCK_GOVERNADOR)
+// RadioLib HAL that lowers the MCU clocks while the MAC waits for the Rx windows
+#include "halGovernador.h"
+HalGovernador hal_governador(RADIO_SPI);
+Radio radio = new Module(&hal_governador, RADIO_NSS, RADIO_IRQ, RADIO_RST, RADIO_GPIO);
+#else
 Radio radio = new RadioModule();
+#endif
 
 
 // how often to send an uplink - consider legal & FUP constraints - see notes
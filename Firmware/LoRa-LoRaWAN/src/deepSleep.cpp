@@ -52,19 +52,37 @@
 
 #include "configABP.h"
 #include "utilsLorawan.h"
+#include "gerenciadorRadio.h"
 
 #include <rosc.h>
 #include <sleep.h>
 #include "hardware/rtc.h"
 #include "hardware/clocks.h"
 #include "hardware/gpio.h"
+#include "hardware/sync.h"
 #include "hardware/xosc.h"
 #include "hardware/structs/scb.h"
+#include "hardware/structs/syscfg.h"
 #include "hardware/uart.h"
 #include "pico/runtime_init.h"
 #include "hardware/pwm.h"
 #include "../lib/ds3231_rtc/ds3231.hpp"
 #include "../lib/sht30/SHT30.hpp"
+#include "../lib/sessao_lorawan/sessao_lorawan.hpp"
+#include "../lib/codec_uplink/codec_uplink.hpp"
+#include "../lib/perfil_ciclo/perfil_ciclo.hpp"
+#include "../lib/clock_despertar/clock_despertar.hpp"
+#include "../lib/supervisor_ciclo/supervisor_ciclo.hpp"
+#include "../lib/despachante_despertar/despachante_despertar.hpp"
+#ifdef REGISTRO_LEITURAS
+#include "../lib/registro_leituras/registro_leituras.hpp"
+#endif
+#ifdef ORCAMENTO_AIRTIME_MS_HORA
+#include "../lib/orcamento_airtime/orcamento_airtime.hpp"
+#endif
+#ifdef BATERIA_GPIO
+#include "../lib/bateria/bateria.hpp"
+#endif
 
 #define UART_ID uart0
 #define BAUD_RATE 9600
@@ -74,12 +92,182 @@
 #define I2C_SCL_PIN 27
 #define WAKE_GPIO 28
 
+/* Agendamento em grade absoluta: definindo GRADE_PERIODO_MIN (divisor de 1440, ex.: -D GRADE_PERIODO_MIN=15)
+   os despertares ficam alinhados ao relógio do RTC (00:00, 00:15, ...) sem acumular atraso. GRADE_FASE_SEG
+   desloca a grade (escalonamento entre nós ou, com 1440, o horário do envio diário). Sem a definição o
+   alarme é relativo ao fim de cada ciclo */
+#ifdef GRADE_PERIODO_MIN
+#ifndef GRADE_FASE_SEG
+#define GRADE_FASE_SEG 0
+#endif
+static const GradeAlarme grade_alarme = { GRADE_PERIODO_MIN, GRADE_FASE_SEG };
+#define INTERVALO_CICLO_SEG (GRADE_PERIODO_MIN * 60UL)
+#else
+/* Intervalo do alarme relativo, em segundos */
+#define INTERVALO_CICLO_SEG 5
+#endif
+
+/* Maior payload de uplink; o limite efetivo vem de node.getMaxPayloadLen() no DR atual */
+#define TAM_MAX_UPLINK 255
+
+/* Repetibilidade da medição do SHT30 (BAIXA/MEDIA/ALTA: 4,5/6,5/15,5 ms de conversão) */
+#define SHT30_REPETIBILIDADE SHT30_REPETIBILIDADE_ALTA
+
+/* Modo de aquisição do SHT30: definindo SHT30_MODO_PERIODICO (ex.: -D SHT30_MODO_PERIODICO=SHT30_MPS_1)
+   o sensor mede sozinho entre os despertares (alguns uA a mais) e o MCU apenas coleta a
+   amostra mais recente, sem esperar a conversão. Sem a definição é usado o single shot */
+
+/* Amostras acumuladas (mínimo/média/máximo) antes de cada envio; 1 envia cada leitura */
+#ifndef SHT30_AMOSTRAS_POR_ENVIO
+#define SHT30_AMOSTRAS_POR_ENVIO 1
+#endif
+
+/* Memórias desligadas no sono: definindo SONO_DESLIGA_MEMORIAS a ROM e a SRAM4 (scratch X, sem
+   conteúdo com o core 1 parado) são desligadas pelo SYSCFG durante o __wfi(), assim como a DPRAM
+   do USB com PIO_FRAMEWORK_ARDUINO_NO_USB. A região de retenção são as SRAMs 0-3 (intercaladas,
+   com .data, .bss e heap: sessão, contadores e anéis) e a SRAM5 (pilha do core 0) */
+#ifdef SONO_DESLIGA_MEMORIAS
+static uint32_t memorias_desligadas_no_sono(void) {
+  uint32_t mascara = SYSCFG_MEMPOWERDOWN_ROM_BITS;
+#ifdef PIO_FRAMEWORK_ARDUINO_NO_USB
+  mascara |= SYSCFG_MEMPOWERDOWN_USB_BITS;
+#endif
+  if (sleep_scratch_x_unused()) mascara |= SYSCFG_MEMPOWERDOWN_SRAM4_BITS;
+  return mascara;
+}
+#endif
+
+/* Sono a partir do ROSC: definindo SONO_ROSC_KHZ (ex.: -D SONO_ROSC_KHZ=6000) o sono roda do oscilador
+   em anel e o XOSC fica desligado. A calibração (busca binária contra o XOSC) guarda código e frequência
+   medida na RAM, e os ciclos seguintes só conferem o código com uma contagem, refazendo a busca se a
+   deriva passar de SONO_ROSC_TOLERANCIA_KHZ. Os clocks do sono usam a frequência medida */
+#ifdef SONO_ROSC_KHZ
+#ifndef SONO_ROSC_TOLERANCIA_KHZ
+#define SONO_ROSC_TOLERANCIA_KHZ (SONO_ROSC_KHZ / 50)
+#endif
+#endif
+
+/* Perfis de clock no despertar: definindo CLOCK_DESPERTAR_PERFIS o ciclo acorda em 12 MHz do
+   XOSC, sem religar os PLLs (clocks_init() trava os dois PLLs a cada despertar só para
+   sleep_run_from_xosc() desligá-los de novo). Os ciclos de envio sobem para o perfil do rádio
+   (PLL_SYS em CLOCK_RADIO_MHZ; o SPI é reiniciado por RadioBeginSPI() em seguida).
+   UART e I2C têm os divisores reajustados a cada troca de perfil */
+
+/* Governador de clock e tensão: com CLOCK_GOVERNADOR (junto de CLOCK_DESPERTAR_PERFIS) a tensão
+   do núcleo acompanha cada perfil, as esperas do MAC pelas janelas de RX descem para o perfil do
+   sensor (HalGovernador, em configABP.h) e a gravação da sessão e o restante do ciclo após o envio
+   rodam no perfil do MAC (CLOCK_MAC_MHZ). O sendReceive() fica no perfil do rádio: o RadioLib faz
+   MIC/AES, SPI e TX na mesma chamada */
+#ifdef CLOCK_DESPERTAR_PERFIS
+static const PerifericosClock perifericos_clock = { UART_ID, BAUD_RATE, i2c1, 400 * 1000, NULL, 0 };
+#endif
+
+/* Store-and-forward: com REGISTRO_LEITURAS cada leitura enviada é antes gravada no registro
+   circular da partição de sistema de arquivos (lib/registro_leituras). A cada
+   REGISTRO_CONFIRMA_A_CADA leituras pendentes o uplink sai confirmado, e o ACK entrega todas
+   elas. Sem ACK (ou com erro no envio) o nó entra em recuperação: as pendentes seguem em lotes
+   confirmados na porta CODEC_PORTA_LOTE, até REGISTRO_LOTES_POR_CICLO por ciclo, com a idade de
+   cada leitura em vez do horário */
+#ifdef REGISTRO_LEITURAS
+#ifndef REGISTRO_CONFIRMA_A_CADA
+#define REGISTRO_CONFIRMA_A_CADA 8
+#endif
+#ifndef REGISTRO_LOTES_POR_CICLO
+#define REGISTRO_LOTES_POR_CICLO 2
+#endif
+static RegistroLeituras registro_leituras;
+static bool recuperando_registro = false;
+#endif
+
+/* Série de amostras: com SERIE_LEITURAS cada despertar guarda a amostra na RAM (mantida no sono)
+   e o rádio só é preparado quando a série enche o maior payload do DR atual, lido de
+   getMaxPayloadLen() a cada envio. A série vai na porta CODEC_PORTA_SERIE_TH, em diferenças
+   varint (cerca de 2 bytes por amostra contra 3 + 13 de cabeçalho LoRaWAN por uplink); leituras
+   falhas entram como amostras ausentes e as amostras que não couberem seguem no próximo envio */
+#ifdef SERIE_LEITURAS
+#ifndef SERIE_MAX_AMOSTRAS
+#define SERIE_MAX_AMOSTRAS 64
+#endif
+#if SERIE_MAX_AMOSTRAS > 255
+#error "SERIE_MAX_AMOSTRAS deve caber no contador de 8 bits do payload"
+#endif
+#if SHT30_AMOSTRAS_POR_ENVIO > 1 || defined(REGISTRO_LEITURAS)
+#error "SERIE_LEITURAS substitui SHT30_AMOSTRAS_POR_ENVIO e não é combinada com REGISTRO_LEITURAS"
+#endif
+/* Limite até o primeiro envio: menor DR do AU915 (DR2, 51 bytes) */
+#define SERIE_LIMITE_INICIAL 51
+
+static AmostraSerie serie_amostras[SERIE_MAX_AMOSTRAS];
+static uint8_t serie_num_amostras = 0;
+static size_t serie_tam_codificado = CODEC_TAM_CAB_SERIE;
+static size_t serie_limite = SERIE_LIMITE_INICIAL;
+#endif
+
+/* Orçamento de airtime: definindo ORCAMENTO_AIRTIME_MS_HORA (ex.: 1250, os 30 s/dia do uso justo
+   do TTN) cada uplink desconta node.getLastToA() de um crédito que cresce pelo relógio do RTC.
+   Sem crédito para o próximo uplink o envio é adiado e as leituras seguem acumuladas (resumo,
+   série ou registro), sem perda. Com um envio por despertar (sem grade, série ou resumo) o
+   próximo alarme vem de espera_orcamento_airtime(), o tempo até o crédito que falta. O controle do
+   próprio RadioLib fica desligado: ele mede o tempo com millis(), parado durante o sono */
+#ifdef ORCAMENTO_AIRTIME_MS_HORA
+#if !defined(GRADE_PERIODO_MIN) && !defined(SERIE_LEITURAS) && SHT30_AMOSTRAS_POR_ENVIO == 1
+#define ORCAMENTO_AJUSTA_ALARME
+#endif
+/* Maior intervalo do alarme relativo (minuto e segundo do DS3231) */
+#define ORCAMENTO_ALARME_MAX_SEG 3599
+
+static OrcamentoAirtime orcamento_airtime;
+#endif
+
+/* Monitor de bateria: definindo BATERIA_GPIO (ex.: -D BATERIA_GPIO=29) cada ciclo de envio mede
+   VSYS pelo divisor nessa entrada do ADC, antes do TX, e informa o nível por
+   node.setDeviceStatus(), respondido no DevStatusAns quando o servidor pede DevStatusReq. O ADC e o
+   clk_adc (parado pelo sono) só ficam ligados durante as conversões. Com BATERIA_NO_PAYLOAD as
+   leituras avulsas vão na porta CODEC_PORTA_THB com a tensão em mV (0 se a medição falhar) */
+#ifdef BATERIA_GPIO
+static LeituraBateria bateria;
+#endif
+#if defined(BATERIA_NO_PAYLOAD) && !defined(BATERIA_GPIO)
+#error "BATERIA_NO_PAYLOAD requer BATERIA_GPIO"
+#endif
+
+/* Maior tempo acordado de um ciclo: o uplink do ciclo e até REGISTRO_LOTES_POR_CICLO lotes
+   confirmados, cada um com TX e as duas janelas de RX */
+#define SUPERVISOR_CICLO_MAX_MS 30000
+
 extern DS3231 rtc_ds3231;
 extern SensorSHT30 sht30;
-uint ctd = 0;
 
-/* Habilitando função de callback para tratar interrupções na GPIO */
-void gpio_callback(uint gpio, uint32_t events) {}
+/* Declarando gerenciador dos estados de energia do SX1276 (sleep entre ciclos e retomada sem
+   reset); com RADIO_PARTIDA_FRIA todo ciclo de envio refaz o radio.begin(), para comparação */
+static GerenciadorRadio gerenciador_radio(radio);
+
+/* Declarando gerenciador da sessão LoRaWAN persistida em flash */
+static SessaoLoRaWAN sessao_lorawan;
+static uint32_t fcnt_gravado = 0;
+
+/* Avanço do fCntUp ao restaurar a sessão. A gravação só ocorre no fim do ciclo, e um ciclo de
+   recuperação do registro faz até REGISTRO_LOTES_POR_CICLO uplinks: um reboot no meio dele pode
+   ter passado do intervalo de gravação */
+#ifdef REGISTRO_LEITURAS
+#define SESSAO_AVANCO_RESTAURACAO (SESSAO_INTERVALO_GRAVACAO + REGISTRO_LOTES_POR_CICLO)
+#else
+#define SESSAO_AVANCO_RESTAURACAO SESSAO_INTERVALO_GRAVACAO
+#endif
+
+/* Alarme do DS3231: o INT fica em nível baixo até A1F/A2F serem limpos no reagendamento,
+   então uma borda com a linha já de volta em nível alto foi ruído e não abre um ciclo */
+static bool trata_alarme_rtc(const EventoDespertar *evento) {
+  return !gpio_get(evento->origem);
+}
+
+/* O ciclo completo só roda com o alarme; o INT baixo sem evento na fila é uma borda perdida */
+static bool alarme_pendente(void) {
+  return (despacha_despertar() & DESPERTAR_BIT(DESPERTAR_ALARME_RTC)) || !gpio_get(WAKE_GPIO);
+}
+
+/* Declarando acumulador das amostras do SHT30 entre envios */
+static AcumuladorSHT30 acumulador_sht30;
 
 /* Declarando variáveis para salvar o estado atual dos clocks */
 static uint scb_orig;
@@ -111,8 +299,22 @@ void enter_low_power_sleep_until_interrupt(void) {
   uint save = scb_hw->scr;
   scb_hw->scr = save | M0PLUS_SCR_SLEEPDEEP_BITS;
 
-  /* Entrando em modo de baixo consumo até que ocorra uma interrupção */
-  __wfi();
+  /* Entrando em modo de baixo consumo até que ocorra uma interrupção. Despertares que não
+     exigem o ciclo (ruído no INT, IRQs de outros periféricos) são despachados ainda nos
+     clocks do sono e o núcleo volta direto ao __wfi(). Com as interrupções mascaradas entre
+     a verificação e o __wfi(), um evento que chegue no meio fica pendente e encerra o
+     __wfi() na hora, em vez de o núcleo dormir com o alarme já disparado */
+  uint32_t estado = save_and_disable_interrupts();
+  do {
+#ifdef SONO_DESLIGA_MEMORIAS
+    sleep_wfi_with_memories_powered_down(memorias_desligadas_no_sono());
+#else
+    __wfi();
+#endif
+    restore_interrupts(estado);
+    estado = save_and_disable_interrupts();
+  } while (!alarme_pendente());
+  restore_interrupts(estado);
 }
 
 /*
@@ -127,28 +329,349 @@ void recover_from_sleep(uint scb_orig, uint clock0_orig, uint clock1_orig) {
   scb_hw->scr = scb_orig;
   clocks_hw->sleep_en0 = clock0_orig;
   clocks_hw->sleep_en1 = clock1_orig;
+#ifdef CLOCK_DESPERTAR_PERFIS
+  aplica_perfil_clock(CLOCK_PERFIL_SENSOR, &perifericos_clock);
+#else
   clocks_init();
+#endif
 }
 
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  grava_sessao_lorawan
+*  Description:  Grava os buffers de nonces e sessão do RadioLib na flash. Fora do
+*                modo forçado, a gravação só ocorre a cada SESSAO_INTERVALO_GRAVACAO
+*                uplinks para poupar a flash e a energia de cada ciclo.
+* =====================================================================================
+*/
+void grava_sessao_lorawan(bool forcar) {
+  uint32_t fcnt = node.getFCntUp();
+  if (!forcar && (fcnt - fcnt_gravado) < SESSAO_INTERVALO_GRAVACAO) {
+    return;
+  }
+
+  if (salva_sessao_lorawan(&sessao_lorawan,
+                           node.getBufferNonces(), RADIOLIB_LORAWAN_NONCES_BUF_SIZE,
+                           node.getBufferSession(), RADIOLIB_LORAWAN_SESSION_BUF_SIZE)) {
+    fcnt_gravado = fcnt;
+  } else {
+    uart_puts(UART_ID, "Erro ao gravar sessao LoRaWAN!\n\r");
+    uart_default_tx_wait_blocking();
+  }
+}
+
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  ativa_sessao_lorawan
+*  Description:  Configura as credenciais ABP e restaura a sessão gravada na flash.
+*                Na ausência de uma sessão válida, cria uma nova. Executada apenas
+*                no boot, já que a RAM (e o objeto node) é mantida durante o sleep.
+* =====================================================================================
+*/
+void ativa_sessao_lorawan(void) {
+  /* O duty cycle do RadioLib conta o tempo pelo millis(), parado no sono (ver ORCAMENTO_AIRTIME_MS_HORA) */
+  node.setDutyCycle(false);
+  node.setDwellTime(false);
+  /* Configurando autenticação ABP no nó LoRa */
+  node.beginABP(devAddr, NULL, NULL, nwkSEncKey, appSKey);
+
+  /* Localizando o registro mais recente na flash */
+  inicializa_sessao_lorawan(&sessao_lorawan, &armazenamento_sessao_flash);
+
+  uint8_t nonces[RADIOLIB_LORAWAN_NONCES_BUF_SIZE];
+  uint8_t buf_sessao[RADIOLIB_LORAWAN_SESSION_BUF_SIZE];
+  bool restaurada =
+    restaura_sessao_lorawan(&sessao_lorawan, nonces, sizeof(nonces), buf_sessao, sizeof(buf_sessao)) &&
+    node.setBufferNonces(nonces) == RADIOLIB_ERR_NONE &&
+    node.setBufferSession(buf_sessao) == RADIOLIB_ERR_NONE;
+
+  if (!restaurada) {
+    /* Nonces aceitos com a sessão recusada (ex.: RADIOLIB_ERR_SESSION_DISCARDED) deixariam o nó
+       com os nonces ativos, e o activateABP() responderia SESSION_RESTORED sem criar a sessão */
+    node.clearSession();
+    node.beginABP(devAddr, NULL, NULL, nwkSEncKey, appSKey);
+  }
+
+  /* NEW_SESSION e SESSION_RESTORED são os códigos de sucesso, ambos negativos */
+  int state = node.activateABP(DR_SF7);
+  debug(state != RADIOLIB_LORAWAN_NEW_SESSION && state != RADIOLIB_LORAWAN_SESSION_RESTORED,
+        F("Activate ABP failed"), state, false);
+
+  if (restaurada) {
+    /* Avançando o contador além de qualquer uplink feito após a última gravação */
+    node.fCntUp += SESSAO_AVANCO_RESTAURACAO;
+    uart_puts(UART_ID, "Sessao LoRaWAN restaurada\n\r");
+  } else {
+    uart_puts(UART_ID, "Nova sessao LoRaWAN\n\r");
+  }
+  uart_default_tx_wait_blocking();
+
+  /* Gravando imediatamente para que um novo reboot não reutilize contadores */
+  grava_sessao_lorawan(true);
+}
+
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  coleta_sht30
+*  Description:  Coleta a leitura do SHT30 conforme o modo de aquisição configurado.
+*                No modo periódico a amostra já está pronta; se o sensor não
+*                responder, a aquisição periódica é rearmada para o próximo ciclo.
+* =====================================================================================
+*/
+bool coleta_sht30(void) {
+#ifdef SHT30_MODO_PERIODICO
+  if (sht30_fetch_periodic(&sht30) == SHT30_PRONTO) {
+    return true;
+  }
+  sht30_stop_periodic(&sht30);
+  sht30_start_periodic(&sht30, SHT30_MODO_PERIODICO, SHT30_REPETIBILIDADE);
+  return false;
+#else
+  /* Aguardando apenas o restante da conversão iniciada ao despertar */
+  return sht30_wait_fetch(&sht30);
+#endif
+}
+
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  envia_uplink
+*  Description:  Envia o uplink pelo nó LoRaWAN e desconta o seu tempo no ar do
+*                orçamento de airtime, quando habilitado.
+* =====================================================================================
+*/
+int envia_uplink(const uint8_t *payload, size_t tam, uint8_t porta, bool confirmado,
+                 LoRaWANEvent_t *evento_down) {
+  /* Cada uplink tem o seu prazo (lotes de recuperação fazem vários por ciclo) */
+  supervisor_fase(PERFIL_ENVIO, SUPERVISOR_PRAZO_ENVIO_MS);
+  int state = node.sendReceive(payload, tam, porta, confirmado, NULL, evento_down);
+#ifdef ORCAMENTO_AIRTIME_MS_HORA
+  if (state >= RADIOLIB_ERR_NONE) {
+    desconta_orcamento_airtime(&orcamento_airtime, node.getLastToA());
+  }
+#endif
+  return state;
+}
+
+#ifdef ORCAMENTO_AIRTIME_MS_HORA
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  orcamento_permite_envio
+*  Description:  Atualiza o crédito pelo relógio do RTC e informa se o próximo uplink
+*                cabe no orçamento. Sem leitura do RTC o envio não é adiado.
+* =====================================================================================
+*/
+bool orcamento_permite_envio(void) {
+  uint32_t agora;
+  if (!segundos_rtc(rtc_ds3231.i2c, &agora)) {
+    return true;
+  }
+  atualiza_orcamento_airtime(&orcamento_airtime, agora);
+  return falta_orcamento_airtime(&orcamento_airtime) == 0;
+}
+#endif
+
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  intervalo_proximo_ciclo
+*  Description:  Intervalo até o próximo despertar (alarme relativo), em segundos.
+*                Com um envio por despertar, o orçamento de airtime pode estendê-lo
+*                até o crédito cobrir o próximo uplink.
+* =====================================================================================
+*/
+uint32_t intervalo_proximo_ciclo(void) {
+#ifdef ORCAMENTO_AJUSTA_ALARME
+  uint32_t espera_seg = espera_orcamento_airtime(&orcamento_airtime);
+  if (espera_seg > ORCAMENTO_ALARME_MAX_SEG) return ORCAMENTO_ALARME_MAX_SEG;
+  if (espera_seg > INTERVALO_CICLO_SEG) return espera_seg;
+#endif
+  return INTERVALO_CICLO_SEG;
+}
+
+#ifdef REGISTRO_LEITURAS
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  envia_confirmado
+*  Description:  Envia o payload como uplink confirmado e informa se o servidor
+*                respondeu com o ACK (downlink confirmando o uplink em RX1/RX2).
+* =====================================================================================
+*/
+bool envia_confirmado(const uint8_t *payload, size_t tam, uint8_t porta, int *state) {
+  LoRaWANEvent_t evento_down;
+  *state = envia_uplink(payload, tam, porta, true, &evento_down);
+  return *state > 0 && evento_down.confirming;
+}
+
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  envia_lotes_pendentes
+*  Description:  Esvazia o registro em lotes confirmados, da leitura mais antiga para
+*                a mais recente. Cada ACK confirma as leituras do lote na flash; o
+*                primeiro lote sem ACK encerra as tentativas do ciclo.
+* =====================================================================================
+*/
+bool envia_lotes_pendentes(uint32_t agora, int *state) {
+  for (uint8_t lote = 0; lote < REGISTRO_LOTES_POR_CICLO && registro_leituras.pendentes; lote++) {
+    uint8_t payload[TAM_MAX_UPLINK];
+    size_t limite = node.getMaxPayloadLen();
+    if (limite > sizeof(payload)) limite = sizeof(payload);
+    size_t tam = 0;
+    uint32_t ultima = 0;
+
+    /* Concatenando as leituras pendentes enquanto couberem no lote */
+    uint32_t cursor = cursor_pendentes(&registro_leituras);
+    LeituraRegistrada leitura;
+    while (proxima_pendente(&registro_leituras, &cursor, &leitura)) {
+      uint32_t idade = (agora > leitura.segundos) ? agora - leitura.segundos : 0;
+      size_t n = codifica_item_lote(idade, leitura.porta, leitura.dados, &payload[tam], limite - tam);
+      if (n == 0 && codec_tamanho_esquema(leitura.porta) != 0) break;
+      tam += n;
+      ultima = leitura.sequencia;
+    }
+    if (ultima == 0) break;
+
+#ifdef ORCAMENTO_AIRTIME_MS_HORA
+    /* Os lotes seguintes esperam o crédito do orçamento */
+    if (lote > 0 && !orcamento_permite_envio()) break;
+#endif
+    if (tam > 0 && !envia_confirmado(payload, tam, CODEC_PORTA_LOTE, state)) {
+      return false;
+    }
+    if (!confirma_leituras(&registro_leituras, ultima)) {
+      return false;
+    }
+  }
+  return true;
+}
+#endif
+
+#ifdef SERIE_LEITURAS
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  recalcula_serie
+*  Description:  Recalcula o tamanho codificado das amostras guardadas (após remover
+*                as amostras mais antigas da série).
+* =====================================================================================
+*/
+void recalcula_serie(void) {
+  const AmostraSerie *anterior = NULL;
+  serie_tam_codificado = CODEC_TAM_CAB_SERIE;
+  for (uint8_t i = 0; i < serie_num_amostras; i++) {
+    serie_tam_codificado += tamanho_amostra_serie(anterior, &serie_amostras[i]);
+    if (serie_amostras[i].umidade != CODEC_AMOSTRA_AUSENTE) anterior = &serie_amostras[i];
+  }
+}
+
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  descarta_amostras_serie
+*  Description:  Remove da série as n amostras mais antigas.
+* =====================================================================================
+*/
+void descarta_amostras_serie(uint8_t n) {
+  serie_num_amostras -= n;
+  memmove(&serie_amostras[0], &serie_amostras[n], serie_num_amostras * sizeof(AmostraSerie));
+  recalcula_serie();
+}
+
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  acrescenta_amostra_serie
+*  Description:  Guarda a amostra do ciclo (NULL = leitura falhou). Com a série cheia
+*                (envios anteriores falharam) a amostra mais antiga é descartada.
+* =====================================================================================
+*/
+void acrescenta_amostra_serie(const LeituraEstacao *leitura) {
+  if (serie_num_amostras == SERIE_MAX_AMOSTRAS) {
+    descarta_amostras_serie(1);
+  }
+  AmostraSerie *amostra = &serie_amostras[serie_num_amostras++];
+  amostra_serie(leitura, amostra);
+
+  /* A diferença é tomada da última amostra presente */
+  const AmostraSerie *anterior = NULL;
+  for (uint8_t i = serie_num_amostras - 1; i > 0; i--) {
+    if (serie_amostras[i - 1].umidade != CODEC_AMOSTRA_AUSENTE) {
+      anterior = &serie_amostras[i - 1];
+      break;
+    }
+  }
+  serie_tam_codificado += tamanho_amostra_serie(anterior, amostra);
+}
+
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  serie_completa
+*  Description:  Indica se a série deve ser enviada neste ciclo: após a amostra do
+*                ciclo não haveria espaço garantido para mais uma no payload.
+* =====================================================================================
+*/
+bool serie_completa(void) {
+  return (serie_num_amostras + 1 >= SERIE_MAX_AMOSTRAS) ||
+         (serie_tam_codificado + 2 * CODEC_TAM_MAX_AMOSTRA_SERIE > serie_limite);
+}
+
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  envia_serie
+*  Description:  Codifica as amostras que couberem no maior payload do DR atual e
+*                envia a série. As amostras enviadas saem da RAM; em caso de erro a
+*                série é mantida para o próximo envio.
+* =====================================================================================
+*/
+int envia_serie(void) {
+  /* Limite do DR atual (o ADR pode tê-lo mudado no último downlink) */
+  serie_limite = node.getMaxPayloadLen();
+  if (serie_limite > TAM_MAX_UPLINK) serie_limite = TAM_MAX_UPLINK;
+
+  uint8_t payload[TAM_MAX_UPLINK];
+  size_t codificadas;
+  size_t tam = codifica_serie(serie_amostras, serie_num_amostras, INTERVALO_CICLO_SEG, 0,
+                              payload, serie_limite, &codificadas);
+  if (tam == 0) {
+    return RADIOLIB_ERR_NONE;
+  }
+
+  int state = envia_uplink(payload, tam, CODEC_PORTA_SERIE_TH, false, NULL);
+  if (state >= RADIOLIB_ERR_NONE) {
+    descarta_amostras_serie((uint8_t)codificadas);
+  }
+  return state;
+}
+#endif
+
 void setup() {
 
+  /* Registrando início do boot no perfil do ciclo */
+  PERFIL_MARCA(PERFIL_BOOT);
+
+  /* Armando o watchdog para o setup() e recuperando a fase de um travamento anterior
+     (uma falha na partida do rádio, que trava em debug(), passa a reiniciar o nó) */
+  inicializa_supervisor(SUPERVISOR_CICLO_MAX_MS);
+
   /* Inicializando UART */
   uart_init(UART_ID, BAUD_RATE);
   gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART); 
+  supervisor_informa_falha(UART_ID);
+
+#ifdef CLOCK_GOVERNADOR
+  /* Divisores de UART e I2C reajustados ao voltar das esperas do MAC */
+  hal_governador.usa_perifericos(&perifericos_clock);
+#endif
 
-  /* Iniciando comunicação SPI com o módulo de rádio LoRa */
-  RadioBeginSPI();
-  int state = radio.begin();
+  /* Iniciando comunicação SPI e o módulo de rádio LoRa (partida completa no boot) */
+  int state = gerenciador_radio.acorda();
 
   debug(state != RADIOLIB_ERR_NONE, F("Initialise radio failed"), state, true);
+  PERFIL_MARCA(PERFIL_RADIO);
   uart_puts(UART_ID, "Initialise LoRaWAN Network credentials\n\r");
   uart_default_tx_wait_blocking();
   
-  node.setDutyCycle(false);
-  node.setDwellTime(false);
-  /* Configurando autenticação ABP no nó LoRa */
-  node.beginABP(devAddr, NULL, NULL, nwkSEncKey, appSKey);
-  node.activateABP(DR_SF7);
+  /* Ativando sessão ABP (restaurada da flash quando disponível) */
+  ativa_sessao_lorawan();
+
+  /* Rádio em sleep até o primeiro envio */
+  gerenciador_radio.adormece();
+  PERFIL_MARCA(PERFIL_SESSAO);
 
   /* Definindo um buffer para armazenar a string formatada ADDR*/
   char buffer[10];
@@ -166,8 +689,28 @@ void setup() {
   /* Inicializando o módulo DS3231 com a instância I2C e os pinos definidos */
   inicializa_ds3231(&rtc_ds3231, i2c1, DS3231_I2C_ADDR, I2C_SDA_PIN, I2C_SCL_PIN);
 
+#ifdef ORCAMENTO_AIRTIME_MS_HORA
+  /* Iniciando o orçamento de airtime com o crédito de uma hora */
+  uint32_t agora = 0;
+  segundos_rtc(rtc_ds3231.i2c, &agora);
+  inicializa_orcamento_airtime(&orcamento_airtime, ORCAMENTO_AIRTIME_MS_HORA, agora);
+#endif
+
   /* Inicializando sensor SHT30 via barramento I2C */
   inicializa_sensor_sht30(&sht30, i2c1, 0x44, I2C_SDA_PIN, I2C_SCL_PIN);
+#ifdef SHT30_MODO_PERIODICO
+  /* Iniciando aquisição periódica: o sensor mede sozinho enquanto o MCU dorme */
+  sht30_start_periodic(&sht30, SHT30_MODO_PERIODICO, SHT30_REPETIBILIDADE);
+#endif
+  sht30_zera_acumulador(&acumulador_sht30);
+  PERFIL_MARCA(PERFIL_SENSOR);
+
+#ifdef REGISTRO_LEITURAS
+  /* Reconstruindo o registro a partir da flash; pendentes de antes do reboot vão em lotes */
+  inicializa_registro_leituras(&registro_leituras, &armazenamento_registro_flash);
+  recuperando_registro = (registro_leituras.pendentes > 0);
+  PERFIL_MARCA(PERFIL_SESSAO);
+#endif
 
   uart_init(UART_ID, BAUD_RATE);
   gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART); 
@@ -176,113 +719,261 @@ void setup() {
   gpio_init(WAKE_GPIO);
   gpio_set_dir(WAKE_GPIO, GPIO_IN);
   
-  /* Declarando variável para armazenar o conteúdo do registrador de status */
-  uint8_t stat;
-
-  /* Lendo o registrador de status (0x0F) para verificar flags ativas */
-  ds3231_read_reg(rtc_ds3231.i2c, DS3231_REG_STATUS, &stat);
-
-  if (stat & DS3231_STAT_A1F) {
-    /* Limpando a flag A1F (bit 0), necessária para permitir futuros alarmes */
-    stat &= ~DS3231_STAT_A1F;
-
-    /* Escrevendo de volta no registrador de status com a flag A1F zerada */
-    ds3231_write_reg(rtc_ds3231.i2c, DS3231_REG_STATUS, stat);
-  }
-
-  /* Agendando um novo alarme relativo */
-  agenda_alarme_em(rtc_ds3231.i2c, 0, 5);  // Alarme em 1 minuto e 30 segundos
+  /* Agendando o primeiro alarme; flags pendentes são limpas na mesma escrita */
+#ifdef GRADE_PERIODO_MIN
+  agenda_alarme_grade(rtc_ds3231.i2c, &grade_alarme);
+#else
+  agenda_alarme_em(rtc_ds3231.i2c, 0, INTERVALO_CICLO_SEG);
+#endif
 
-  /* Configurando interrupção na GPIO de wake-up para borda de descida */
-  gpio_set_irq_enabled_with_callback(
-    WAKE_GPIO,
-    GPIO_IRQ_EDGE_FALL,
-    true,
-    &gpio_callback
-  );
+  /* Registrando a GPIO de wake-up (borda de descida) no despachante dos despertares */
+  registra_fonte_despertar(WAKE_GPIO, GPIO_IRQ_EDGE_FALL, DESPERTAR_ALARME_RTC, NULL);
+  registra_tratador_despertar(DESPERTAR_ALARME_RTC, trata_alarme_rtc);
+  PERFIL_MARCA(PERFIL_RTC);
 
   uart_puts(UART_ID, "Sistema iniciado!!\n\r");
   uart_default_tx_wait_blocking();
+  PERFIL_MARCA(PERFIL_UART);
 }
   
 void loop() {
 
+  /* Encerrando o perfil do ciclo anterior (despejo periódico pela UART) */
+  PERFIL_ENCERRA_CICLO(UART_ID);
+
+#ifdef SONO_ROSC_KHZ
+  /* Configurando sistema para executar a partir do ROSC calibrado; a contagem de frequência
+     usa o XOSC como referência, então é feita antes da troca */
+  rosc_restore_calibration(SONO_ROSC_KHZ, SONO_ROSC_TOLERANCIA_KHZ);
+  sleep_run_from_rosc();
+#else
   /* Configurando sistema para executar a partir do cristal externo (XOSC) */
   sleep_run_from_xosc();
+#endif
   
-  /* Entrando em modo de baixo consumo até ocorrência de interrupção */
+  /* Entrando em modo de baixo consumo até ocorrência de interrupção; o watchdog só
+     fica desligado aqui, com o próximo alarme já agendado */
+  supervisor_dorme();
   enter_low_power_sleep_until_interrupt();
+  PERFIL_MARCA(PERFIL_DESPERTOU);
   
   /* Restaurando estado dos clocks após o modo Sleep */
+  supervisor_inicia_ciclo();
   recover_from_sleep(scb_orig, clock0_orig, clock1_orig);
-  
-  /* Iniciando comunicação SPI com o módulo de rádio LoRa */
-  RadioBeginSPI();
-  int state = radio.begin();
+  PERFIL_MARCA(PERFIL_CLOCKS);
 
-  debug(state != RADIOLIB_ERR_NONE, F("Initialise radio failed"), state, true);
-  uart_puts(UART_ID, "Initialise LoRaWAN Network credentials\n\r");
-  uart_default_tx_wait_blocking();
-  
-  node.setDutyCycle(false);
-  node.setDwellTime(false);
-  /* Configurando autenticação ABP no nó LoRa */
-  node.beginABP(devAddr, NULL, NULL, nwkSEncKey, appSKey);
-  node.activateABP(DR_SF7);
+  supervisor_fase(PERFIL_SENSOR, SUPERVISOR_PRAZO_SENSOR_MS);
+#ifndef SHT30_MODO_PERIODICO
+  /* Iniciando a conversão do SHT30 logo após o despertar; o resultado é coletado
+     mais adiante, depois das tarefas que não dependem dele */
+  sht30_start_measurement(&sht30, SHT30_REPETIBILIDADE);
+#endif
+
+  /* Reagendando o alarme antes do rádio e do sensor: se a flag estiver ativa, ela é
+     limpa e o próximo alarme agendado com uma leitura e uma escrita em bloco. Um reset
+     do watchdog no meio do ciclo já encontra o despertar garantido */
+  supervisor_fase(PERFIL_RTC, SUPERVISOR_PRAZO_RTC_MS);
+#ifdef GRADE_PERIODO_MIN
+  reagenda_grade_disparada(i2c1, &grade_alarme);
+#else
+  reagenda_alarme_disparado(i2c1, INTERVALO_CICLO_SEG / 60, INTERVALO_CICLO_SEG % 60);
+#endif
+  PERFIL_MARCA(PERFIL_RTC);
+
+  /* O rádio só é preparado nos ciclos em que o acumulador (ou a série) completará as amostras */
+#ifdef SERIE_LEITURAS
+  bool envia = serie_completa();
+#else
+  bool envia = (acumulador_sht30.amostras + 1 >= SHT30_AMOSTRAS_POR_ENVIO);
+#endif
+#ifdef ORCAMENTO_AIRTIME_MS_HORA
+  /* Adiando o envio sem crédito de airtime; a leitura do ciclo segue acumulada */
+  if (envia && !orcamento_permite_envio()) {
+    envia = false;
+    orcamento_airtime.adiados++;
+  }
+#endif
+  int state = RADIOLIB_ERR_NONE;
+
+  if (envia) {
+#ifdef CLOCK_DESPERTAR_PERFIS
+    /* Subindo clk_sys para o perfil do rádio (SPI e AES do MAC) */
+    aplica_perfil_clock(CLOCK_PERFIL_RADIO, &perifericos_clock);
+#endif
+    /* Retomando o rádio do sleep (ou partida completa, se ele perdeu a configuração) */
+    supervisor_fase(PERFIL_RADIO, SUPERVISOR_PRAZO_RADIO_MS);
+    state = gerenciador_radio.acorda();
+
+    debug(state != RADIOLIB_ERR_NONE, F("Initialise radio failed"), state, true);
+    PERFIL_MARCA(PERFIL_RADIO);
+
+    /* A sessão permanece na RAM durante o sleep; reativando apenas se foi perdida */
+    if (!node.isActivated()) {
+      supervisor_fase(PERFIL_SESSAO, SUPERVISOR_PRAZO_SESSAO_MS);
+      ativa_sessao_lorawan();
+      PERFIL_MARCA(PERFIL_SESSAO);
+    }
+
+#ifdef BATERIA_GPIO
+    /* Medindo a bateria em repouso, antes da queda de tensão do TX */
+    supervisor_fase(PERFIL_SENSOR, SUPERVISOR_PRAZO_SENSOR_MS);
+    mede_bateria(&bateria);
+    node.setDeviceStatus(bateria.nivel);
+    PERFIL_MARCA(PERFIL_SENSOR);
+#endif
+  }
   
   /* Reconfigurando UART e notificando início do envio LoRa */
+  supervisor_fase(PERFIL_UART, SUPERVISOR_PRAZO_UART_MS);
   uart_init(UART_ID, BAUD_RATE);
   gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART);
   uart_puts(UART_ID, "Entrando no modo operacao\n\r");
   uart_default_tx_wait_blocking();
+  PERFIL_MARCA(PERFIL_UART);
 
 
-  /* Lendo dados do sensor SHT30 (umidade e temperatura) */
-  if (!ler_sensor_sht30(&sht30)) {
-    /* Informando erro na leitura do sensor via UART */
-    uart_puts(UART_ID, "Erro ao ler sensor SHT30!\n\r");
-    uart_default_tx_wait_blocking();
-    return;
+  /* Coletando a medição do SHT30 */
+  supervisor_fase(PERFIL_SENSOR, SUPERVISOR_PRAZO_SENSOR_MS);
+  bool leitura_ok = coleta_sht30();
+  PERFIL_MARCA(PERFIL_SENSOR);
+
+  /* Mensagens pela UART e gravação do registro até o envio */
+  supervisor_fase(PERFIL_UART, SUPERVISOR_PRAZO_UART_MS);
+
+  if (leitura_ok) {
+    sht30_acumula(&acumulador_sht30, &sht30);
   }
 
-  /* Formatando mensagem com dados lidos (umidade, temperatura e precipitação) */
-  char message[100];
-  snprintf(message, sizeof(message),
-          "t|%.1f|h|%.1f",
-          sht30.temperatura, sht30.umidade);
+#ifdef SERIE_LEITURAS
+  /* Guardando a amostra (ou a ausência dela, para manter a contagem do tempo) */
+  LeituraEstacao leitura_serie = { sht30.temperatura, sht30.umidade, 0, 0 };
+  acrescenta_amostra_serie(leitura_ok ? &leitura_serie : NULL);
+  bool transmite = envia;
+#else
+  bool transmite = leitura_ok && envia;
+#endif
 
-  /* Enviando mensagem formatada via UART */
-  uart_puts(UART_ID, message);
-  uart_puts(UART_ID, "\n\r");
-  uart_default_tx_wait_blocking();
+  if (transmite) {
+    /* Formatando mensagem com dados lidos (umidade, temperatura e precipitação) */
+    char message[100];
+    snprintf(message, sizeof(message),
+            "t|%.1f|h|%.1f",
+            sht30.temperatura, sht30.umidade);
 
-  /* Copiando mensagem para o payload de uplink LoRa */
-  uint8_t uplinkPayload[100];
-  strncpy((char *)uplinkPayload, message, sizeof(uplinkPayload));
+    /* Enviando mensagem formatada via UART */
+    uart_puts(UART_ID, message);
+    uart_puts(UART_ID, "\n\r");
+    uart_default_tx_wait_blocking();
+    PERFIL_MARCA(PERFIL_UART);
+
+#ifdef SERIE_LEITURAS
+    /* Enviando as amostras acumuladas em um único uplink */
+    state = envia_serie();
+#else
+    /* Codificando leitura em binário (ponto fixo); o fPort identifica o esquema. Envios
+       adiados pelo orçamento de airtime também resumem as amostras acumuladas */
+    uint8_t porta;
+    uint8_t uplinkPayload[CODEC_TAM_RESUMO_TH];
+    size_t tam_payload;
+    if (SHT30_AMOSTRAS_POR_ENVIO > 1 || acumulador_sht30.amostras > 1) {
+      ResumoEstacao resumo = {
+        acumulador_sht30.temp_min, sht30_media_temperatura(&acumulador_sht30), acumulador_sht30.temp_max,
+        acumulador_sht30.umid_min, sht30_media_umidade(&acumulador_sht30), acumulador_sht30.umid_max,
+        (uint8_t)acumulador_sht30.amostras
+      };
+      porta = CODEC_PORTA_RESUMO_TH;
+      tam_payload = codifica_resumo(&resumo, uplinkPayload, sizeof(uplinkPayload));
+    } else {
+#ifdef BATERIA_NO_PAYLOAD
+      LeituraEstacao leitura = { sht30.temperatura, sht30.umidade, 0, bateria.tensao_mv };
+      porta = CODEC_PORTA_THB;
+#else
+      LeituraEstacao leitura = { sht30.temperatura, sht30.umidade, 0, 0 };
+      porta = CODEC_PORTA_TH;
+#endif
+      tam_payload = codifica_leitura(porta, &leitura, uplinkPayload, sizeof(uplinkPayload));
+    }
+    sht30_zera_acumulador(&acumulador_sht30);
+
+#ifdef REGISTRO_LEITURAS
+    /* Gravando a leitura no registro antes do envio, com o horário do RTC */
+    uint32_t agora = 0;
+    if (!segundos_rtc(rtc_ds3231.i2c, &agora) ||
+        !registra_leitura(&registro_leituras, agora, porta, uplinkPayload, tam_payload)) {
+      uart_puts(UART_ID, "Erro ao gravar leitura no registro!\n\r");
+      uart_default_tx_wait_blocking();
+    }
+    PERFIL_MARCA(PERFIL_SESSAO);
+
+    if (recuperando_registro) {
+      /* Enlace em recuperação: a leitura atual segue no lote junto das atrasadas */
+      recuperando_registro = !envia_lotes_pendentes(agora, &state) || registro_leituras.pendentes > 0;
+    } else if (registro_leituras.pendentes >= REGISTRO_CONFIRMA_A_CADA) {
+      /* Uplink confirmado: o ACK entrega todas as leituras pendentes até esta */
+      if (envia_confirmado(uplinkPayload, tam_payload, porta, &state)) {
+        confirma_leituras(&registro_leituras, registro_leituras.sequencia);
+      } else {
+        recuperando_registro = true;
+      }
+    } else {
+      state = envia_uplink(uplinkPayload, tam_payload, porta, false, NULL);
+      recuperando_registro = (state < RADIOLIB_ERR_NONE);
+    }
+#else
+    /* Enviando payload via LoRa e armazenando o estado da operação */
+    state = envia_uplink(uplinkPayload, tam_payload, porta, false, NULL);
+#endif
+#endif
+    debug(state < RADIOLIB_ERR_NONE, F("Error in SendReceiver"), state, false);
+    PERFIL_MARCA(PERFIL_ENVIO);
 
-  /* Enviando payload via LoRa e armazenando o estado da operação */
-  node.fCntUp = ctd;
-  state = node.sendReceive(uplinkPayload, strlen((char *)uplinkPayload));
-  debug(state < RADIOLIB_ERR_NONE, F("Error in SendReceiver"), state, false);
-  ctd++;
-  
-  /* Reagendando alarme */
-  uint8_t stat;
-  ds3231_read_reg(i2c1, DS3231_REG_STATUS, &stat);
-
-  if (stat & DS3231_STAT_A1F) {
-    /* Limpando a flag A1F para permitir que futuros eventos de alarme */
-    stat &= ~DS3231_STAT_A1F;
-    ds3231_write_reg(i2c1, DS3231_REG_STATUS, stat);
-
-    /* Agendando um novo alarme */
-    agenda_alarme_em(i2c1, 0, 5);
-    // uart_puts(UART_ID, ">> Alarme tratado e reagendado <<\n\r");
-    // uart_tx_wait_blocking(UART_ID);
+#ifdef CLOCK_GOVERNADOR
+    /* Rádio liberado: gravação da sessão e fim do ciclo no perfil do MAC */
+    aplica_perfil_clock(CLOCK_PERFIL_MAC, &perifericos_clock);
+#endif
+
+    /* Persistindo a sessão (contadores de quadro) periodicamente */
+    supervisor_fase(PERFIL_SESSAO, SUPERVISOR_PRAZO_SESSAO_MS);
+    grava_sessao_lorawan(false);
+    PERFIL_MARCA(PERFIL_SESSAO);
   }
 
+  if (envia) {
+    /* Rádio em sleep antes do MCU: o MAC o deixa em standby após as janelas de RX */
+    supervisor_fase(PERFIL_RADIO, SUPERVISOR_PRAZO_RADIO_MS);
+    gerenciador_radio.adormece();
+    PERFIL_MARCA(PERFIL_RADIO);
+  }
+
+  supervisor_fase(PERFIL_UART, SUPERVISOR_PRAZO_UART_MS);
+  if (!leitura_ok) {
+    /* Informando erro na leitura do sensor via UART; o alarme já foi reagendado */
+    uart_puts(UART_ID, "Erro ao ler sensor SHT30!\n\r");
+    uart_default_tx_wait_blocking();
+    PERFIL_MARCA(PERFIL_UART);
+  }
+
+  /* Conferindo o alarme no fim do ciclo: um ciclo com lotes e janelas de RX pode passar
+     do intervalo, e o INT já baixo não geraria outra borda (só uma leitura se ele não
+     disparou). Sem crédito de airtime o alarme é estendido até o próximo uplink caber */
+  supervisor_fase(PERFIL_RTC, SUPERVISOR_PRAZO_RTC_MS);
+#ifdef GRADE_PERIODO_MIN
+  reagenda_grade_disparada(i2c1, &grade_alarme);
+#else
+  uint32_t intervalo = intervalo_proximo_ciclo();
+  if (intervalo != INTERVALO_CICLO_SEG) {
+    agenda_alarme_em(i2c1, intervalo / 60, intervalo % 60);
+  } else {
+    reagenda_alarme_disparado(i2c1, intervalo / 60, intervalo % 60);
+  }
+#endif
+  PERFIL_MARCA(PERFIL_RTC);
+
+  supervisor_fase(PERFIL_UART, SUPERVISOR_PRAZO_UART_MS);
+
   uart_puts(UART_ID, ">> Entrando em sleep... <<\n\r");
   uart_tx_wait_blocking(UART_ID);
+  PERFIL_MARCA(PERFIL_UART);
 }
 
 
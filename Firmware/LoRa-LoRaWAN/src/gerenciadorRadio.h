@@ -0,0 +1,88 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  gerenciadorRadio.h
+ *
+ *    Description:  Estados de energia do SX1276 entre os ciclos: o rádio dorme junto
+ *                  com o MCU e, no despertar, é retomado sem reset quando os
+ *                  registradores de configuração continuam os mesmos.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 23:02:45
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#ifndef _GERENCIADOR_RADIO_H
+#define _GERENCIADOR_RADIO_H
+
+#include <RadioLib.h>
+#include <RadioBoards.h>
+
+/* Registradores conferidos na retomada: RegOpMode até RegOcp (modo, frequência, PA e OCP) */
+#define RADIO_REG_RETIDO_INICIO   RADIOLIB_SX127X_REG_OP_MODE
+#define RADIO_REG_RETIDO_FIM      RADIOLIB_SX127X_REG_OCP
+#define RADIO_NUM_REG_RETIDOS     (RADIO_REG_RETIDO_FIM - RADIO_REG_RETIDO_INICIO + 1)
+
+class GerenciadorRadio {
+  public:
+    explicit GerenciadorRadio(Radio &r) : radio(r), dormindo(false), partidas_frias(0), retomadas(0) {}
+
+    /* Prepara o rádio para o envio. Se ele dormiu com a configuração intacta (nenhum
+       reset ou queda de alimentação no meio), basta o SPI e a saída do sono: o
+       radio.begin() faria reset (6 ms de RST), procuraria o chip e regravaria tudo,
+       e o MAC ainda reconfigura canal, SF e potência a cada uplink */
+    int16_t acorda() {
+      RadioBeginSPI();
+#ifndef RADIO_PARTIDA_FRIA
+      if (dormindo && registros_retidos()) {
+        dormindo = false;
+        retomadas++;
+        return radio.standby();
+      }
+#endif
+      dormindo = false;
+      partidas_frias++;
+      return radio.begin();
+    }
+
+    /* Coloca o SX1276 em sleep (0,2 uA contra 1,6 mA do standby em que o MAC o deixa
+       após as janelas de RX) e guarda os registradores para conferir na retomada */
+    int16_t adormece() {
+      int16_t state = radio.sleep();
+      if (state == RADIOLIB_ERR_NONE) {
+        radio.getMod()->SPIreadRegisterBurst(RADIO_REG_RETIDO_INICIO, RADIO_NUM_REG_RETIDOS, retidos);
+        sync_word = radio.getMod()->SPIreadRegister(RADIOLIB_SX127X_REG_SYNC_WORD);
+        dormindo = true;
+      }
+      return state;
+    }
+
+    uint32_t total_partidas_frias() const { return partidas_frias; }
+    uint32_t total_retomadas() const { return retomadas; }
+
+  private:
+    /* Depois de um reset o SX1276 volta em FSK/standby (RegOpMode 0x09) com os valores
+       padrão, então o modo LoRa em sleep e a frequência gravada não coincidiriam */
+    bool registros_retidos() {
+      uint8_t atuais[RADIO_NUM_REG_RETIDOS];
+      radio.getMod()->SPIreadRegisterBurst(RADIO_REG_RETIDO_INICIO, RADIO_NUM_REG_RETIDOS, atuais);
+      if (memcmp(atuais, retidos, sizeof(atuais)) != 0) return false;
+      return radio.getMod()->SPIreadRegister(RADIOLIB_SX127X_REG_SYNC_WORD) == sync_word;
+    }
+
+    Radio &radio;
+    bool dormindo;
+    uint8_t retidos[RADIO_NUM_REG_RETIDOS];
+    uint8_t sync_word;
+    uint32_t partidas_frias;
+    uint32_t retomadas;
+};
+
+#endif
+/*****************************END OF FILE**************************************/
@@ -0,0 +1,60 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  halGovernador.h
+ *
+ *    Description:  HAL do RadioLib que baixa os clocks durante as esperas do MAC
+ *                  LoRaWAN (RX1/RX2 delay e janelas de recepção), voltando ao perfil
+ *                  anterior antes de o rádio ser acessado de novo.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 19:40:12
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#ifndef _HAL_GOVERNADOR_H
+#define _HAL_GOVERNADOR_H
+
+#include <RadioLib.h>
+#include "../lib/clock_despertar/clock_despertar.hpp"
+#include "../lib/perfil_ciclo/perfil_ciclo.hpp"
+
+/* Esperas mais curtas que isso não compensam as duas trocas de perfil (PLL + tensão) */
+#ifndef GOVERNADOR_ESPERA_MIN_MS
+#define GOVERNADOR_ESPERA_MIN_MS 10
+#endif
+
+class HalGovernador : public ArduinoHal {
+  public:
+    explicit HalGovernador(SPIClass& spi) : ArduinoHal(spi), perifericos(NULL) {}
+
+    /* Periféricos reajustados ao voltar para o perfil anterior */
+    void usa_perifericos(const PerifericosClock *p) { perifericos = p; }
+
+    /* Durante a espera só o timer (clk_ref no XOSC) e o SX1276 trabalham: o MCU fica no
+       perfil do sensor. O SPI não é usado na espera e volta com o mesmo clk_peri */
+    void delay(RadioLibTime_t ms) override {
+      PerfilClock anterior = perfil_clock_atual();
+      if (ms < GOVERNADOR_ESPERA_MIN_MS || anterior == CLOCK_PERFIL_SENSOR) {
+        ::delay(ms);
+        return;
+      }
+      PERFIL_MARCA(PERFIL_ENVIO);
+      aplica_perfil_clock(CLOCK_PERFIL_SENSOR, NULL);
+      ::delay(ms);
+      PERFIL_MARCA(PERFIL_ESPERA);
+      aplica_perfil_clock(anterior, perifericos);
+    }
+
+  private:
+    const PerifericosClock *perifericos;
+};
+
+#endif
+/*****************************END OF FILE**************************************/
@@ -55,7 +55,12 @@ void setup() {
   debug(state != RADIOLIB_ERR_NONE, F("Initialise radio failed"), state, true);
   // Serial.println(F("Initialise LoRaWAN Network credentials"));
   // uart_puts(UART_ID, "Initialise LoRaWAN Network credentials\n\r");
+#ifdef ORCAMENTO_AIRTIME_MS_HORA
+  // Awake the whole time, millis() keeps running and RadioLib itself enforces the budget
+  node.setDutyCycle(true, ORCAMENTO_AIRTIME_MS_HORA);
+#else
   node.setDutyCycle(false);
+#endif
   node.setDwellTime(false);
   node.beginABP(devAddr, NULL, NULL, nwkSEncKey, appSKey);
   node.activateABP(DR_SF9);
@@ -89,7 +94,12 @@ void loop() {
   // Serial.println(F(" seconds\n"));
   
   // Wait until next uplink - observing legal & TTN FUP constraints
+#ifdef ORCAMENTO_AIRTIME_MS_HORA
+  RadioLibTime_t espera = node.timeUntilUplink();
+  delay(espera > uplinkIntervalSeconds * 1000UL ? espera : uplinkIntervalSeconds * 1000UL);
+#else
   delay(uplinkIntervalSeconds * 1000UL);  // delay needs milli-seconds
+#endif
 }
 
 #endif
@@ -0,0 +1,375 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  test_main.cpp
+ *
+ *    Description:  Testes de ida e volta do codec de uplink em cada porta (1 a 6),
+ *                  com arredondamento e saturação nos limites dos campos.
+ *                  Uso: pio test -e native
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 23:59:59
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include <unity.h>
+#include "../../lib/codec_uplink/codec_uplink.hpp"
+
+/* Meia resolução dos campos: o erro máximo de uma ida e volta */
+#define TOL_TEMPERATURA   (0.5f / CODEC_ESCALA_TEMPERATURA)
+#define TOL_UMIDADE       (0.5f / CODEC_ESCALA_UMIDADE)
+
+void setUp(void) {}
+void tearDown(void) {}
+
+
+/* ============================================================================
+ *  Portas 1, 2 e 6 (leitura avulsa)
+ * ============================================================================
+*/
+
+void test_porta_th_ida_e_volta(void) {
+    LeituraEstacao leitura = { 21.37f, 55.5f, 0, 0 };
+    uint8_t buf[CODEC_TAM_TH];
+    TEST_ASSERT_EQUAL_size_t(CODEC_TAM_TH, codifica_leitura(CODEC_PORTA_TH, &leitura, buf, sizeof(buf)));
+
+    const uint8_t esperado[] = { 0x08, 0x59, 0x6F };   /* 2137 e 111 */
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(esperado, buf, sizeof(esperado));
+
+    LeituraEstacao lida;
+    TEST_ASSERT_TRUE(decodifica_leitura(CODEC_PORTA_TH, buf, sizeof(buf), &lida));
+    TEST_ASSERT_FLOAT_WITHIN(TOL_TEMPERATURA, 21.37f, lida.temperatura);
+    TEST_ASSERT_FLOAT_WITHIN(TOL_UMIDADE, 55.5f, lida.umidade);
+    TEST_ASSERT_EQUAL_UINT16(0, lida.tombos_chuva);
+    TEST_ASSERT_EQUAL_UINT16(0, lida.bateria_mv);
+}
+
+void test_porta_th_temperatura_negativa(void) {
+    LeituraEstacao leitura = { -12.34f, 0.0f, 0, 0 };
+    uint8_t buf[CODEC_TAM_TH];
+    codifica_leitura(CODEC_PORTA_TH, &leitura, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_HEX8(0xFB, buf[0]);   /* -1234 em complemento de dois */
+    TEST_ASSERT_EQUAL_HEX8(0x2E, buf[1]);
+
+    LeituraEstacao lida;
+    decodifica_leitura(CODEC_PORTA_TH, buf, sizeof(buf), &lida);
+    TEST_ASSERT_FLOAT_WITHIN(TOL_TEMPERATURA, -12.34f, lida.temperatura);
+}
+
+void test_porta_th_arredondamento(void) {
+    uint8_t buf[CODEC_TAM_TH];
+    LeituraEstacao leitura = { 20.004f, 50.2f, 0, 0 };
+    codifica_leitura(CODEC_PORTA_TH, &leitura, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT16(2000, (int16_t)((buf[0] << 8) | buf[1]));
+    TEST_ASSERT_EQUAL_UINT8(100, buf[2]);
+
+    leitura = { 20.006f, 50.3f, 0, 0 };
+    codifica_leitura(CODEC_PORTA_TH, &leitura, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT16(2001, (int16_t)((buf[0] << 8) | buf[1]));
+    TEST_ASSERT_EQUAL_UINT8(101, buf[2]);
+
+    /* Negativos arredondam para longe do zero, como os positivos */
+    leitura = { -20.006f, 0.0f, 0, 0 };
+    codifica_leitura(CODEC_PORTA_TH, &leitura, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT16(-2001, (int16_t)((buf[0] << 8) | buf[1]));
+}
+
+void test_porta_th_saturacao(void) {
+    uint8_t buf[CODEC_TAM_TH];
+    LeituraEstacao leitura = { 400.0f, 120.0f, 0, 0 };
+    codifica_leitura(CODEC_PORTA_TH, &leitura, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_HEX8(0x7F, buf[0]);   /* INT16_MAX */
+    TEST_ASSERT_EQUAL_HEX8(0xFF, buf[1]);
+    TEST_ASSERT_EQUAL_UINT8(100 * CODEC_ESCALA_UMIDADE, buf[2]);
+
+    leitura = { -400.0f, -3.0f, 0, 0 };
+    codifica_leitura(CODEC_PORTA_TH, &leitura, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_HEX8(0x80, buf[0]);   /* INT16_MIN */
+    TEST_ASSERT_EQUAL_HEX8(0x00, buf[1]);
+    TEST_ASSERT_EQUAL_UINT8(0, buf[2]);
+
+    LeituraEstacao lida;
+    decodifica_leitura(CODEC_PORTA_TH, buf, sizeof(buf), &lida);
+    TEST_ASSERT_FLOAT_WITHIN(TOL_TEMPERATURA, -327.68f, lida.temperatura);
+    TEST_ASSERT_FLOAT_WITHIN(TOL_UMIDADE, 0.0f, lida.umidade);
+}
+
+void test_porta_thr_ida_e_volta(void) {
+    LeituraEstacao leitura = { 25.0f, 80.0f, 0xFFFF, 0 };
+    uint8_t buf[CODEC_TAM_THR];
+    TEST_ASSERT_EQUAL_size_t(CODEC_TAM_THR, codifica_leitura(CODEC_PORTA_THR, &leitura, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, buf[3]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, buf[4]);
+
+    LeituraEstacao lida;
+    TEST_ASSERT_TRUE(decodifica_leitura(CODEC_PORTA_THR, buf, sizeof(buf), &lida));
+    TEST_ASSERT_FLOAT_WITHIN(TOL_TEMPERATURA, 25.0f, lida.temperatura);
+    TEST_ASSERT_FLOAT_WITHIN(TOL_UMIDADE, 80.0f, lida.umidade);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, lida.tombos_chuva);
+}
+
+void test_porta_thb_ida_e_volta(void) {
+    LeituraEstacao leitura = { 21.37f, 55.5f, 0, 3712 };
+    uint8_t buf[CODEC_TAM_THB];
+    TEST_ASSERT_EQUAL_size_t(CODEC_TAM_THB, codifica_leitura(CODEC_PORTA_THB, &leitura, buf, sizeof(buf)));
+
+    const uint8_t esperado[] = { 0x08, 0x59, 0x6F, 0x0E, 0x80 };
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(esperado, buf, sizeof(esperado));
+
+    LeituraEstacao lida;
+    TEST_ASSERT_TRUE(decodifica_leitura(CODEC_PORTA_THB, buf, sizeof(buf), &lida));
+    TEST_ASSERT_EQUAL_UINT16(3712, lida.bateria_mv);
+    TEST_ASSERT_EQUAL_UINT16(0, lida.tombos_chuva);
+
+    /* Limites do campo: medição falha (0) e valor máximo */
+    leitura.bateria_mv = 0xFFFF;
+    codifica_leitura(CODEC_PORTA_THB, &leitura, buf, sizeof(buf));
+    decodifica_leitura(CODEC_PORTA_THB, buf, sizeof(buf), &lida);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, lida.bateria_mv);
+}
+
+void test_leitura_tamanho_e_porta_invalidos(void) {
+    LeituraEstacao leitura = { 1.0f, 1.0f, 1, 1 };
+    uint8_t buf[CODEC_TAM_THR];
+
+    /* Buffer pequeno ou porta sem esquema de leitura avulsa */
+    TEST_ASSERT_EQUAL_size_t(0, codifica_leitura(CODEC_PORTA_THR, &leitura, buf, CODEC_TAM_THR - 1));
+    TEST_ASSERT_EQUAL_size_t(0, codifica_leitura(CODEC_PORTA_RESUMO_TH, &leitura, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_size_t(0, codifica_leitura(7, &leitura, buf, sizeof(buf)));
+
+    /* Tamanho diferente do esquema */
+    LeituraEstacao lida;
+    TEST_ASSERT_FALSE(decodifica_leitura(CODEC_PORTA_TH, buf, CODEC_TAM_THR, &lida));
+    TEST_ASSERT_FALSE(decodifica_leitura(CODEC_PORTA_THR, buf, CODEC_TAM_TH, &lida));
+    TEST_ASSERT_FALSE(decodifica_leitura(CODEC_PORTA_THB, buf, CODEC_TAM_TH, &lida));
+    TEST_ASSERT_FALSE(decodifica_leitura(CODEC_PORTA_LOTE, buf, CODEC_TAM_TH, &lida));
+}
+
+
+/* ============================================================================
+ *  Porta 3 (resumo)
+ * ============================================================================
+*/
+
+void test_porta_resumo_ida_e_volta(void) {
+    ResumoEstacao resumo = { -5.25f, 10.5f, 30.75f, 20.0f, 45.5f, 99.5f, 12 };
+    uint8_t buf[CODEC_TAM_RESUMO_TH];
+    TEST_ASSERT_EQUAL_size_t(CODEC_TAM_RESUMO_TH, codifica_resumo(&resumo, buf, sizeof(buf)));
+
+    ResumoEstacao lido;
+    TEST_ASSERT_TRUE(decodifica_resumo(buf, sizeof(buf), &lido));
+    TEST_ASSERT_FLOAT_WITHIN(TOL_TEMPERATURA, -5.25f, lido.temp_min);
+    TEST_ASSERT_FLOAT_WITHIN(TOL_TEMPERATURA, 10.5f, lido.temp_media);
+    TEST_ASSERT_FLOAT_WITHIN(TOL_TEMPERATURA, 30.75f, lido.temp_max);
+    TEST_ASSERT_FLOAT_WITHIN(TOL_UMIDADE, 20.0f, lido.umid_min);
+    TEST_ASSERT_FLOAT_WITHIN(TOL_UMIDADE, 45.5f, lido.umid_media);
+    TEST_ASSERT_FLOAT_WITHIN(TOL_UMIDADE, 99.5f, lido.umid_max);
+    TEST_ASSERT_EQUAL_UINT8(12, lido.amostras);
+}
+
+void test_porta_resumo_saturacao(void) {
+    ResumoEstacao resumo = { -400.0f, 0.0f, 400.0f, -1.0f, 50.0f, 101.0f, 255 };
+    uint8_t buf[CODEC_TAM_RESUMO_TH];
+    codifica_resumo(&resumo, buf, sizeof(buf));
+
+    ResumoEstacao lido;
+    decodifica_resumo(buf, sizeof(buf), &lido);
+    TEST_ASSERT_FLOAT_WITHIN(TOL_TEMPERATURA, -327.68f, lido.temp_min);
+    TEST_ASSERT_FLOAT_WITHIN(TOL_TEMPERATURA, 327.67f, lido.temp_max);
+    TEST_ASSERT_FLOAT_WITHIN(TOL_UMIDADE, 0.0f, lido.umid_min);
+    TEST_ASSERT_FLOAT_WITHIN(TOL_UMIDADE, 100.0f, lido.umid_max);
+
+    TEST_ASSERT_EQUAL_size_t(0, codifica_resumo(&resumo, buf, CODEC_TAM_RESUMO_TH - 1));
+    TEST_ASSERT_FALSE(decodifica_resumo(buf, CODEC_TAM_RESUMO_TH - 1, &lido));
+}
+
+
+/* ============================================================================
+ *  Porta 4 (lote de leituras atrasadas)
+ * ============================================================================
+*/
+
+void test_porta_lote_ida_e_volta(void) {
+    uint8_t th[CODEC_TAM_TH], thb[CODEC_TAM_THB];
+    LeituraEstacao leitura = { 18.5f, 70.0f, 0, 4100 };
+    codifica_leitura(CODEC_PORTA_TH, &leitura, th, sizeof(th));
+    codifica_leitura(CODEC_PORTA_THB, &leitura, thb, sizeof(thb));
+
+    uint8_t lote[32];
+    size_t tam = codifica_item_lote(300, CODEC_PORTA_TH, th, lote, sizeof(lote));
+    TEST_ASSERT_EQUAL_size_t(CODEC_TAM_CAB_ITEM_LOTE + CODEC_TAM_TH, tam);
+    /* Idade acima do campo de 24 bits fica saturada */
+    tam += codifica_item_lote(0x01000000UL, CODEC_PORTA_THB, thb, &lote[tam], sizeof(lote) - tam);
+    TEST_ASSERT_EQUAL_size_t(2 * CODEC_TAM_CAB_ITEM_LOTE + CODEC_TAM_TH + CODEC_TAM_THB, tam);
+
+    uint32_t idade;
+    uint8_t porta;
+    const uint8_t *payload;
+    size_t pos = decodifica_item_lote(lote, tam, &idade, &porta, &payload);
+    TEST_ASSERT_EQUAL_size_t(CODEC_TAM_CAB_ITEM_LOTE + CODEC_TAM_TH, pos);
+    TEST_ASSERT_EQUAL_UINT32(300, idade);
+    TEST_ASSERT_EQUAL_UINT8(CODEC_PORTA_TH, porta);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(th, payload, CODEC_TAM_TH);
+
+    TEST_ASSERT_EQUAL_size_t(CODEC_TAM_CAB_ITEM_LOTE + CODEC_TAM_THB,
+                             decodifica_item_lote(&lote[pos], tam - pos, &idade, &porta, &payload));
+    TEST_ASSERT_EQUAL_UINT32(CODEC_IDADE_MAX_LOTE, idade);
+    TEST_ASSERT_EQUAL_UINT8(CODEC_PORTA_THB, porta);
+
+    LeituraEstacao lida;
+    TEST_ASSERT_TRUE(decodifica_leitura(porta, payload, codec_tamanho_esquema(porta), &lida));
+    TEST_ASSERT_EQUAL_UINT16(4100, lida.bateria_mv);
+}
+
+void test_porta_lote_invalidos(void) {
+    uint8_t th[CODEC_TAM_TH] = { 0 };
+    uint8_t lote[16];
+
+    /* Sem espaço para o item inteiro, ou porta sem tamanho conhecido (o lote não se aninha) */
+    TEST_ASSERT_EQUAL_size_t(0, codifica_item_lote(1, CODEC_PORTA_TH, th, lote, CODEC_TAM_CAB_ITEM_LOTE + CODEC_TAM_TH - 1));
+    TEST_ASSERT_EQUAL_size_t(0, codifica_item_lote(1, CODEC_PORTA_LOTE, th, lote, sizeof(lote)));
+    TEST_ASSERT_EQUAL_size_t(0, codifica_item_lote(1, CODEC_PORTA_SERIE_TH, th, lote, sizeof(lote)));
+
+    /* Item truncado */
+    size_t tam = codifica_item_lote(1, CODEC_PORTA_TH, th, lote, sizeof(lote));
+    uint32_t idade;
+    uint8_t porta;
+    const uint8_t *payload;
+    TEST_ASSERT_EQUAL_size_t(0, decodifica_item_lote(lote, tam - 1, &idade, &porta, &payload));
+}
+
+
+/* ============================================================================
+ *  Porta 5 (série em delta + varint)
+ * ============================================================================
+*/
+
+void test_porta_serie_ida_e_volta(void) {
+    /* Variações pequenas, uma amostra ausente e um salto que ocupa varints de 2 e 3 bytes */
+    LeituraEstacao leituras[] = {
+        { 21.00f, 50.0f, 0, 0 }, { 21.05f, 50.5f, 0, 0 }, { 0, 0, 0, 0 },
+        { 20.90f, 49.0f, 0, 0 }, { -300.0f, 100.0f, 0, 0 }, { 300.0f, 0.0f, 0, 0 },
+    };
+    const size_t n = sizeof(leituras) / sizeof(leituras[0]);
+    AmostraSerie amostras[6];
+    for (size_t i = 0; i < n; i++) {
+        amostra_serie((i == 2) ? NULL : &leituras[i], &amostras[i]);
+    }
+
+    uint8_t buf[64];
+    size_t codificadas;
+    size_t tam = codifica_serie(amostras, n, 300, 1, buf, sizeof(buf), &codificadas);
+    TEST_ASSERT_EQUAL_size_t(n, codificadas);
+
+    /* O tamanho do payload é a soma calculada amostra a amostra */
+    size_t esperado = CODEC_TAM_CAB_SERIE;
+    const AmostraSerie *anterior = NULL;
+    for (size_t i = 0; i < n; i++) {
+        esperado += tamanho_amostra_serie(anterior, &amostras[i]);
+        if (amostras[i].umidade != CODEC_AMOSTRA_AUSENTE) anterior = &amostras[i];
+    }
+    TEST_ASSERT_EQUAL_size_t(esperado, tam);
+
+    uint32_t intervalo;
+    uint8_t atraso;
+    AmostraSerie lidas[6];
+    TEST_ASSERT_EQUAL_size_t(n, decodifica_serie(buf, tam, &intervalo, &atraso, lidas, 6));
+    TEST_ASSERT_EQUAL_UINT32(300, intervalo);
+    TEST_ASSERT_EQUAL_UINT8(1, atraso);
+    for (size_t i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL_INT16(amostras[i].temperatura, lidas[i].temperatura);
+        TEST_ASSERT_EQUAL_UINT8(amostras[i].umidade, lidas[i].umidade);
+    }
+    TEST_ASSERT_EQUAL_UINT8(CODEC_AMOSTRA_AUSENTE, lidas[2].umidade);
+    TEST_ASSERT_EQUAL_INT16(-30000, lidas[4].temperatura);
+    TEST_ASSERT_EQUAL_INT16(30000, lidas[5].temperatura);
+}
+
+void test_porta_serie_buffer_cheio(void) {
+    LeituraEstacao leitura = { 22.0f, 60.0f, 0, 0 };
+    AmostraSerie amostras[10];
+    for (size_t i = 0; i < 10; i++) {
+        leitura.temperatura += 0.01f;
+        amostra_serie(&leitura, &amostras[i]);
+    }
+
+    /* Primeira amostra: 2 bytes de temperatura + 2 de umidade; as demais, 1 + 1 */
+    uint8_t buf[CODEC_TAM_CAB_SERIE + 4 + 2 * 3 + 1];
+    size_t codificadas;
+    size_t tam = codifica_serie(amostras, 10, 60, 0, buf, sizeof(buf), &codificadas);
+    TEST_ASSERT_EQUAL_size_t(4, codificadas);
+    TEST_ASSERT_EQUAL_size_t(sizeof(buf) - 1, tam);
+    /* As 6 amostras que ficaram de fora aumentam o atraso */
+    TEST_ASSERT_EQUAL_UINT8(6, buf[4]);
+
+    /* Intervalo saturado em 24 bits */
+    codifica_serie(amostras, 1, 0x01000000UL, 0, buf, sizeof(buf), &codificadas);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, buf[1]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, buf[2]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, buf[3]);
+
+    /* Nem a primeira amostra cabe */
+    TEST_ASSERT_EQUAL_size_t(0, codifica_serie(amostras, 10, 60, 0, buf, CODEC_TAM_CAB_SERIE + 1, &codificadas));
+    TEST_ASSERT_EQUAL_size_t(0, codificadas);
+}
+
+void test_porta_serie_invalidos(void) {
+    LeituraEstacao leitura = { 22.0f, 60.0f, 0, 0 };
+    AmostraSerie amostras[2];
+    amostra_serie(&leitura, &amostras[0]);
+    amostra_serie(&leitura, &amostras[1]);
+
+    uint8_t buf[16];
+    size_t codificadas;
+    size_t tam = codifica_serie(amostras, 2, 60, 0, buf, sizeof(buf), &codificadas);
+
+    uint32_t intervalo;
+    uint8_t atraso;
+    AmostraSerie lidas[2];
+    /* Truncado, com byte sobrando ou com mais amostras que o vetor de saída */
+    TEST_ASSERT_EQUAL_size_t(0, decodifica_serie(buf, tam - 1, &intervalo, &atraso, lidas, 2));
+    buf[tam] = 0;
+    TEST_ASSERT_EQUAL_size_t(0, decodifica_serie(buf, tam + 1, &intervalo, &atraso, lidas, 2));
+    TEST_ASSERT_EQUAL_size_t(0, decodifica_serie(buf, tam, &intervalo, &atraso, lidas, 1));
+}
+
+void test_tamanho_dos_esquemas(void) {
+    TEST_ASSERT_EQUAL_size_t(CODEC_TAM_TH, codec_tamanho_esquema(CODEC_PORTA_TH));
+    TEST_ASSERT_EQUAL_size_t(CODEC_TAM_THR, codec_tamanho_esquema(CODEC_PORTA_THR));
+    TEST_ASSERT_EQUAL_size_t(CODEC_TAM_RESUMO_TH, codec_tamanho_esquema(CODEC_PORTA_RESUMO_TH));
+    TEST_ASSERT_EQUAL_size_t(CODEC_TAM_THB, codec_tamanho_esquema(CODEC_PORTA_THB));
+    /* Lote e série têm tamanho variável */
+    TEST_ASSERT_EQUAL_size_t(0, codec_tamanho_esquema(CODEC_PORTA_LOTE));
+    TEST_ASSERT_EQUAL_size_t(0, codec_tamanho_esquema(CODEC_PORTA_SERIE_TH));
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_porta_th_ida_e_volta);
+    RUN_TEST(test_porta_th_temperatura_negativa);
+    RUN_TEST(test_porta_th_arredondamento);
+    RUN_TEST(test_porta_th_saturacao);
+    RUN_TEST(test_porta_thr_ida_e_volta);
+    RUN_TEST(test_porta_thb_ida_e_volta);
+    RUN_TEST(test_leitura_tamanho_e_porta_invalidos);
+    RUN_TEST(test_porta_resumo_ida_e_volta);
+    RUN_TEST(test_porta_resumo_saturacao);
+    RUN_TEST(test_porta_lote_ida_e_volta);
+    RUN_TEST(test_porta_lote_invalidos);
+    RUN_TEST(test_porta_serie_ida_e_volta);
+    RUN_TEST(test_porta_serie_buffer_cheio);
+    RUN_TEST(test_porta_serie_invalidos);
+    RUN_TEST(test_tamanho_dos_esquemas);
+    return UNITY_END();
+}
+
+/*****************************END OF FILE**************************************/
@@ -0,0 +1,250 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  test_main.cpp
+ *
+ *    Description:  Testes do registro circular de leituras no meio em RAM (dublê
+ *                  da flash): ordem da iteração, descarte na volta, confirmação,
+ *                  resíduo de gravação interrompida e reconstrução no boot.
+ *                  Uso: pio test -e native
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 23:59:59
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include <unity.h>
+#include <string.h>
+#include "../../lib/registro_leituras/registro_leituras.hpp"
+
+#define NUM_SETORES      (REGISTRO_SETORES_RAM)
+#define CAPACIDADE       (NUM_SETORES * REGISTRO_POR_SETOR)
+
+/* Carimbo da leitura n: identifica a gravação mesmo quando a sequência não coincide */
+#define SEGUNDOS_BASE    1000
+
+static const ArmazenamentoRegistro *meio = &armazenamento_registro_ram;
+static RegistroLeituras registro;
+
+/* Payload derivado da gravação n, com tamanho e porta variando entre as leituras */
+static uint8_t preenche(uint8_t *dados, uint32_t n) {
+    uint8_t tam = (uint8_t)(n % REGISTRO_TAM_DADOS + 1);
+    for (uint8_t i = 0; i < tam; i++) dados[i] = (uint8_t)(n * 7 + i);
+    return tam;
+}
+
+static void grava(uint32_t n) {
+    uint8_t dados[REGISTRO_TAM_DADOS];
+    uint8_t tam = preenche(dados, n);
+    TEST_ASSERT_TRUE(registra_leitura(&registro, SEGUNDOS_BASE + n, (uint8_t)(1 + n % 6), dados, tam));
+}
+
+static void confere_leitura(const LeituraRegistrada *leitura, uint32_t n) {
+    uint8_t dados[REGISTRO_TAM_DADOS];
+    uint8_t tam = preenche(dados, n);
+    TEST_ASSERT_EQUAL_UINT32(SEGUNDOS_BASE + n, leitura->segundos);
+    TEST_ASSERT_EQUAL_UINT8(1 + n % 6, leitura->porta);
+    TEST_ASSERT_EQUAL_UINT8(tam, leitura->tam);
+    TEST_ASSERT_EQUAL_MEMORY(dados, leitura->dados, tam);
+}
+
+/* Confere que as pendentes são exatamente as gravações primeira..ultima, da mais antiga para a mais recente */
+static void confere_pendentes(uint32_t primeira, uint32_t ultima) {
+    uint32_t cursor = cursor_pendentes(&registro);
+    LeituraRegistrada leitura;
+    for (uint32_t n = primeira; n <= ultima; n++) {
+        TEST_ASSERT_TRUE(proxima_pendente(&registro, &cursor, &leitura));
+        confere_leitura(&leitura, n);
+    }
+    TEST_ASSERT_FALSE(proxima_pendente(&registro, &cursor, &leitura));
+    TEST_ASSERT_EQUAL_UINT32(ultima - primeira + 1, registro.pendentes);
+}
+
+/* Sequências das pendentes, na ordem da iteração */
+static uint32_t lista_pendentes(uint32_t *sequencias, uint32_t max) {
+    uint32_t cursor = cursor_pendentes(&registro);
+    uint32_t n = 0;
+    LeituraRegistrada leitura;
+    while (n < max && proxima_pendente(&registro, &cursor, &leitura)) {
+        sequencias[n++] = leitura.sequencia;
+    }
+    return n;
+}
+
+void setUp(void) {
+    /* Cada teste parte da região apagada, como em um nó recém-gravado */
+    for (uint32_t setor = 0; setor < NUM_SETORES; setor++) {
+        TEST_ASSERT_TRUE(meio->apaga_setor(setor * REGISTRO_TAMANHO_SETOR));
+    }
+    inicializa_registro_leituras(&registro, meio);
+}
+
+void tearDown(void) {}
+
+
+/* ============================================================================
+ *  Casos de teste
+ * ============================================================================
+*/
+
+void test_regiao_apagada_vazia(void) {
+    uint32_t cursor = cursor_pendentes(&registro);
+    LeituraRegistrada leitura;
+    TEST_ASSERT_EQUAL_UINT32(CAPACIDADE, registro.capacidade);
+    TEST_ASSERT_EQUAL_UINT32(0, registro.sequencia);
+    TEST_ASSERT_EQUAL_UINT32(0, registro.cabeca);
+    TEST_ASSERT_EQUAL_UINT32(0, registro.pendentes);
+    TEST_ASSERT_FALSE(proxima_pendente(&registro, &cursor, &leitura));
+}
+
+void test_acrescenta_e_percorre_em_ordem(void) {
+    for (uint32_t n = 1; n <= 10; n++) grava(n);
+
+    TEST_ASSERT_EQUAL_UINT32(10, registro.sequencia);
+    TEST_ASSERT_EQUAL_UINT32(10, registro.cabeca);
+    TEST_ASSERT_EQUAL_UINT32(0, registro.pendente);
+    confere_pendentes(1, 10);
+
+    /* A sequência da leitura é a ordem de gravação */
+    uint32_t sequencias[10];
+    TEST_ASSERT_EQUAL_UINT32(10, lista_pendentes(sequencias, 10));
+    for (uint32_t i = 0; i < 10; i++) TEST_ASSERT_EQUAL_UINT32(i + 1, sequencias[i]);
+}
+
+void test_volta_descarta_o_setor_mais_antigo(void) {
+    /* Primeira volta: cada setor é apagado ao entrar, ainda sem pendentes a perder */
+    for (uint32_t n = 1; n <= CAPACIDADE; n++) grava(n);
+    TEST_ASSERT_EQUAL_UINT32(CAPACIDADE, registro.pendentes);
+    TEST_ASSERT_EQUAL_UINT32(0, registro.descartadas);
+    TEST_ASSERT_EQUAL_UINT32(NUM_SETORES, registro.apagamentos);
+
+    /* Voltando ao setor 0: as leituras dele são descartadas e a mais antiga passa ao setor 1 */
+    grava(CAPACIDADE + 1);
+    TEST_ASSERT_EQUAL_UINT32(REGISTRO_POR_SETOR, registro.descartadas);
+    TEST_ASSERT_EQUAL_UINT32(NUM_SETORES + 1, registro.apagamentos);
+    TEST_ASSERT_EQUAL_UINT32(REGISTRO_POR_SETOR, registro.pendente);
+    TEST_ASSERT_EQUAL_UINT32(1, registro.cabeca);
+    confere_pendentes(REGISTRO_POR_SETOR + 1, CAPACIDADE + 1);
+
+    /* Gravações dentro do setor não descartam mais nada */
+    grava(CAPACIDADE + 2);
+    TEST_ASSERT_EQUAL_UINT32(REGISTRO_POR_SETOR, registro.descartadas);
+    TEST_ASSERT_EQUAL_UINT32(NUM_SETORES + 1, registro.apagamentos);
+    confere_pendentes(REGISTRO_POR_SETOR + 1, CAPACIDADE + 2);
+}
+
+void test_confirmacao_avanca_a_pendente(void) {
+    for (uint32_t n = 1; n <= 10; n++) grava(n);
+
+    /* A confirmação ocupa a posição 10 (sequência 11); a pendente passa à leitura 5 */
+    TEST_ASSERT_TRUE(confirma_leituras(&registro, 4));
+    TEST_ASSERT_EQUAL_UINT32(4, registro.confirmada);
+    TEST_ASSERT_EQUAL_UINT32(11, registro.sequencia);
+    TEST_ASSERT_EQUAL_UINT32(11, registro.cabeca);
+    TEST_ASSERT_EQUAL_UINT32(4, registro.pendente);
+    confere_pendentes(5, 10);
+
+    /* Confirmação repetida ou mais antiga não grava nada */
+    TEST_ASSERT_TRUE(confirma_leituras(&registro, 3));
+    TEST_ASSERT_EQUAL_UINT32(11, registro.sequencia);
+    TEST_ASSERT_EQUAL_UINT32(4, registro.confirmada);
+
+    /* Leituras após a confirmação entram no fim; a confirmação é pulada na iteração */
+    grava(11);
+    confere_pendentes(5, 11);
+
+    /* Confirmando a leitura 11 (sequência 12), não resta pendente */
+    TEST_ASSERT_TRUE(confirma_leituras(&registro, 12));
+    uint32_t cursor = cursor_pendentes(&registro);
+    LeituraRegistrada leitura;
+    TEST_ASSERT_EQUAL_UINT32(0, registro.pendentes);
+    TEST_ASSERT_EQUAL_UINT32(registro.cabeca, registro.pendente);
+    TEST_ASSERT_FALSE(proxima_pendente(&registro, &cursor, &leitura));
+}
+
+void test_residuo_de_gravacao_pulado(void) {
+    grava(1);
+    grava(2);
+    grava(3);
+
+    /* Gravação interrompida na posição 3: só a sequência chegou à flash, sem o CRC */
+    uint8_t pagina[REGISTRO_TAMANHO_PAGINA];
+    uint32_t sequencia = 4;
+    memset(pagina, 0xFF, sizeof(pagina));
+    memcpy(&pagina[3 * REGISTRO_TAMANHO], &sequencia, sizeof(sequencia));
+    TEST_ASSERT_TRUE(meio->programa(0, pagina, sizeof(pagina)));
+
+    /* A posição suja não pode ser programada: a leitura vai para a seguinte */
+    grava(4);
+    TEST_ASSERT_EQUAL_UINT32(4, registro.sequencia);
+    TEST_ASSERT_EQUAL_UINT32(5, registro.cabeca);
+    confere_pendentes(1, 4);
+
+    /* No boot o resíduo também é ignorado */
+    inicializa_registro_leituras(&registro, meio);
+    TEST_ASSERT_EQUAL_UINT32(4, registro.sequencia);
+    TEST_ASSERT_EQUAL_UINT32(5, registro.cabeca);
+    confere_pendentes(1, 4);
+}
+
+void test_boot_reconstroi_o_estado(void) {
+    /* Registro após a volta, com uma confirmação no meio das pendentes */
+    for (uint32_t n = 1; n <= CAPACIDADE + 10; n++) grava(n);
+    TEST_ASSERT_TRUE(confirma_leituras(&registro, 200));
+    grava(CAPACIDADE + 11);
+
+    RegistroLeituras antes = registro;
+    static uint32_t seq_antes[CAPACIDADE], seq_depois[CAPACIDADE];
+    uint32_t n_antes = lista_pendentes(seq_antes, CAPACIDADE);
+
+    /* Reinício: a RAM se perde e o estado é reconstruído pela varredura */
+    memset(&registro, 0, sizeof(registro));
+    inicializa_registro_leituras(&registro, meio);
+
+    TEST_ASSERT_EQUAL_UINT32(antes.capacidade, registro.capacidade);
+    TEST_ASSERT_EQUAL_UINT32(antes.cabeca, registro.cabeca);
+    TEST_ASSERT_EQUAL_UINT32(antes.sequencia, registro.sequencia);
+    TEST_ASSERT_EQUAL_UINT32(antes.confirmada, registro.confirmada);
+    TEST_ASSERT_EQUAL_UINT32(antes.pendente, registro.pendente);
+    TEST_ASSERT_EQUAL_UINT32(antes.pendentes, registro.pendentes);
+
+    uint32_t n_depois = lista_pendentes(seq_depois, CAPACIDADE);
+    TEST_ASSERT_EQUAL_UINT32(n_antes, n_depois);
+    TEST_ASSERT_EQUAL_MEMORY(seq_antes, seq_depois, n_antes * sizeof(seq_antes[0]));
+    confere_pendentes(201, CAPACIDADE + 11);
+
+    /* O registro segue de onde parou */
+    grava(CAPACIDADE + 12);
+    TEST_ASSERT_EQUAL_UINT32(antes.sequencia + 1, registro.sequencia);
+    confere_pendentes(201, CAPACIDADE + 12);
+}
+
+void test_payload_maior_que_o_registro(void) {
+    uint8_t dados[REGISTRO_TAM_DADOS + 1] = { 0 };
+    TEST_ASSERT_FALSE(registra_leitura(&registro, SEGUNDOS_BASE, 1, dados, sizeof(dados)));
+    TEST_ASSERT_EQUAL_UINT32(0, registro.sequencia);
+    TEST_ASSERT_EQUAL_UINT32(0, registro.pendentes);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_regiao_apagada_vazia);
+    RUN_TEST(test_acrescenta_e_percorre_em_ordem);
+    RUN_TEST(test_volta_descarta_o_setor_mais_antigo);
+    RUN_TEST(test_confirmacao_avanca_a_pendente);
+    RUN_TEST(test_residuo_de_gravacao_pulado);
+    RUN_TEST(test_boot_reconstroi_o_estado);
+    RUN_TEST(test_payload_maior_que_o_registro);
+    return UNITY_END();
+}
+
+/*****************************END OF FILE**************************************/
@@ -0,0 +1,186 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  test_main.cpp
+ *
+ *    Description:  Testes da persistência da sessão LoRaWAN no meio em RAM (dublê
+ *                  da flash): rotação dos slots, rejeição por CRC e apagamento do
+ *                  setor na entrada. Uso: pio test -e native
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 23:59:59
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include <unity.h>
+#include <string.h>
+#include "../../lib/sessao_lorawan/sessao_lorawan.hpp"
+
+#define NUM_SLOTS        (SESSAO_TAMANHO_REGIAO / SESSAO_TAMANHO_SLOT)
+#define SLOTS_POR_SETOR  (SESSAO_TAMANHO_SETOR / SESSAO_TAMANHO_SLOT)
+
+/* Tamanhos arbitrários, próximos aos buffers do RadioLib */
+#define TAM_NONCES       16
+#define TAM_SESSAO       200
+
+static const ArmazenamentoSessao *meio = &armazenamento_sessao_ram;
+static SessaoLoRaWAN sessao;
+
+/* Buffers com conteúdo derivado da gravação n, para conferir qual registro foi restaurado */
+static void preenche(uint8_t *nonces, uint8_t *buf_sessao, uint32_t n) {
+    for (size_t i = 0; i < TAM_NONCES; i++) nonces[i] = (uint8_t)(n + i);
+    for (size_t i = 0; i < TAM_SESSAO; i++) buf_sessao[i] = (uint8_t)(n * 7 + i);
+}
+
+static void grava(uint32_t n) {
+    uint8_t nonces[TAM_NONCES], buf_sessao[TAM_SESSAO];
+    preenche(nonces, buf_sessao, n);
+    TEST_ASSERT_TRUE(salva_sessao_lorawan(&sessao, nonces, TAM_NONCES, buf_sessao, TAM_SESSAO));
+}
+
+static void confere_restaurada(uint32_t n) {
+    uint8_t nonces[TAM_NONCES], buf_sessao[TAM_SESSAO];
+    uint8_t esperado_nonces[TAM_NONCES], esperado_sessao[TAM_SESSAO];
+    preenche(esperado_nonces, esperado_sessao, n);
+    TEST_ASSERT_TRUE(restaura_sessao_lorawan(&sessao, nonces, TAM_NONCES, buf_sessao, TAM_SESSAO));
+    TEST_ASSERT_EQUAL_MEMORY(esperado_nonces, nonces, TAM_NONCES);
+    TEST_ASSERT_EQUAL_MEMORY(esperado_sessao, buf_sessao, TAM_SESSAO);
+}
+
+static bool slot_apagado(int16_t slot) {
+    uint8_t buf[SESSAO_TAMANHO_SLOT];
+    meio->le((uint32_t)slot * SESSAO_TAMANHO_SLOT, buf, sizeof(buf));
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        if (buf[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+void setUp(void) {
+    /* Cada teste parte da região apagada, como em um nó recém-gravado */
+    inicializa_sessao_lorawan(&sessao, meio);
+    apaga_sessao_lorawan(&sessao);
+    inicializa_sessao_lorawan(&sessao, meio);
+}
+
+void tearDown(void) {}
+
+
+/* ============================================================================
+ *  Casos de teste
+ * ============================================================================
+*/
+
+void test_regiao_apagada_nao_restaura(void) {
+    uint8_t nonces[TAM_NONCES], buf_sessao[TAM_SESSAO];
+    TEST_ASSERT_EQUAL_INT(-1, sessao.slot_atual);
+    TEST_ASSERT_FALSE(restaura_sessao_lorawan(&sessao, nonces, TAM_NONCES, buf_sessao, TAM_SESSAO));
+}
+
+void test_rotacao_dos_slots(void) {
+    /* Duas voltas completas: cada gravação ocupa o slot seguinte, de forma circular */
+    for (uint32_t n = 1; n <= 2 * NUM_SLOTS; n++) {
+        grava(n);
+        TEST_ASSERT_EQUAL_INT((n - 1) % NUM_SLOTS, sessao.slot_atual);
+        TEST_ASSERT_EQUAL_UINT32(n, sessao.sequencia);
+    }
+    confere_restaurada(2 * NUM_SLOTS);
+
+    /* Um novo boot localiza o registro de maior sequência */
+    inicializa_sessao_lorawan(&sessao, meio);
+    TEST_ASSERT_EQUAL_INT(NUM_SLOTS - 1, sessao.slot_atual);
+    TEST_ASSERT_EQUAL_UINT32(2 * NUM_SLOTS, sessao.sequencia);
+    confere_restaurada(2 * NUM_SLOTS);
+}
+
+void test_crc_invalido_rejeitado(void) {
+    grava(1);
+    grava(2);
+    grava(3);
+
+    /* Corrompendo um byte da carga do slot 2 (gravação 3): a flash só leva bits de 1 para 0 */
+    uint8_t zero = 0x00;
+    TEST_ASSERT_TRUE(meio->programa(2 * SESSAO_TAMANHO_SLOT + sizeof(CabecalhoSessao) + 5, &zero, 1));
+
+    /* O registro corrompido é descartado e o anterior volta a ser o atual */
+    inicializa_sessao_lorawan(&sessao, meio);
+    TEST_ASSERT_EQUAL_INT(1, sessao.slot_atual);
+    TEST_ASSERT_EQUAL_UINT32(2, sessao.sequencia);
+    confere_restaurada(2);
+}
+
+void test_tamanho_diferente_rejeitado(void) {
+    grava(1);
+
+    /* Buffers de outra versão do RadioLib não são restaurados */
+    uint8_t nonces[TAM_NONCES], buf_sessao[TAM_SESSAO + 1];
+    TEST_ASSERT_FALSE(restaura_sessao_lorawan(&sessao, nonces, TAM_NONCES, buf_sessao, TAM_SESSAO + 1));
+}
+
+void test_setor_apagado_na_entrada(void) {
+    /* Primeira volta: todos os slots ocupados */
+    for (uint32_t n = 1; n <= NUM_SLOTS; n++) grava(n);
+
+    /* Entrando de novo no setor 0: ele é apagado inteiro, e o setor 1 segue intacto */
+    grava(NUM_SLOTS + 1);
+    TEST_ASSERT_EQUAL_INT(0, sessao.slot_atual);
+    for (int16_t slot = 1; slot < SLOTS_POR_SETOR; slot++) {
+        TEST_ASSERT_TRUE(slot_apagado(slot));
+    }
+    for (int16_t slot = SLOTS_POR_SETOR; slot < NUM_SLOTS; slot++) {
+        TEST_ASSERT_FALSE(slot_apagado(slot));
+    }
+
+    /* Gravações dentro do setor não o apagam de novo */
+    grava(NUM_SLOTS + 2);
+    TEST_ASSERT_EQUAL_INT(1, sessao.slot_atual);
+    inicializa_sessao_lorawan(&sessao, meio);
+    TEST_ASSERT_EQUAL_UINT32(NUM_SLOTS + 2, sessao.sequencia);
+    confere_restaurada(NUM_SLOTS + 2);
+}
+
+void test_residuo_pula_para_o_proximo_setor(void) {
+    grava(1);
+    grava(2);
+
+    /* Gravação interrompida deixou resíduo no slot 2, ainda sem registro válido */
+    uint8_t lixo[4] = { 0x12, 0x34, 0x56, 0x78 };
+    TEST_ASSERT_TRUE(meio->programa(2 * SESSAO_TAMANHO_SLOT, lixo, sizeof(lixo)));
+
+    /* O slot com resíduo não pode ser programado sem apagar o setor: a gravação vai para o setor 1 */
+    grava(3);
+    TEST_ASSERT_EQUAL_INT(SLOTS_POR_SETOR, sessao.slot_atual);
+    inicializa_sessao_lorawan(&sessao, meio);
+    TEST_ASSERT_EQUAL_INT(SLOTS_POR_SETOR, sessao.slot_atual);
+    confere_restaurada(3);
+}
+
+void test_carga_maior_que_o_slot(void) {
+    static uint8_t grande[SESSAO_CARGA_MAX + 1];
+    uint8_t nonces[TAM_NONCES] = { 0 };
+    TEST_ASSERT_FALSE(salva_sessao_lorawan(&sessao, nonces, TAM_NONCES, grande, sizeof(grande)));
+    TEST_ASSERT_EQUAL_INT(-1, sessao.slot_atual);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_regiao_apagada_nao_restaura);
+    RUN_TEST(test_rotacao_dos_slots);
+    RUN_TEST(test_crc_invalido_rejeitado);
+    RUN_TEST(test_tamanho_diferente_rejeitado);
+    RUN_TEST(test_setor_apagado_na_entrada);
+    RUN_TEST(test_residuo_pula_para_o_proximo_setor);
+    RUN_TEST(test_carga_maior_que_o_slot);
+    return UNITY_END();
+}
+
+/*****************************END OF FILE**************************************/
@@ -0,0 +1,177 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  clock_despertar.cpp
+ *
+ *    Description:  -
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 18:20:05
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include "clock_despertar.hpp"
+#include "../barramento_i2c/barramento_i2c.hpp"
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/pll.h"
+#include "hardware/xosc.h"
+#include "hardware/vreg.h"
+
+#define XOSC_HZ (XOSC_MHZ * MHZ)
+
+/* clk_sys de cada degrau, na ordem de PerfilClock */
+static const uint32_t degraus_mhz[] = { XOSC_MHZ, CLOCK_MAC_MHZ, CLOCK_RADIO_MHZ, 125 };
+
+/* Após o boot o runtime do SDK já executou clocks_init() */
+static PerfilClock perfil_atual = CLOCK_PERFIL_COMPLETO;
+
+/* Parâmetros do PLL_SYS por degrau (a busca do SDK é lenta a 12 MHz: feita uma vez) */
+static uint vco_degrau[CLOCK_PERFIL_COMPLETO] = { 0 };
+static uint pd1_degrau[CLOCK_PERFIL_COMPLETO], pd2_degrau[CLOCK_PERFIL_COMPLETO];
+
+#ifdef CLOCK_GOVERNADOR
+/* Tensão do núcleo deixada pelo boot (VSEL de reset) */
+static enum vreg_voltage tensao_atual = VREG_VOLTAGE_DEFAULT;
+#endif
+
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  clocks_no_xosc
+*  Description:  Coloca clk_ref, clk_sys, clk_peri e clk_rtc no XOSC (religando-o se o
+*                sono foi a partir do ROSC). Com clk_sys fora dos PLLs eles podem ser
+*                desligados ou reconfigurados.
+* =====================================================================================
+*/
+static void clocks_no_xosc(void) {
+  xosc_init();
+  clock_configure(clk_ref, CLOCKS_CLK_REF_CTRL_SRC_VALUE_XOSC_CLKSRC, 0, XOSC_HZ, XOSC_HZ);
+  clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLK_REF, 0, XOSC_HZ, XOSC_HZ);
+  clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLK_SYS, XOSC_HZ, XOSC_HZ);
+  clock_configure(clk_rtc, 0, CLOCKS_CLK_RTC_CTRL_AUXSRC_VALUE_XOSC_CLKSRC, XOSC_HZ, 46875);
+  clock_stop(clk_usb);
+  clock_stop(clk_adc);
+  pll_deinit(pll_usb);
+}
+
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  clk_peri_minimo_hz
+*  Description:  Menor clk_peri que ainda gera os baud rates pedidos: UART com divisor
+*                mínimo de 16, I2C com o IC_CLK mínimo do datasheet (~30x o SCL) e SPI
+*                com prescaler mínimo de 2.
+* =====================================================================================
+*/
+static uint32_t clk_peri_minimo_hz(const PerifericosClock *perifericos) {
+  uint32_t minimo = 0;
+  if (perifericos == NULL) {
+    return 0;
+  }
+  if (perifericos->uart && 16 * perifericos->uart_baud > minimo) {
+    minimo = 16 * perifericos->uart_baud;
+  }
+  if (perifericos->i2c && 30 * perifericos->i2c_baud > minimo) {
+    minimo = 30 * perifericos->i2c_baud;
+  }
+  if (perifericos->spi && 2 * perifericos->spi_baud > minimo) {
+    minimo = 2 * perifericos->spi_baud;
+  }
+  return minimo;
+}
+
+#ifdef CLOCK_GOVERNADOR
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  tensao_degrau
+*  Description:  Menor tensão do núcleo usada para cada clk_sys, com folga sobre o
+*                mínimo típico do RP2040 (1,10 V é o valor de reset do regulador).
+* =====================================================================================
+*/
+static enum vreg_voltage tensao_degrau(uint32_t mhz) {
+  if (mhz <= 24) {
+    return VREG_VOLTAGE_0_95;
+  }
+  if (mhz <= 48) {
+    return VREG_VOLTAGE_1_00;
+  }
+  return VREG_VOLTAGE_DEFAULT;
+}
+#endif
+
+static void reajusta_perifericos(const PerifericosClock *perifericos) {
+  if (perifericos == NULL) {
+    return;
+  }
+  if (perifericos->uart) {
+    uart_set_baudrate(perifericos->uart, perifericos->uart_baud);
+  }
+  if (perifericos->i2c) {
+    /* Pelo barramento compartilhado, que guarda o baud programado e o clk_peri de referência */
+    reajusta_barramento_i2c(perifericos->i2c, perifericos->i2c_baud);
+  }
+  if (perifericos->spi) {
+    spi_set_baudrate(perifericos->spi, perifericos->spi_baud);
+  }
+}
+
+void aplica_perfil_clock(PerfilClock perfil, const PerifericosClock *perifericos) {
+  /* Menor degrau a partir do perfil que atende os periféricos */
+  uint degrau = perfil;
+  uint32_t minimo_hz = clk_peri_minimo_hz(perifericos);
+  while (degrau < CLOCK_PERFIL_COMPLETO && degraus_mhz[degrau] * MHZ < minimo_hz) {
+    degrau++;
+  }
+  uint32_t hz = degraus_mhz[degrau] * MHZ;
+
+#ifdef CLOCK_GOVERNADOR
+  /* Subindo: a tensão vai antes do clock */
+  enum vreg_voltage tensao = tensao_degrau(degraus_mhz[degrau]);
+  if (tensao > tensao_atual) {
+    vreg_set_voltage(tensao);
+    busy_wait_us(CLOCK_VREG_ASSENTAMENTO_US);
+    tensao_atual = tensao;
+  }
+#endif
+
+  /* Sempre reaplicado: após o sono os clocks são os do sono, qualquer que tenha sido
+     o último perfil (pll_init() com os mesmos parâmetros retorna sem religar) */
+  if (degrau == CLOCK_PERFIL_SENSOR) {
+    clocks_no_xosc();
+    pll_deinit(pll_sys);
+  } else if (degrau < CLOCK_PERFIL_COMPLETO) {
+    if (vco_degrau[degrau] == 0) {
+      check_sys_clock_khz(hz / KHZ, &vco_degrau[degrau], &pd1_degrau[degrau], &pd2_degrau[degrau]);
+    }
+    clocks_no_xosc();
+    pll_init(pll_sys, 1, vco_degrau[degrau], pd1_degrau[degrau], pd2_degrau[degrau]);
+    clock_configure(clk_sys,
+                    CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                    CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS,
+                    hz, hz);
+    clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLK_SYS, hz, hz);
+  } else {
+    clocks_init();
+  }
+
+#ifdef CLOCK_GOVERNADOR
+  /* Descendo: a tensão só cai com o clock já reduzido */
+  if (tensao < tensao_atual) {
+    vreg_set_voltage(tensao);
+    tensao_atual = tensao;
+  }
+#endif
+
+  perfil_atual = perfil;
+  reajusta_perifericos(perifericos);
+}
+
+PerfilClock perfil_clock_atual(void) {
+  return perfil_atual;
+}
+/*****************************END OF FILE**************************************/
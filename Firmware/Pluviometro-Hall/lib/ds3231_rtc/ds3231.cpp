@@ -16,22 +16,42 @@
  * =====================================================================================
 */
 #include "ds3231.hpp"
+#include <string.h>
 
 /* Declarando estrutura global para armazenar dados do módulo DS3231 */
 DS3231 rtc_ds3231;
 
+/**
+ * @brief Lê registradores consecutivos do DS3231 em uma única transação I2C.
+ *
+ * O endereço inicial é enviado sem STOP e a leitura segue com START repetido;
+ * o ponteiro interno do DS3231 avança sozinho a cada byte lido.
+*/
+bool ds3231_read_regs(i2c_inst_t *i2c, uint8_t reg_inicial, uint8_t *dest, size_t n) {
+    if (n == 0 || n > DS3231_NUM_REGS) return false;
+
+    return barramento_i2c_transacao(i2c, DS3231_I2C_ADDR, DS3231_I2C_BAUD, &reg_inicial, 1, dest, n);
+}
+
+/**
+ * @brief Escreve registradores consecutivos do DS3231 em uma única transação I2C
+*/
+bool ds3231_write_regs(i2c_inst_t *i2c, uint8_t reg_inicial, const uint8_t *src, size_t n) {
+    if (n == 0 || n > DS3231_NUM_REGS) return false;
+
+    /* Montando o quadro: endereço inicial seguido dos valores */
+    uint8_t buffer[DS3231_NUM_REGS + 1];
+    buffer[0] = reg_inicial;
+    memcpy(&buffer[1], src, n);
+
+    return barramento_i2c_transacao(i2c, DS3231_I2C_ADDR, DS3231_I2C_BAUD, buffer, n + 1, NULL, 0);
+}
+
 /**
  * @brief Lê um único registrador do DS3231 via I2C
 */
 bool ds3231_read_reg(i2c_inst_t *i2c, uint8_t reg_addr, uint8_t *dest) {
-    /* Enviando o endereço do registrador a ser lido (sem STOP) */
-    if (i2c_write_blocking(i2c, DS3231_I2C_ADDR, &reg_addr, 1, true) != 1)
-        return false;
-    /* Lê o dado do registrador (com STOP) */
-    if (i2c_read_blocking(i2c, DS3231_I2C_ADDR, dest, 1, false) != 1)
-        return false;
-
-    return true;
+    return ds3231_read_regs(i2c, reg_addr, dest, 1);
 }
 
 /**
@@ -39,8 +59,7 @@ bool ds3231_read_reg(i2c_inst_t *i2c, uint8_t reg_addr, uint8_t *dest) {
 */
 
 bool ds3231_write_reg(i2c_inst_t *i2c, uint8_t reg_addr, uint8_t value) {
-    uint8_t buffer[2] = {reg_addr, value};
-    return (i2c_write_blocking(i2c, DS3231_I2C_ADDR, buffer, 2, false) == 2);
+    return ds3231_write_regs(i2c, reg_addr, &value, 1);
 }
 
 /**
@@ -50,13 +69,9 @@ void inicializa_ds3231(DS3231 *mod_rtc, i2c_inst_t *i2c, uint8_t endereco, uint
     /* Armazenando endereço e instância de I2C na estrutura */
     mod_rtc->endereco = endereco;
     mod_rtc->i2c = i2c;
-  
-    /* Inicializando comunicação I2C com frequência de 400 kHz */
-    i2c_init(i2c, 400 * 1000);
-  
-    /* Configurando pinos SDA e SCL para função I2C */
-    gpio_set_function(sda_pin, GPIO_FUNC_I2C);
-    gpio_set_function(scl_pin, GPIO_FUNC_I2C);
+
+    /* Configurando o barramento compartilhado (o i2c_init() é feito só pelo primeiro driver) */
+    inicializa_barramento_i2c(i2c, sda_pin, scl_pin);
 }
 
 
@@ -88,9 +103,7 @@ uint8_t bcd_to_decimal(uint8_t val) {
 */
 bool hora_atual_rtc(i2c_inst_t *i2c, HoraRTC *hora) {
     uint8_t buffer[3];
-    if (i2c_write_blocking(i2c, DS3231_I2C_ADDR, (uint8_t[]){DS3231_REG_SECONDS}, 1, true) != 1)
-        return false;
-    if (i2c_read_blocking(i2c, DS3231_I2C_ADDR, buffer, 3, false) != 3)
+    if (!ds3231_read_regs(i2c, DS3231_REG_SECONDS, buffer, 3))
         return false;
 
     hora->segundos = bcd_to_decimal(buffer[0]);
@@ -99,12 +112,95 @@ bool hora_atual_rtc(i2c_inst_t *i2c, HoraRTC *hora) {
     return true;
 }
 
+/**
+ * @brief Lê data e hora do RTC (uma transação) em segundos desde 01/01/2000 00:00.
+ *
+ * Serve como carimbo de tempo das leituras: mesmo com o RTC fora de hora, a
+ * diferença entre dois carimbos continua correta.
+ *
+ * @param i2c      Instância da I2C conectada ao RTC
+ * @param segundos Ponteiro para o resultado
+ * @return true se a leitura foi bem-sucedida
+*/
+bool segundos_rtc(i2c_inst_t *i2c, uint32_t *segundos) {
+    uint8_t buffer[7];
+    if (!ds3231_read_regs(i2c, DS3231_REG_SECONDS, buffer, sizeof(buffer)))
+        return false;
+
+    int32_t ano = 2000 + bcd_to_decimal(buffer[DS3231_REG_YEAR]);
+    int32_t mes = bcd_to_decimal(buffer[DS3231_REG_MONTH_CENTURY] & 0x1F);
+    int32_t dia = bcd_to_decimal(buffer[DS3231_REG_DATE]);
+
+    /* Dias desde 01/03/0000 (calendário civil com o ano começando em março) */
+    if (mes <= 2) ano--;
+    int32_t era = ano / 400;
+    int32_t ano_era = ano - era * 400;
+    int32_t mes_marco = (mes > 2) ? mes - 3 : mes + 9;
+    int32_t dia_ano = (153 * mes_marco + 2) / 5 + dia - 1;
+    int32_t dia_era = ano_era * 365 + ano_era / 4 - ano_era / 100 + dia_ano;
+    uint32_t dias = (uint32_t)(era * 146097 + dia_era - 730425);   /* 730425 = 01/01/2000 */
+
+    *segundos = dias * DS3231_SEGUNDOS_POR_DIA
+              + (uint32_t)bcd_to_decimal(buffer[DS3231_REG_HOURS] & 0x3F) * 3600
+              + (uint32_t)bcd_to_decimal(buffer[DS3231_REG_MINUTES]) * 60
+              + bcd_to_decimal(buffer[DS3231_REG_SECONDS]);
+    return true;
+}
+
 
 
 /* ============================================================================
  *  Configuração de Alarmes
  * ============================================================================ 
 */
+
+/* Registradores gravados de uma vez ao programar o alarme 1 (0x07 até o status) */
+#define DS3231_TAM_BLOCO_ALARME  (DS3231_REG_STATUS - DS3231_REG_ALARM1_SEC + 1)
+
+/**
+ * @brief Grava o alarme 1, o controle e o status em uma única transação.
+ *
+ * Os registradores do alarme 2, o controle e o status vêm de uma leitura anterior
+ * (regs indexado pelo endereço, de 0x00 a 0x0F). Os bits A2F e OSF são escritos
+ * em 1, o que não altera o valor no DS3231, para que uma flag ativada entre a
+ * leitura e a escrita não seja apagada; apenas A1F é zerada.
+*/
+static bool grava_bloco_alarme1(i2c_inst_t *i2c, const uint8_t *regs, uint8_t min, uint8_t seg) {
+    uint8_t bloco[DS3231_TAM_BLOCO_ALARME];
+
+    /* Alarm1: Match segundos e minutos */
+    bloco[0] = decimal_to_bcd(seg);   // A1M1 = 0
+    bloco[1] = decimal_to_bcd(min);   // A1M2 = 0
+    bloco[2] = 0x80;                  // A1M3 = 1 (ignora horas)
+    bloco[3] = 0x80;                  // A1M4 = 1 (ignora dia)
+
+    /* Alarm2 preservado */
+    bloco[4] = regs[DS3231_REG_ALARM2_MIN];
+    bloco[5] = regs[DS3231_REG_ALARM2_HOUR];
+    bloco[6] = regs[DS3231_REG_ALARM2_DAY_DATE];
+
+    /* Habilitando alarme e INT/SQW como interrupção (sem disparar nova conversão de temperatura) */
+    bloco[7] = (uint8_t)((regs[DS3231_REG_CONTROL] & ~DS3231_CTRL_CONV) | DS3231_CTRL_INTCN | DS3231_CTRL_A1IE);
+
+    /* Limpando apenas A1F */
+    bloco[8] = (uint8_t)((regs[DS3231_REG_STATUS] | DS3231_STAT_A2F | DS3231_STAT_OSF) & ~DS3231_STAT_A1F);
+
+    return ds3231_write_regs(i2c, DS3231_REG_ALARM1_SEC, bloco, sizeof(bloco));
+}
+
+/**
+ * @brief Calcula o horário do próximo alarme a partir da hora lida em regs e grava o bloco
+*/
+static bool agenda_a_partir_de(i2c_inst_t *i2c, const uint8_t *regs, uint8_t offset_min, uint8_t offset_seg) {
+    uint16_t total_segundos = bcd_to_decimal(regs[DS3231_REG_SECONDS]) + offset_seg;
+    uint8_t novo_seg = total_segundos % 60;
+
+    uint16_t total_minutos = bcd_to_decimal(regs[DS3231_REG_MINUTES]) + offset_min + (total_segundos / 60);
+    uint8_t novo_min = total_minutos % 60;
+
+    return grava_bloco_alarme1(i2c, regs, novo_min, novo_seg);
+}
+
 /**
  * @brief Configura o alarme 1 do DS3231 para disparar em um horário específico (minuto e segundo).
  * 
@@ -114,7 +210,8 @@ bool hora_atual_rtc(i2c_inst_t *i2c, HoraRTC *hora) {
  * - A1M3 = 1: Ignora horas
  * - A1M4 = 1: Ignora dia/data
  * 
- * Também ativa o modo de interrupção no pino INT/SQW.
+ * Também ativa o modo de interrupção no pino INT/SQW e limpa a flag A1F. São
+ * usadas 2 transações I2C: leitura do alarme 2, controle e status, e escrita do bloco.
  * 
  * @param i2c Instância da I2C conectada ao RTC
  * @param min Minuto exato para disparo
@@ -123,20 +220,12 @@ bool hora_atual_rtc(i2c_inst_t *i2c, HoraRTC *hora) {
 */
 
 bool alarme_para_horario(i2c_inst_t *i2c, uint8_t min, uint8_t seg) {
-    uint8_t bcd_min = decimal_to_bcd(min);
-    uint8_t bcd_seg = decimal_to_bcd(seg);
-
-    /* Alarm1: Match segundos e minutos */
-    if (!ds3231_write_reg(i2c, DS3231_REG_ALARM1_SEC, bcd_seg)) return false;  // A1M1 = 0
-    if (!ds3231_write_reg(i2c, DS3231_REG_ALARM1_MIN, bcd_min)) return false;  // A1M2 = 0
-    if (!ds3231_write_reg(i2c, DS3231_REG_ALARM1_HOUR, 0x80)) return false;    // A1M3 = 1 (ignora horas)
-    if (!ds3231_write_reg(i2c, DS3231_REG_ALARM1_DAY_DATE, 0x80)) return false;// A1M4 = 1 (ignora dia)
+    uint8_t regs[DS3231_REG_STATUS + 1];
+    if (!ds3231_read_regs(i2c, DS3231_REG_ALARM2_MIN, &regs[DS3231_REG_ALARM2_MIN],
+                          DS3231_REG_STATUS - DS3231_REG_ALARM2_MIN + 1))
+        return false;
 
-    /* Habilitando alarme e INT/SQW como interrupção */
-    uint8_t ctrl;
-    if (!ds3231_read_reg(i2c, DS3231_REG_CONTROL, &ctrl)) return false;
-    ctrl |= DS3231_CTRL_INTCN | DS3231_CTRL_A1IE;
-    return ds3231_write_reg(i2c, DS3231_REG_CONTROL, ctrl);
+    return grava_bloco_alarme1(i2c, regs, min, seg);
 }
 
 
@@ -144,8 +233,8 @@ bool alarme_para_horario(i2c_inst_t *i2c, uint8_t min, uint8_t seg) {
 /**
  * @brief Agenda um alarme para disparar após um intervalo relativo a partir da hora atual.
  * 
- * Calcula o horário futuro com base nos minutos e segundos de offset, e agenda o alarme
- * com 'alarme_para_horario()'.
+ * Lê a hora e os registradores de alarme, controle e status em uma única
+ * transação e grava o novo alarme em outra (2 transações no total).
  * 
  * @param i2c         Instância da I2C conectada ao RTC
  * @param offset_min  Minutos a partir de agora
@@ -153,14 +242,155 @@ bool alarme_para_horario(i2c_inst_t *i2c, uint8_t min, uint8_t seg) {
  * @return true se o alarme foi agendado corretamente
 */
 bool agenda_alarme_em(i2c_inst_t *i2c, uint8_t offset_min, uint8_t offset_seg) {
-    HoraRTC agora;
-    if (!hora_atual_rtc(i2c, &agora)) return false;
+    uint8_t regs[DS3231_REG_STATUS + 1];
+    if (!ds3231_read_regs(i2c, DS3231_REG_SECONDS, regs, sizeof(regs))) return false;
 
-    uint16_t total_segundos = agora.segundos + offset_seg;
-    uint8_t novo_seg = total_segundos % 60;
+    return agenda_a_partir_de(i2c, regs, offset_min, offset_seg);
+}
 
-    uint16_t total_minutos = agora.minutos + offset_min + (total_segundos / 60);
-    uint8_t novo_min = total_minutos % 60;
+/**
+ * @brief Trata o despertar pelo alarme 1: se A1F estiver ativa, limpa a flag e agenda
+ *        o próximo alarme relativo à hora atual.
+ *
+ * A mesma leitura em bloco fornece a hora e o status, de modo que o reagendamento
+ * usa no máximo 2 transações I2C (apenas 1 se o alarme não tiver disparado).
+ *
+ * @return true se o alarme havia disparado e foi reagendado
+*/
+bool reagenda_alarme_disparado(i2c_inst_t *i2c, uint8_t offset_min, uint8_t offset_seg) {
+    uint8_t regs[DS3231_REG_STATUS + 1];
+    if (!ds3231_read_regs(i2c, DS3231_REG_SECONDS, regs, sizeof(regs))) return false;
+    if (!(regs[DS3231_REG_STATUS] & DS3231_STAT_A1F)) return false;
+
+    return agenda_a_partir_de(i2c, regs, offset_min, offset_seg);
+}
+
+/* ============================================================================
+ *  Agendamento em grade absoluta
+ * ============================================================================ 
+*/
+
+/**
+ * @brief Verifica se a grade pode ser programada no DS3231.
+ *
+ * O período precisa dividir o dia para que a grade seja a mesma em todos os dias;
+ * intervalos como 90 min mudariam de horário a cada 24 h.
+*/
+bool grade_alarme_valida(const GradeAlarme *grade) {
+    if (grade->periodo_min == 0 || DS3231_MINUTOS_POR_DIA % grade->periodo_min != 0) return false;
+    return grade->fase_seg < (uint32_t)grade->periodo_min * 60;
+}
+
+/**
+ * @brief Calcula o próximo horário da grade, em segundos desde 00:00.
+ *
+ * O horário retornado é estritamente posterior a agora_seg + DS3231_MARGEM_GRADE_SEG:
+ * se ele passasse entre a leitura da hora e a escrita do alarme, a comparação de
+ * horas só voltaria a coincidir no dia seguinte.
+ *
+ * @param grade     Grade válida (ver grade_alarme_valida)
+ * @param agora_seg Hora atual em segundos desde 00:00
+*/
+uint32_t proximo_horario_grade(const GradeAlarme *grade, uint32_t agora_seg) {
+    uint32_t periodo_seg = (uint32_t)grade->periodo_min * 60;
+    uint32_t alvo = agora_seg + DS3231_MARGEM_GRADE_SEG;
+
+    if (alvo < grade->fase_seg) return grade->fase_seg;
+
+    uint32_t horario = grade->fase_seg + ((alvo - grade->fase_seg) / periodo_seg + 1) * periodo_seg;
+    return horario % DS3231_SEGUNDOS_POR_DIA;
+}
+
+/**
+ * @brief Programa o horário absoluto no alarme adequado e grava o bloco 0x07–0x0F.
+ *
+ * Horários no segundo 00 usam o alarme 2, que só compara minutos e horas; os
+ * demais usam o alarme 1, que também compara os segundos. Em ambos o dia é
+ * ignorado (A1M4/A2M4 = 1): o próximo horário está sempre a menos de 24 h, então
+ * hora, minuto e segundo já o identificam sem ambiguidade. Apenas o alarme usado
+ * fica habilitado e as duas flags são limpas.
+*/
+static bool grava_alarme_grade(i2c_inst_t *i2c, uint8_t *regs, uint32_t horario) {
+    uint8_t hora = (uint8_t)(horario / 3600);
+    uint8_t min = (uint8_t)((horario / 60) % 60);
+    uint8_t seg = (uint8_t)(horario % 60);
+
+    uint8_t ctrl = (uint8_t)((regs[DS3231_REG_CONTROL] & ~(DS3231_CTRL_CONV | DS3231_CTRL_A1IE | DS3231_CTRL_A2IE))
+                             | DS3231_CTRL_INTCN);
+
+    if (seg == 0) {
+        /* Alarm2: Match minutos e horas (modo 24 h) */
+        regs[DS3231_REG_ALARM2_MIN] = decimal_to_bcd(min);       // A2M2 = 0
+        regs[DS3231_REG_ALARM2_HOUR] = decimal_to_bcd(hora);     // A2M3 = 0
+        regs[DS3231_REG_ALARM2_DAY_DATE] = 0x80;                 // A2M4 = 1 (ignora dia)
+        ctrl |= DS3231_CTRL_A2IE;
+    } else {
+        /* Alarm1: Match segundos, minutos e horas (modo 24 h) */
+        regs[DS3231_REG_ALARM1_SEC] = decimal_to_bcd(seg);       // A1M1 = 0
+        regs[DS3231_REG_ALARM1_MIN] = decimal_to_bcd(min);       // A1M2 = 0
+        regs[DS3231_REG_ALARM1_HOUR] = decimal_to_bcd(hora);     // A1M3 = 0
+        regs[DS3231_REG_ALARM1_DAY_DATE] = 0x80;                 // A1M4 = 1 (ignora dia)
+        ctrl |= DS3231_CTRL_A1IE;
+    }
+
+    regs[DS3231_REG_CONTROL] = ctrl;
+    regs[DS3231_REG_STATUS] = (uint8_t)((regs[DS3231_REG_STATUS] | DS3231_STAT_OSF)
+                                        & ~(DS3231_STAT_A1F | DS3231_STAT_A2F));
+
+    return ds3231_write_regs(i2c, DS3231_REG_ALARM1_SEC, &regs[DS3231_REG_ALARM1_SEC], DS3231_TAM_BLOCO_ALARME);
+}
+
+/**
+ * @brief Agenda o próximo horário da grade a partir da hora lida em regs
+*/
+static bool agenda_grade_a_partir_de(i2c_inst_t *i2c, uint8_t *regs, const GradeAlarme *grade) {
+    uint32_t agora_seg = (uint32_t)bcd_to_decimal(regs[DS3231_REG_HOURS] & 0x3F) * 3600
+                       + (uint32_t)bcd_to_decimal(regs[DS3231_REG_MINUTES]) * 60
+                       + bcd_to_decimal(regs[DS3231_REG_SECONDS]);
+
+    return grava_alarme_grade(i2c, regs, proximo_horario_grade(grade, agora_seg));
+}
+
+/**
+ * @brief Agenda o próximo despertar alinhado à grade absoluta.
+ *
+ * Diferente de agenda_alarme_em(), o horário não depende do instante em que o
+ * ciclo terminou, portanto atrasos não se acumulam e intervalos de 60 min ou
+ * mais (até o envio diário) são representados corretamente. Usa 2 transações I2C.
+ *
+ * @param i2c   Instância da I2C conectada ao RTC
+ * @param grade Período e fase da grade
+ * @return true se a grade é válida e o alarme foi programado
+*/
+bool agenda_alarme_grade(i2c_inst_t *i2c, const GradeAlarme *grade) {
+    if (!grade_alarme_valida(grade)) return false;
+
+    uint8_t regs[DS3231_REG_STATUS + 1];
+    if (!ds3231_read_regs(i2c, DS3231_REG_SECONDS, regs, sizeof(regs))) return false;
+
+    return agenda_grade_a_partir_de(i2c, regs, grade);
+}
+
+/**
+ * @brief Trata o despertar da grade: se a flag do alarme habilitado estiver ativa,
+ *        agenda o próximo horário (no máximo 2 transações I2C).
+ *
+ * A flag do alarme desabilitado é ignorada, pois ela continua sendo ativada pelos
+ * registradores antigos sem acionar a linha INT/SQW.
+ *
+ * @return true se o alarme havia disparado e foi reagendado
+*/
+bool reagenda_grade_disparada(i2c_inst_t *i2c, const GradeAlarme *grade) {
+    if (!grade_alarme_valida(grade)) return false;
 
-    return alarme_para_horario(i2c, novo_min, novo_seg);
-}
\ No newline at end of file
+    uint8_t regs[DS3231_REG_STATUS + 1];
+    if (!ds3231_read_regs(i2c, DS3231_REG_SECONDS, regs, sizeof(regs))) return false;
+
+    uint8_t ctrl = regs[DS3231_REG_CONTROL];
+    uint8_t disparou = regs[DS3231_REG_STATUS]
+                     & (((ctrl & DS3231_CTRL_A1IE) ? DS3231_STAT_A1F : 0)
+                      | ((ctrl & DS3231_CTRL_A2IE) ? DS3231_STAT_A2F : 0));
+    if (!disparou) return false;
+
+    return agenda_grade_a_partir_de(i2c, regs, grade);
+}
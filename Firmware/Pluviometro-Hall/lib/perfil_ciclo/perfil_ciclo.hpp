@@ -0,0 +1,158 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  perfil_ciclo.hpp
+ *
+ *    Description:  Instrumentação do ciclo de despertar: marcas de tempo por fase
+ *                  (time_us_64) em um buffer circular, despejadas periodicamente
+ *                  pela UART em CSV ou em quadros binários.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 16:05:31
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#ifndef PERFIL_CICLO_HPP
+#define PERFIL_CICLO_HPP
+
+/* Sem dependência do Arduino: o formato também é usado pelo analisador no host */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/****************************************************************************
+**                            CONFIGURAÇÃO
+*****************************************************************************/
+
+/* Quantidade de marcas no buffer circular (potência de 2) */
+#define PERFIL_TAM_ANEL               128
+
+/* Despejando as marcas pela UART a cada N ciclos (o próprio despejo é medido) */
+#define PERFIL_CICLOS_POR_DESPEJO     8
+
+/*
+ * Fases do ciclo. Cada marca registra o FIM da fase indicada; a duração é a
+ * diferença para a marca anterior do mesmo ciclo. PERFIL_BOOT e
+ * PERFIL_DESPERTOU abrem um ciclo, PERFIL_DORMIR fecha. Uma fase pode ser
+ * marcada mais de uma vez no mesmo ciclo (ex.: vários envios pela UART).
+*/
+typedef enum {
+    PERFIL_BOOT = 0,        /* Início do setup() */
+    PERFIL_DESPERTOU,       /* Retorno do __wfi(), ainda com clocks do sono */
+    PERFIL_CLOCKS,          /* Restauração dos clocks (recover_from_sleep) */
+    PERFIL_RADIO,           /* Inicialização do rádio (SPI + radio.begin) */
+    PERFIL_SESSAO,          /* Ativação/gravação da sessão LoRaWAN */
+    PERFIL_SENSOR,          /* Leitura dos sensores */
+    PERFIL_UART,            /* Mensagens pela UART (bloqueantes) */
+    PERFIL_ENVIO,           /* sendReceive (TX + janelas de RX) */
+    PERFIL_RTC,             /* Tratamento e reagendamento do alarme */
+    PERFIL_ESPERA,          /* Espera ativa (sleep_ms) */
+    PERFIL_DESPEJO,         /* Despejo do próprio perfil pela UART */
+    PERFIL_DORMIR,          /* Entrada no sono (fim do ciclo) */
+    PERFIL_NUM_FASES
+} FasePerfil;
+
+/* Marca registrada no buffer circular (8 bytes) */
+typedef struct {
+    uint32_t t_us;          /* 32 bits inferiores de time_us_64() */
+    uint16_t ciclo;         /* Contador de ciclos (incrementado em PERFIL_DESPERTOU) */
+    uint8_t  fase;          /* FasePerfil */
+    uint8_t  clock;         /* clk_sys e VSEL no fim da fase, 0 = desconhecido */
+} MarcaPerfil;
+
+/*
+ * Clock da fase em um byte: VSEL do regulador do núcleo nos 4 bits altos e o
+ * índice de clk_sys em perfil_mhz_clock nos 4 bits baixos. É o clock do fim
+ * da fase: as trocas de clock ficam logo depois de uma marca, de modo que só a
+ * própria fase PERFIL_CLOCKS mistura dois clocks.
+*/
+#define PERFIL_NUM_MHZ_CLOCK          5
+#define PERFIL_CLOCK_VSEL(c)          ((uint8_t)((c) >> 4))
+#define PERFIL_CLOCK_INDICE(c)        ((uint8_t)((c) & 0x0F))
+
+/*
+ * Formato CSV: uma linha por marca, misturada às demais mensagens da UART
+ *   P,<ciclo>,<fase>,<t_us>,<clock>
+ *   P!,<marcas perdidas por sobrescrita>
+ *
+ * Formato binário (PERFIL_FORMATO_BINARIO): um quadro por despejo
+ *   [0xA5][0x5A][n][perdidas (saturado em 255)][n x MarcaPerfil little-endian][xor]
+ * O xor cobre os bytes de n até a última marca.
+*/
+#define PERFIL_SINC_0                 0xA5
+#define PERFIL_SINC_1                 0x5A
+#define PERFIL_TAM_MARCA              8
+#define PERFIL_MAX_POR_QUADRO         255
+
+/****************************************************************************
+**                            FUNÇÕES AUXILIARES DE USO
+*****************************************************************************/
+
+typedef struct uart_inst uart_inst_t;
+
+/**
+ * @brief Registra a marca de fim da fase indicada
+*/
+void perfil_marca(FasePerfil fase);
+
+/**
+ * @brief Fecha o ciclo (PERFIL_DORMIR), despejando o perfil pela UART a cada
+ *        PERFIL_CICLOS_POR_DESPEJO ciclos
+*/
+void perfil_encerra_ciclo(uart_inst_t *uart);
+
+/**
+ * @brief Envia pela UART as marcas ainda não despejadas
+*/
+void perfil_despeja(uart_inst_t *uart);
+
+/**
+ * @brief Nome curto da fase (usado no analisador)
+*/
+const char *perfil_nome_fase(uint8_t fase);
+
+/**
+ * @brief Degraus de clk_sys conhecidos (MHz), indexados pelo byte de clock das marcas
+*/
+extern const uint8_t perfil_mhz_clock[PERFIL_NUM_MHZ_CLOCK];
+
+/**
+ * @brief Codifica clk_sys e o VSEL do regulador no byte de clock (0 se fora dos degraus)
+*/
+uint8_t perfil_codifica_clock(uint32_t sys_hz, uint8_t vsel);
+
+/**
+ * @brief clk_sys em MHz e tensão do núcleo em V de um byte de clock (false se desconhecido)
+*/
+bool perfil_decodifica_clock(uint8_t clock, uint32_t *mhz, float *volts);
+
+/**
+ * @brief Serializa uma marca em 8 bytes little-endian
+*/
+void perfil_serializa_marca(const MarcaPerfil *marca, uint8_t *dst);
+
+/**
+ * @brief Reconstrói uma marca a partir de 8 bytes little-endian
+*/
+void perfil_desserializa_marca(const uint8_t *src, MarcaPerfil *marca);
+
+/*
+ * A instrumentação só é compilada com -D PERFIL_CICLO; sem a flag as chamadas
+ * desaparecem e o ciclo não paga nenhum custo.
+*/
+#ifdef PERFIL_CICLO
+#define PERFIL_MARCA(fase)            perfil_marca(fase)
+#define PERFIL_ENCERRA_CICLO(uart)    perfil_encerra_ciclo(uart)
+#else
+#define PERFIL_MARCA(fase)            ((void)0)
+#define PERFIL_ENCERRA_CICLO(uart)    ((void)0)
+#endif
+
+#endif
+/*****************************END OF FILE**************************************/
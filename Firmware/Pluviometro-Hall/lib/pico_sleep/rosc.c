@@ -16,16 +16,90 @@ uint32_t next_rosc_code(uint32_t code) {
     return ((code | 0x08888888u) + 1u) & 0xf7777777u;
 }
 
-uint rosc_find_freq(uint32_t low_mhz, uint32_t high_mhz) {
-    // TODO: This could be a lot better
+// Last calibration, kept in RAM so that later wakes can skip the search
+static uint32_t _calibrated_target_khz;
+static uint32_t _calibrated_code;
+static uint32_t _calibrated_khz;
+
+uint32_t rosc_code_for_level(uint level) {
+    assert(level < ROSC_DRIVE_LEVELS);
+    uint32_t code = 0;
+    for (uint stage = 0; stage < 8; stage++) {
+        uint bits = level / 8 + (stage < level % 8 ? 1 : 0);
+        code |= ((1u << bits) - 1u) << (stage * 4);
+    }
+    return code;
+}
+
+static uint32_t rosc_measure_khz(uint32_t code) {
+    rosc_set_freq(code);
+    return frequency_count_khz(CLOCKS_FC0_SRC_VALUE_ROSC_CLKSRC);
+}
+
+uint32_t rosc_calibrate(uint32_t target_khz) {
     rosc_set_div(1);
-    for (uint32_t code = 0; code <= 0x77777777u; code = next_rosc_code(code)) {
-        rosc_set_freq(code);
-        uint rosc_mhz = frequency_count_khz(CLOCKS_FC0_SRC_VALUE_ROSC_CLKSRC) / 1000;
-        if ((rosc_mhz >= low_mhz) && (rosc_mhz <= high_mhz)) {
-            return rosc_mhz;
+
+    // Largest level whose frequency is <= target_khz
+    uint low = 0, high = ROSC_DRIVE_LEVELS - 1;
+    uint best_level = 0;
+    uint32_t best_khz = 0;
+    while (low <= high) {
+        uint mid = (low + high) / 2;
+        uint32_t khz = rosc_measure_khz(rosc_code_for_level(mid));
+        if (khz <= target_khz) {
+            best_level = mid;
+            best_khz = khz;
+            low = mid + 1;
+        } else if (mid == 0) {
+            break;
+        } else {
+            high = mid - 1;
         }
     }
+
+    uint32_t code = rosc_code_for_level(best_level);
+    if (best_khz == 0) {
+        // Even the slowest setting is above the target: settle for it
+        best_khz = rosc_measure_khz(code);
+    } else {
+        rosc_set_freq(code);
+    }
+
+    _calibrated_target_khz = target_khz;
+    _calibrated_code = code;
+    _calibrated_khz = best_khz;
+    return best_khz;
+}
+
+uint32_t rosc_restore_calibration(uint32_t target_khz, uint32_t tolerance_khz) {
+    if (_calibrated_khz == 0 || _calibrated_target_khz != target_khz) {
+        return rosc_calibrate(target_khz);
+    }
+
+    rosc_set_div(1);
+    uint32_t khz = rosc_measure_khz(_calibrated_code);
+    uint32_t drift = (khz > _calibrated_khz) ? khz - _calibrated_khz : _calibrated_khz - khz;
+    // Above the target is only acceptable when it was already the slowest setting
+    if (drift > tolerance_khz || (khz > target_khz && _calibrated_code != rosc_code_for_level(0))) {
+        return rosc_calibrate(target_khz);
+    }
+    _calibrated_khz = khz;
+    return khz;
+}
+
+uint32_t rosc_calibrated_code(void) {
+    return _calibrated_code;
+}
+
+uint32_t rosc_calibrated_khz(void) {
+    return _calibrated_khz;
+}
+
+uint rosc_find_freq(uint32_t low_mhz, uint32_t high_mhz) {
+    uint rosc_mhz = rosc_calibrate(high_mhz * 1000 + 999) / 1000;
+    if ((rosc_mhz >= low_mhz) && (rosc_mhz <= high_mhz)) {
+        return rosc_mhz;
+    }
     return 0;
 }
 
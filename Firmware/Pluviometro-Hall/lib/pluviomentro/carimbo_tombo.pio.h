@@ -0,0 +1,44 @@
+// -------------------------------------------------- //
+// This file is autogenerated by pioasm; do not edit! //
+// -------------------------------------------------- //
+
+#pragma once
+
+#if !PICO_NO_HARDWARE
+#include "hardware/pio.h"
+#endif
+
+// ------------- //
+// carimbo_tombo //
+// ------------- //
+
+#define carimbo_tombo_wrap_target 7
+#define carimbo_tombo_wrap 8
+
+static const uint16_t carimbo_tombo_program_instructions[] = {
+    0x0041, //  0: jmp    x--, 1
+    0x00c0, //  1: jmp    pin, 0
+    0xa0c9, //  2: mov    isr, ~x
+    0x8100, //  3: push   noblock                [1]
+    0xa047, //  4: mov    y, osr
+    0x0046, //  5: jmp    x--, 6
+    0x0085, //  6: jmp    y--, 5
+            //     .wrap_target
+    0x0048, //  7: jmp    x--, 8
+    0x00c0, //  8: jmp    pin, 0
+            //     .wrap
+};
+
+#if !PICO_NO_HARDWARE
+static const struct pio_program carimbo_tombo_program = {
+    .instructions = carimbo_tombo_program_instructions,
+    .length = 9,
+    .origin = -1,
+};
+
+static inline pio_sm_config carimbo_tombo_program_get_default_config(uint offset) {
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + carimbo_tombo_wrap_target, offset + carimbo_tombo_wrap);
+    return c;
+}
+#endif
@@ -0,0 +1,173 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  carimbos_chuva.cpp
+ *
+ *    Description:  -
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 18:58:03
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include "carimbos_chuva.hpp"
+#include <string.h>
+#include "pluviometro.hpp"
+#include "carimbo_tombo.pio.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/clocks.h"
+
+/* Limites superiores das classes de intensidade (0,01 mm/h); a última classe é aberta */
+static const uint32_t limites_classes[CARIMBOS_NUM_CLASSES - 1] = { 1000, 3000, 6000, 10000 };
+
+/* Anel preenchido pelo DMA; o alinhamento é exigido pelo modo ring do endereço de escrita */
+static uint32_t anel[CARIMBOS_TAM_ANEL] __attribute__((aligned(CARIMBOS_TAM_ANEL * sizeof(uint32_t))));
+
+static PIO pio_carimbo = pio0;
+static uint sm_carimbo;
+static int canal_dma = -1;
+
+/* Estado do processamento, preservado na RAM entre despertares (índices absolutos) */
+static uint32_t lidos = 0;
+static uint32_t inicio_1min = 0;
+static uint32_t inicio_5min = 0;
+static uint32_t minuto_aberto = 0;
+static uint16_t tombos_minuto = 0;
+
+/**
+ * @brief Carrega o programa carimbo_tombo e liga a FIFO RX ao anel pelo DMA.
+ *
+ * O pino continua com a função PWM (contagem bruta de bordas): a PIO lê a
+ * entrada do pad independentemente da função selecionada.
+*/
+bool inicializa_carimbos_chuva(uint gpio) {
+  if (!pio_can_add_program(pio_carimbo, &carimbo_tombo_program)) return false;
+
+  /* Carregando o programa e configurando a SM (FIFO RX com 8 posições) */
+  uint offset = pio_add_program(pio_carimbo, &carimbo_tombo_program);
+  sm_carimbo = (uint)pio_claim_unused_sm(pio_carimbo, true);
+
+  pio_sm_config cfg = carimbo_tombo_program_get_default_config(offset);
+  sm_config_set_jmp_pin(&cfg, gpio);
+  pio_sm_init(pio_carimbo, sm_carimbo, offset, &cfg);
+
+  /* Deixando no OSR o tempo de bloqueio após cada tombo (espaçamento mínimo - 1, em ticks);
+     a FIFO TX ainda existe aqui e o OSR não é alterado quando ela é unida à RX */
+  pio_sm_put(pio_carimbo, sm_carimbo, (uint32_t)DEBOUNCE_DELAY * CARIMBOS_TICKS_HZ / 1000 - 1);
+  pio_sm_exec(pio_carimbo, sm_carimbo, pio_encode_pull(false, false));
+  sm_config_set_fifo_join(&cfg, PIO_FIFO_JOIN_RX);
+  pio_sm_set_config(pio_carimbo, sm_carimbo, &cfg);
+
+  /* Iniciando X em 0xFFFFFFFF, de modo que ~X seja o número de ticks decorridos */
+  pio_sm_exec(pio_carimbo, sm_carimbo, pio_encode_mov_not(pio_x, pio_null));
+  carimbos_ajusta_clock();
+
+  /* Configurando o DMA: FIFO RX -> anel, com escrita circular e disparo pelo DREQ da SM */
+  canal_dma = dma_claim_unused_channel(true);
+  dma_channel_config dma_cfg = dma_channel_get_default_config(canal_dma);
+  channel_config_set_transfer_data_size(&dma_cfg, DMA_SIZE_32);
+  channel_config_set_read_increment(&dma_cfg, false);
+  channel_config_set_write_increment(&dma_cfg, true);
+  channel_config_set_ring(&dma_cfg, true, CARIMBOS_BITS_ANEL);
+  channel_config_set_dreq(&dma_cfg, pio_get_dreq(pio_carimbo, sm_carimbo, false));
+  dma_channel_configure(canal_dma, &dma_cfg, anel, &pio_carimbo->rxf[sm_carimbo], 0xFFFFFFFFu, true);
+
+  pio_sm_set_enabled(pio_carimbo, sm_carimbo, true);
+  return true;
+}
+
+/**
+ * @brief Mantém 1 tick = 1 ms: o programa decrementa X a cada 2 ciclos da SM.
+ *
+ * Deve ser chamada após sleep_run_from_xosc() e após a restauração dos clocks;
+ * entre a mudança de clk_sys e a chamada os ticks saem com a escala antiga.
+*/
+void carimbos_ajusta_clock(void) {
+  float divisor = (float)clock_get_hz(clk_sys) / (2.0f * CARIMBOS_TICKS_HZ);
+  pio_sm_set_clkdiv(pio_carimbo, sm_carimbo, divisor);
+}
+
+/* Carimbos escritos pelo DMA desde o início (o contador de transferências decresce) */
+static uint32_t carimbos_escritos(void) {
+  return 0xFFFFFFFFu - dma_channel_hw_addr(canal_dma)->transfer_count;
+}
+
+uint32_t carimbos_total_tombos(void) {
+  return (canal_dma < 0) ? 0 : carimbos_escritos();
+}
+
+/* Carimbo de índice absoluto k, compensando os 2 ticks perdidos em cada um dos k tombos anteriores */
+static uint32_t carimbo(uint32_t k) {
+  return anel[k & (CARIMBOS_TAM_ANEL - 1)] + 2 * k;
+}
+
+/* Intensidade em 0,01 mm/h para n tombos em uma janela de 'minutos' */
+static uint32_t intensidade_centesimos_h(uint32_t n, uint32_t minutos) {
+  return (uint32_t)(((uint64_t)n * PRECIPITACAO_MICRO_MM * 60 / minutos + 5000) / 10000);
+}
+
+static void fecha_minuto(IntensidadeChuva *intensidade) {
+  uint32_t valor = intensidade_centesimos_h(tombos_minuto, 1);
+  uint8_t classe = 0;
+  while (classe < CARIMBOS_NUM_CLASSES - 1 && valor >= limites_classes[classe]) classe++;
+  intensidade->minutos_classe[classe]++;
+}
+
+/**
+ * @brief Processa os carimbos chegados desde a leitura anterior.
+ *
+ * Os picos usam janelas deslizantes de 1 e 5 min que podem começar em carimbos
+ * de despertares anteriores (ainda no anel). Um minuto entra no histograma
+ * quando chega um tombo de um minuto posterior, então o último minuto com
+ * chuva fica pendente até a próxima leitura.
+*/
+void le_intensidade_chuva(IntensidadeChuva *intensidade) {
+  memset(intensidade, 0, sizeof(*intensidade));
+  if (canal_dma < 0) return;
+
+  uint32_t escritos = carimbos_escritos();
+
+  /* Descartando carimbos já sobrescritos no anel */
+  if (escritos - lidos > CARIMBOS_TAM_ANEL) {
+    intensidade->perdidos = escritos - lidos - CARIMBOS_TAM_ANEL;
+    lidos = escritos - CARIMBOS_TAM_ANEL;
+  }
+  uint32_t mais_antigo = (escritos > CARIMBOS_TAM_ANEL) ? escritos - CARIMBOS_TAM_ANEL : 0;
+  if (inicio_1min < mais_antigo) inicio_1min = mais_antigo;
+  if (inicio_5min < mais_antigo) inicio_5min = mais_antigo;
+
+  uint32_t pico_1min = 0, pico_5min = 0;
+
+  for (uint32_t k = lidos; k != escritos; k++) {
+    uint32_t t = carimbo(k);
+
+    /* Janelas deslizantes: tombos nos últimos 1 e 5 minutos até este carimbo */
+    while (t - carimbo(inicio_1min) >= CARIMBOS_TICKS_MINUTO) inicio_1min++;
+    while (t - carimbo(inicio_5min) >= 5 * CARIMBOS_TICKS_MINUTO) inicio_5min++;
+    if (k - inicio_1min + 1 > pico_1min) pico_1min = k - inicio_1min + 1;
+    if (k - inicio_5min + 1 > pico_5min) pico_5min = k - inicio_5min + 1;
+
+    /* Histograma por minuto do relógio da SM */
+    uint32_t minuto = t / CARIMBOS_TICKS_MINUTO;
+    if (tombos_minuto && minuto != minuto_aberto) {
+      fecha_minuto(intensidade);
+      tombos_minuto = 0;
+    }
+    minuto_aberto = minuto;
+    tombos_minuto++;
+  }
+
+  intensidade->carimbos = escritos - lidos;
+  intensidade->pico_1min = intensidade_centesimos_h(pico_1min, 1);
+  intensidade->pico_5min = intensidade_centesimos_h(pico_5min, 5);
+  lidos = escritos;
+}
+
+/*****************************END OF FILE**************************************/
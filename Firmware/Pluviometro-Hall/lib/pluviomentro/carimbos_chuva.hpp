@@ -0,0 +1,80 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  carimbos_chuva.hpp
+ *
+ *    Description:  Carimbos de tempo dos tombos (PIO + DMA em anel, sem acordar a
+ *                  CPU) e cálculo da intensidade da chuva a cada despertar: picos
+ *                  em 1 e 5 minutos e histograma de minutos por classe de intensidade.
+ *                  A PIO descarta bordas a menos de DEBOUNCE_DELAY ms do último
+ *                  tombo, então os carimbos também são a contagem sem repique.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 18:52:20
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#ifndef CARIMBOS_CHUVA_HPP
+#define CARIMBOS_CHUVA_HPP
+
+#include <Arduino.h>
+
+/****************************************************************************
+**                            CONFIGURAÇÃO
+*****************************************************************************/
+
+/* Carimbos no anel do DMA (potência de 2); o anel é alinhado ao próprio tamanho */
+#define CARIMBOS_TAM_ANEL             256
+#define CARIMBOS_BITS_ANEL            10      /* log2(CARIMBOS_TAM_ANEL * 4 bytes) */
+
+/* Resolução dos carimbos: 1 ms (o contador de 32 bits dá a volta em ~49 dias) */
+#define CARIMBOS_TICKS_HZ             1000
+#define CARIMBOS_TICKS_MINUTO         (60UL * CARIMBOS_TICKS_HZ)
+
+/* Classes de intensidade do histograma: limites em 0,01 mm/h (< 10, < 30, < 60, < 100, >= 100 mm/h) */
+#define CARIMBOS_NUM_CLASSES          5
+
+/****************************************************************************
+**                            ESTRUTURAS
+*****************************************************************************/
+
+typedef struct {
+    uint32_t carimbos;                                /* Carimbos processados nesta leitura */
+    uint32_t perdidos;                                /* Sobrescritos no anel antes da leitura */
+    uint32_t pico_1min;                               /* Maior intensidade em 1 min (0,01 mm/h) */
+    uint32_t pico_5min;                               /* Maior intensidade em 5 min (0,01 mm/h) */
+    uint16_t minutos_classe[CARIMBOS_NUM_CLASSES];    /* Minutos com chuva em cada classe */
+} IntensidadeChuva;
+
+/****************************************************************************
+**                            FUNÇÕES AUXILIARES DE USO
+*****************************************************************************/
+
+/**
+ * @brief Carrega o programa de carimbo na PIO e liga o DMA ao anel
+*/
+bool inicializa_carimbos_chuva(uint gpio);
+
+/**
+ * @brief Reajusta o divisor da SM após qualquer mudança de clk_sys (mantém 1 tick = 1 ms)
+*/
+void carimbos_ajusta_clock(void);
+
+/**
+ * @brief Tombos aceitos pela PIO desde a inicialização (bordas de repique excluídas)
+*/
+uint32_t carimbos_total_tombos(void);
+
+/**
+ * @brief Processa os carimbos novos e calcula a intensidade desde a leitura anterior
+*/
+void le_intensidade_chuva(IntensidadeChuva *intensidade);
+
+#endif
+/*****************************END OF FILE**************************************/
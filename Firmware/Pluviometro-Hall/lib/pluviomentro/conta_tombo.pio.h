@@ -0,0 +1,40 @@
+// -------------------------------------------------- //
+// This file is autogenerated by pioasm; do not edit! //
+// -------------------------------------------------- //
+
+#pragma once
+
+#if !PICO_NO_HARDWARE
+#include "hardware/pio.h"
+#endif
+
+// ----------- //
+// conta_tombo //
+// ----------- //
+
+#define conta_tombo_wrap_target 4
+#define conta_tombo_wrap 4
+
+static const uint16_t conta_tombo_program_instructions[] = {
+    0x00c0, //  0: jmp    pin, 0
+    0x0042, //  1: jmp    x--, 2
+    0xa047, //  2: mov    y, osr
+    0x0183, //  3: jmp    y--, 3                 [1]
+            //     .wrap_target
+    0x00c0, //  4: jmp    pin, 0
+            //     .wrap
+};
+
+#if !PICO_NO_HARDWARE
+static const struct pio_program conta_tombo_program = {
+    .instructions = conta_tombo_program_instructions,
+    .length = 5,
+    .origin = -1,
+};
+
+static inline pio_sm_config conta_tombo_program_get_default_config(uint offset) {
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + conta_tombo_wrap_target, offset + conta_tombo_wrap);
+    return c;
+}
+#endif
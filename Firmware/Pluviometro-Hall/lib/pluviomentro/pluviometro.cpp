@@ -18,10 +18,80 @@
 
 #include "pluviometro.hpp"
 #include "hardware/pwm.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/gpio.h"
+#include "hardware/structs/iobank0.h"
+#include "hardware/pio.h"
+#include "hardware/clocks.h"
+#include "pico/time.h"
+#include "conta_tombo.pio.h"
+#include "../despachante_despertar/despachante_despertar.hpp"
+
+/* Resolução do bloqueio do contador da PIO: 1 tick = 1 ms */
+#define CONTADOR_TICKS_HZ 1000
 
 
 uint slice_num;
 
+/* Voltas completas do contador PWM de 16 bits (incrementado na interrupção de wrap) */
+static volatile uint32_t voltas_contador = 0;
+
+/* Total de tombos na leitura anterior (a RAM é preservada durante o sono) */
+static uint32_t total_anterior = 0;
+
+/* Contador da PIO com filtro de repique (-1: programa não carregado, vale a contagem bruta) */
+static PIO pio_contador = pio0;
+static int sm_contador = -1;
+
+/**
+ * @brief Trata o wrap do contador PWM (0xFFFF -> 0).
+ *
+ * Só ocorre a cada 65536 tombos, então o despertar extra causado por ela é
+ * irrelevante no consumo, mas garante que nenhuma volta seja perdida.
+*/
+static void trata_wrap_pwm(void) {
+  pwm_clear_irq(slice_num);
+  voltas_contador++;
+
+  /* O despertar causado pelo wrap não abre um ciclo: o evento só é contado */
+  sinaliza_despertar(DESPERTAR_CONTADOR, (uint8_t)slice_num, voltas_contador);
+}
+
+/**
+ * @brief Carrega o programa conta_tombo, que conta as bordas de descida do pino com o
+ *        mesmo bloqueio de DEBOUNCE_DELAY ms do carimbo_tombo.
+ *
+ * A PIO lê a entrada do pad independentemente da função selecionada, então o pino
+ * segue com a função PWM. Só PIO0 precisa de clock no sono (sem DMA nem SRAM).
+*/
+static bool inicializa_contador_pio(uint8_t gpio) {
+  if (!pio_can_add_program(pio_contador, &conta_tombo_program)) return false;
+  int sm = pio_claim_unused_sm(pio_contador, false);
+  if (sm < 0) return false;
+  uint offset = pio_add_program(pio_contador, &conta_tombo_program);
+
+  /* Autopush de 32 bits: um "in x, 32" executado pelo firmware entrega X na FIFO RX */
+  pio_sm_config cfg = conta_tombo_program_get_default_config(offset);
+  sm_config_set_jmp_pin(&cfg, gpio);
+  sm_config_set_in_shift(&cfg, false, true, 32);
+
+  /* Partindo do .wrap_target: com o pino em nível baixo no boot, só a próxima descida conta */
+  pio_sm_init(pio_contador, (uint)sm, offset + conta_tombo_wrap_target, &cfg);
+
+  /* Deixando no OSR o tempo de bloqueio após cada tombo (espaçamento mínimo - 1, em ticks) */
+  pio_sm_put(pio_contador, (uint)sm, (uint32_t)DEBOUNCE_DELAY * CONTADOR_TICKS_HZ / 1000 - 1);
+  pio_sm_exec(pio_contador, (uint)sm, pio_encode_pull(false, false));
+
+  /* Iniciando X em 0xFFFFFFFF, de modo que ~X seja o número de tombos */
+  pio_sm_exec(pio_contador, (uint)sm, pio_encode_mov_not(pio_x, pio_null));
+
+  sm_contador = sm;
+  pluviometro_ajusta_clock();
+  pio_sm_set_enabled(pio_contador, (uint)sm, true);
+  return true;
+}
+
 void inicializa_sensor_pluviometro(uint8_t gpio) {
   /* Inicializando GPIO do sensor Hall como entrada com pull-up interno */
   gpio_init(gpio);
@@ -47,8 +117,177 @@ void inicializa_sensor_pluviometro(uint8_t gpio) {
   /* Definindo a função da GPIO como saída de PWM */
   gpio_set_function(gpio, GPIO_FUNC_PWM);
 
+  /* Habilitando a interrupção de wrap para estender o contador para 32 bits */
+  pwm_clear_irq(slice_num);
+  pwm_set_irq_enabled(slice_num, true);
+  irq_set_exclusive_handler(PWM_IRQ_WRAP, trata_wrap_pwm);
+  irq_set_enabled(PWM_IRQ_WRAP, true);
+
   /* Ativando o PWM para iniciar a contagem de pulsos */
   pwm_set_enabled(slice_num, true);
+
+  /* Contagem sem repique na PIO; o PWM fica como contagem bruta para o diagnóstico */
+  if (!inicializa_contador_pio(gpio)) {
+    uart_puts(uart0, "ERROR - PIO sem espaco para o contador de tombos\n\r");
+  }
+}
+
+/**
+ * @brief Mantém 1 tick = 1 ms: o laço de bloqueio gasta 2 ciclos da SM por tick.
+ *
+ * Deve ser chamada após sleep_run_from_xosc() e após a restauração dos clocks;
+ * entre a mudança de clk_sys e a chamada o bloqueio sai com a escala antiga.
+*/
+void pluviometro_ajusta_clock(void) {
+  if (sm_contador < 0) return;
+  float divisor = (float)clock_get_hz(clk_sys) / (2.0f * CONTADOR_TICKS_HZ);
+  pio_sm_set_clkdiv(pio_contador, (uint)sm_contador, divisor);
+}
+
+/**
+ * @brief Retorna o total de tombos desde o boot em 32 bits.
+ *
+ * Com as interrupções desabilitadas, um wrap ainda não atendido aparece como
+ * pendente em INTR: nesse caso a volta é somada e o contador relido, pois ele
+ * já recomeçou de 0 (mesmo que o wrap tenha ocorrido logo após a primeira leitura).
+*/
+uint32_t pluviometro_total_tombos(void) {
+  uint32_t estado = save_and_disable_interrupts();
+
+  uint32_t voltas = voltas_contador;
+  uint16_t contador = pwm_get_counter(slice_num);
+
+  if (pwm_get_irq_status_mask() & (1u << slice_num)) {
+    voltas++;
+    contador = pwm_get_counter(slice_num);
+  }
+
+  restore_interrupts(estado);
+  return (voltas << 16) | contador;
+}
+
+/**
+ * @brief Lê X da SM sem pará-la: o "in x, 32" executado é empurrado pelo autopush.
+ *
+ * A instrução é inserida entre duas do programa, então X sai antes ou depois do
+ * decremento de um tombo simultâneo, nunca pela metade.
+*/
+uint32_t pluviometro_tombos_filtrados(void) {
+  if (sm_contador < 0) return pluviometro_total_tombos();
+  pio_sm_exec(pio_contador, (uint)sm_contador, pio_encode_in(pio_x, 32));
+  return ~pio_sm_get_blocking(pio_contador, (uint)sm_contador);
+}
+
+/**
+ * @brief Lê os tombos do intervalo sem zerar os contadores.
+ *
+ * Zerar o contador após a leitura perde os tombos que chegam entre as duas
+ * operações; aqui o contador segue livre e o intervalo é a diferença para o
+ * total anterior (aritmética modular de 32 bits).
+*/
+void le_pluviometro(LeituraPluviometro *leitura) {
+  le_pluviometro_total(leitura, pluviometro_tombos_filtrados());
+}
+
+/**
+ * @brief Calcula a leitura a partir de um total de tombos desde o boot.
+ *
+ * O total deve ser sempre da mesma fonte entre leituras (PIO, ou GPIO no dormant).
+*/
+void le_pluviometro_total(LeituraPluviometro *leitura, uint32_t total) {
+  leitura->total_tombos = total;
+  leitura->tombos_intervalo = total - total_anterior;
+  leitura->chuva_centesimos = tombos_para_centesimos_mm(leitura->tombos_intervalo);
+  leitura->total_centesimos = tombos_para_centesimos_mm(total);
+
+  total_anterior = total;
+}
+
+
+/* ============================================================================
+ *  Contagem por GPIO (modo dormant)
+ * ============================================================================
+*/
+
+static uint8_t gpio_sensor;
+static volatile uint32_t tombos_gpio = 0;
+static volatile uint32_t ultimo_tombo_us = 0;
+static volatile uint32_t ultima_borda_us = 0;
+static volatile bool janela_ativa = false;   /* Bordas até DEBOUNCE_DELAY após o tombo são repique */
+
+static void registra_tombo(uint32_t agora) {
+  tombos_gpio++;
+  ultimo_tombo_us = agora;
+  ultima_borda_us = agora;
+  janela_ativa = true;
+}
+
+void inicializa_pluviometro_gpio(uint8_t gpio) {
+  /* Inicializando GPIO do sensor Hall como entrada com pull-up interno */
+  gpio_sensor = gpio;
+  gpio_init(gpio);
+  gpio_pull_up(gpio);
+  gpio_set_dir(gpio, GPIO_IN);
+
+  /* Habilitando a interrupção na borda de descida; o callback é o do despachante dos despertares */
+  gpio_set_irq_enabled(gpio, GPIO_IRQ_EDGE_FALL, true);
+}
+
+/**
+ * @brief Conta a borda como tombo se estiver fora da janela do tombo anterior.
+ *
+ * A janela usa o timer, que para em dormant: por isso ela só vale enquanto o
+ * núcleo está acordado e é encerrada em pluviometro_aguarda_silencio().
+*/
+bool pluviometro_trata_borda(void) {
+  uint32_t agora = time_us_32();
+  ultima_borda_us = agora;
+  if (janela_ativa && agora - ultimo_tombo_us < DEBOUNCE_DELAY * 1000UL) return false;
+  registra_tombo(agora);
+  return true;
+}
+
+/**
+ * @brief Verifica no status de despertar do dormant se a borda do sensor ocorreu.
+ *
+ * O status cobre também o tombo simultâneo ao alarme do RTC. Se a borda já tiver
+ * sido contada pelo callback ao sair do dormant, a janela ativa evita a dupla contagem.
+*/
+void pluviometro_verifica_despertar(void) {
+  uint32_t bit = (uint32_t)GPIO_IRQ_EDGE_FALL << (4 * (gpio_sensor % 8));
+  if (!(io_bank0_hw->dormant_wake_irq_ctrl.ints[gpio_sensor / 8] & bit)) return;
+
+  gpio_acknowledge_irq(gpio_sensor, GPIO_IRQ_EDGE_FALL);
+  pluviometro_trata_borda();
+}
+
+/**
+ * @brief Mantém o núcleo acordado até o sensor ficar em nível alto e sem bordas por
+ *        PLUVIOMETRO_SILENCIO_US, ou até DEBOUNCE_DELAY após o tombo.
+ *
+ * Uma borda de repique depois de entrar em dormant despertaria o núcleo e seria
+ * contada como outro tombo. Sem tombo recente a função retorna de imediato.
+*/
+void pluviometro_aguarda_silencio(void) {
+  if (!janela_ativa) return;
+
+  while (time_us_32() - ultimo_tombo_us < DEBOUNCE_DELAY * 1000UL) {
+    if (gpio_get(gpio_sensor) && time_us_32() - ultima_borda_us >= PLUVIOMETRO_SILENCIO_US) break;
+    busy_wait_us_32(100);
+  }
+  janela_ativa = false;
+}
+
+uint32_t pluviometro_tombos_gpio(void) {
+  return tombos_gpio;
+}
+
+/**
+ * @brief Converte tombos para chuva em 0,01 mm, com intermediário de 64 bits
+ *        (sem erro acumulado de ponto flutuante)
+*/
+uint32_t tombos_para_centesimos_mm(uint32_t tombos) {
+  return (uint32_t)(((uint64_t)tombos * PRECIPITACAO_MICRO_MM + 5000) / 10000);
 }
 
 /*****************************END OF FILE**************************************/
\ No newline at end of file
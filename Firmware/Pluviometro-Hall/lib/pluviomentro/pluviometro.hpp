@@ -22,9 +22,97 @@
 #include <Arduino.h>
 
 #define SENSOR_HALL_PIN 7       /* gpio sensor hall */
+
+/* Espaçamento mínimo entre tombos (ms): bordas mais próximas são repique do ímã e são
+   descartadas pela PIO (conta_tombo e carimbo_tombo). Configurável com -D DEBOUNCE_DELAY=... */
+#ifndef DEBOUNCE_DELAY
 #define DEBOUNCE_DELAY 200      /* Debounce de 200 ms */
+#endif
 #define PRECIPITACAO  0.526132  /* Precipitação por tombo: mm */
 
+/* Contagem por GPIO (modo dormant): antes de voltar ao dormant o sinal do sensor deve ficar
+   sem bordas por este tempo (us), limitado a DEBOUNCE_DELAY após o tombo */
+#ifndef PLUVIOMETRO_SILENCIO_US
+#define PLUVIOMETRO_SILENCIO_US 5000
+#endif
+
+/* Precipitação por tombo em milionésimos de mm (mesmo valor de PRECIPITACAO, em inteiro) */
+#define PRECIPITACAO_MICRO_MM   526132UL
+
+/* Leitura do pluviômetro em um despertar; chuva em ponto fixo de 0,01 mm */
+typedef struct {
+    uint32_t total_tombos;        /* Tombos desde o boot (32 bits, incluindo as voltas do contador PWM) */
+    uint32_t tombos_intervalo;    /* Tombos desde a leitura anterior */
+    uint32_t chuva_centesimos;    /* Chuva no intervalo (0,01 mm) */
+    uint32_t total_centesimos;    /* Chuva acumulada desde o boot (0,01 mm) */
+} LeituraPluviometro;
+
+/**
+ * @brief Configura o contador PWM (bordas brutas) e o contador da PIO com filtro de repique
+*/
 void inicializa_sensor_pluviometro(uint8_t gpio);
+
+/**
+ * @brief Reajusta o divisor da SM do contador após qualquer mudança de clk_sys (1 tick = 1 ms)
+*/
+void pluviometro_ajusta_clock(void);
+
+/**
+ * @brief Total de bordas desde o boot: voltas do contador (interrupção de wrap) + contador PWM
+*/
+uint32_t pluviometro_total_tombos(void);
+
+/**
+ * @brief Tombos aceitos pela PIO desde o boot (bordas a menos de DEBOUNCE_DELAY ms do tombo
+ *        anterior excluídas); sem a PIO, a contagem bruta do PWM
+*/
+uint32_t pluviometro_tombos_filtrados(void);
+
+/**
+ * @brief Lê o pluviômetro pela contagem filtrada, sem zerar contadores (subtrai a leitura anterior)
+*/
+void le_pluviometro(LeituraPluviometro *leitura);
+
+/**
+ * @brief Mesma leitura, a partir de um total externo (ex.: tombos filtrados pela PIO)
+*/
+void le_pluviometro_total(LeituraPluviometro *leitura, uint32_t total);
+
+/****************************************************************************
+**                   CONTAGEM POR GPIO (MODO DORMANT)
+*****************************************************************************/
+
+/**
+ * @brief Configura o sensor como entrada com interrupção de borda de descida, sem PWM
+ *        (em dormant não há clock para o contador PWM)
+*/
+void inicializa_pluviometro_gpio(uint8_t gpio);
+
+/**
+ * @brief Trata uma borda do sensor com o núcleo acordado (chamada no callback de GPIO)
+ *
+ * @return true se a borda foi contada como tombo (false: repique)
+*/
+bool pluviometro_trata_borda(void);
+
+/**
+ * @brief Após sair do dormant, conta o tombo se o sensor estiver entre as causas do despertar
+*/
+void pluviometro_verifica_despertar(void);
+
+/**
+ * @brief Aguarda o fim do repique do último tombo antes de voltar ao dormant
+*/
+void pluviometro_aguarda_silencio(void);
+
+/**
+ * @brief Total de tombos contados por GPIO desde o boot
+*/
+uint32_t pluviometro_tombos_gpio(void);
+
+/**
+ * @brief Converte tombos para chuva em 0,01 mm (arredondando)
+*/
+uint32_t tombos_para_centesimos_mm(uint32_t tombos);
 #endif
 /*****************************END OF FILE**************************************/
\ No newline at end of file
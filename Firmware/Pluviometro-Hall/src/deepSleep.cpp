@@ -23,13 +23,20 @@
 #include "hardware/rtc.h"
 #include "hardware/clocks.h"
 #include "hardware/gpio.h"
+#include "hardware/sync.h"
 #include "hardware/xosc.h"
 #include "hardware/structs/scb.h"
+#include "hardware/structs/syscfg.h"
 #include "hardware/uart.h"
 #include "pico/runtime_init.h"
 #include "hardware/pwm.h"
 #include "../lib/pluviomentro/pluviometro.hpp"
+#include "../lib/pluviomentro/carimbos_chuva.hpp"
 #include "../lib/ds3231_rtc/ds3231.hpp"
+#include "../lib/perfil_ciclo/perfil_ciclo.hpp"
+#include "../lib/clock_despertar/clock_despertar.hpp"
+#include "../lib/supervisor_ciclo/supervisor_ciclo.hpp"
+#include "../lib/despachante_despertar/despachante_despertar.hpp"
 
 #define UART_ID uart0
 #define BAUD_RATE 9600
@@ -39,11 +46,95 @@
 #define I2C_SCL_PIN 27
 #define WAKE_GPIO 28
 
+/* Agendamento em grade absoluta: definindo GRADE_PERIODO_MIN (divisor de 1440, ex.: -D GRADE_PERIODO_MIN=15)
+   os despertares ficam alinhados ao relógio do RTC (00:00, 00:15, ...) sem acumular atraso. GRADE_FASE_SEG
+   desloca a grade (escalonamento entre nós ou, com 1440, o horário do envio diário). Sem a definição o
+   alarme é relativo ao fim de cada ciclo */
+#ifdef GRADE_PERIODO_MIN
+#ifndef GRADE_FASE_SEG
+#define GRADE_FASE_SEG 0
+#endif
+static const GradeAlarme grade_alarme = { GRADE_PERIODO_MIN, GRADE_FASE_SEG };
+#endif
+
+/* Carimbos de tempo dos tombos: definindo PLUVIOMETRO_CARIMBOS a PIO registra o instante de
+   cada tombo e o DMA o grava em um anel na RAM durante o sono, sem acordar a CPU. A cada
+   despertar são enviados os picos de intensidade (1 e 5 min) e o histograma por classe. PIO0,
+   DMA e as SRAMs continuam com clock no sono, o que aumenta um pouco a corrente dormindo */
+
+/* Filtro de repique: fora do dormant a chuva é sempre a contagem da PIO (conta_tombo), que
+   ignora bordas a menos de DEBOUNCE_DELAY ms do tombo anterior (repique do ímã, ruído). O
+   contador PWM fica como contagem bruta, e a diferença desde o boot é enviada em |g| */
+
+/* Modo dormant: definindo SONO_DORMANT o núcleo dorme com todos os osciladores parados, em vez
+   do SLEEPDEEP com o XOSC e o clk_sys do PWM ligados. Sem clock, os tombos são contados pela
+   GPIO: cada tombo desperta o núcleo, é somado na RAM e o núcleo volta ao dormant assim que o
+   sinal do sensor se estabiliza. Compensa quando a chuva é rara (ver README) */
+#ifdef SONO_DORMANT
+#ifdef PLUVIOMETRO_CARIMBOS
+#error "PLUVIOMETRO_CARIMBOS precisa de clock para a PIO e o DMA no sono: incompatível com SONO_DORMANT"
+#endif
+#endif
+
+/* Memórias desligadas no sono: definindo SONO_DESLIGA_MEMORIAS a ROM e a SRAM4 (scratch X, sem
+   conteúdo com o core 1 parado) são desligadas pelo SYSCFG durante o __wfi(), assim como a DPRAM
+   do USB com PIO_FRAMEWORK_ARDUINO_NO_USB. A região de retenção são as SRAMs 0-3 (intercaladas,
+   com .data, .bss e heap: sessão, contadores e anéis) e a SRAM5 (pilha do core 0) */
+#ifdef SONO_DESLIGA_MEMORIAS
+static uint32_t memorias_desligadas_no_sono(void) {
+  uint32_t mascara = SYSCFG_MEMPOWERDOWN_ROM_BITS;
+#ifdef PIO_FRAMEWORK_ARDUINO_NO_USB
+  mascara |= SYSCFG_MEMPOWERDOWN_USB_BITS;
+#endif
+  if (sleep_scratch_x_unused()) mascara |= SYSCFG_MEMPOWERDOWN_SRAM4_BITS;
+  return mascara;
+}
+#endif
+
+/* Sono a partir do ROSC: definindo SONO_ROSC_KHZ (ex.: -D SONO_ROSC_KHZ=6000) o sono roda do oscilador
+   em anel e o XOSC fica desligado. A calibração (busca binária contra o XOSC) guarda código e frequência
+   medida na RAM, e os ciclos seguintes só conferem o código com uma contagem, refazendo a busca se a
+   deriva passar de SONO_ROSC_TOLERANCIA_KHZ. Os clocks do sono usam a frequência medida */
+#ifdef SONO_ROSC_KHZ
+#ifndef SONO_ROSC_TOLERANCIA_KHZ
+#define SONO_ROSC_TOLERANCIA_KHZ (SONO_ROSC_KHZ / 50)
+#endif
+#endif
+
+/* Perfis de clock no despertar: definindo CLOCK_DESPERTAR_PERFIS o ciclo acorda em 12 MHz do
+   XOSC, sem religar os PLLs (clocks_init() trava os dois PLLs a cada despertar só para
+   sleep_run_from_xosc() desligá-los de novo). Sem rádio, todos os ciclos
+   usam o perfil dos sensores.
+   UART e I2C têm os divisores reajustados a cada troca de perfil. Com CLOCK_GOVERNADOR a tensão
+   do núcleo também acompanha o perfil (0,95 V nos 12 MHz do XOSC) */
+#ifdef CLOCK_DESPERTAR_PERFIS
+static const PerifericosClock perifericos_clock = { UART_ID, BAUD_RATE, i2c1, 400 * 1000, NULL, 0 };
+#endif
+
 extern uint slice_num;
+/* Maior tempo acordado de um ciclo: com o despejo do perfil, a UART a 9600 bps domina */
+#define SUPERVISOR_CICLO_MAX_MS 3000
+
 extern DS3231 rtc_ds3231;
 
-/* Habilitando função de callback para tratar interrupções na GPIO */
-void gpio_callback(uint gpio, uint32_t events) {}
+/* Alarme do DS3231: o INT fica em nível baixo até A1F/A2F serem limpos no reagendamento,
+   então uma borda com a linha já de volta em nível alto foi ruído e não abre um ciclo */
+static bool trata_alarme_rtc(const EventoDespertar *evento) {
+  return !gpio_get(evento->origem);
+}
+
+/* O ciclo completo só roda com o alarme; o INT baixo sem evento na fila é uma borda perdida */
+static bool alarme_pendente(void) {
+  return (despacha_despertar() & DESPERTAR_BIT(DESPERTAR_ALARME_RTC)) || !gpio_get(WAKE_GPIO);
+}
+
+#ifdef SONO_DORMANT
+/* Tombos com o núcleo acordado (fora do dormant): contados no próprio handler, onde o
+   instante da borda define o repique; só o tombo aceito vira evento */
+static bool filtra_tombo(uint gpio, uint32_t eventos) {
+  return pluviometro_trata_borda();
+}
+#endif
 
 /* Declarando variáveis para salvar o estado atual dos clocks */
 static uint scb_orig;
@@ -67,17 +158,77 @@ void enter_low_power_sleep_until_interrupt(void) {
   clock0_orig = clocks_hw->sleep_en0;
   clock1_orig = clocks_hw->sleep_en1;
 
-  /* Mantendo apenas o clock do PWM ativo durante o modo sleep */
-  clocks_hw->sleep_en0 = CLOCKS_SLEEP_EN0_CLK_SYS_PWM_BITS;
+  /* Mantendo apenas os clocks do PWM (bordas brutas) e da PIO0 (tombos filtrados) no modo sleep */
+  clocks_hw->sleep_en0 = CLOCKS_SLEEP_EN0_CLK_SYS_PWM_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_PIO0_BITS;
   clocks_hw->sleep_en1 = 0x0;
 
+#ifdef PLUVIOMETRO_CARIMBOS
+  /* Mantendo o DMA e o caminho até a SRAM para gravar os carimbos no anel */
+  clocks_hw->sleep_en0 |= CLOCKS_SLEEP_EN0_CLK_SYS_DMA_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_BUSFABRIC_BITS |
+                          CLOCKS_SLEEP_EN0_CLK_SYS_SRAM0_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_SRAM1_BITS |
+                          CLOCKS_SLEEP_EN0_CLK_SYS_SRAM2_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_SRAM3_BITS;
+#endif
+
   /* Ativando o bit de deep sleep no registrador SCR */
   uint save = scb_hw->scr;
   scb_hw->scr = save | M0PLUS_SCR_SLEEPDEEP_BITS;
 
-  /* Entrando em modo de baixo consumo até que ocorra uma interrupção */
-  __wfi();
+  /* Entrando em modo de baixo consumo até que ocorra uma interrupção. Despertares que não
+     exigem o ciclo (ruído no INT, IRQs de outros periféricos) são despachados ainda nos
+     clocks do sono e o núcleo volta direto ao __wfi(). Com as interrupções mascaradas entre
+     a verificação e o __wfi(), um evento que chegue no meio fica pendente e encerra o
+     __wfi() na hora, em vez de o núcleo dormir com o alarme já disparado */
+  uint32_t estado = save_and_disable_interrupts();
+  do {
+#ifdef SONO_DESLIGA_MEMORIAS
+    sleep_wfi_with_memories_powered_down(memorias_desligadas_no_sono());
+#else
+    __wfi();
+#endif
+    restore_interrupts(estado);
+    estado = save_and_disable_interrupts();
+  } while (!alarme_pendente());
+  restore_interrupts(estado);
+}
+
+#ifdef SONO_DORMANT
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  enter_dormant_until_alarm
+*  Description:  Função auxiliar para entrar em modo dormant até o alarme do DS3231.
+*                Os tombos também despertam o núcleo: cada um é contado e o núcleo
+*                volta ao dormant, sem restaurar os clocks nem usar a UART.
+* =====================================================================================
+*/
+void enter_dormant_until_alarm(void) {
+  /* Salvando SCR e SLEEP_EN para que recover_from_sleep os restaure como no SLEEPDEEP */
+  scb_orig = scb_hw->scr;
+  clock0_orig = clocks_hw->sleep_en0;
+  clock1_orig = clocks_hw->sleep_en1;
+
+  /* Habilitando o sensor Hall como segunda fonte de despertar do dormant */
+  gpio_set_dormant_irq_enabled(SENSOR_HALL_PIN, GPIO_IRQ_EDGE_FALL, true);
+
+  /* O INT do DS3231 fica em nível baixo até a flag ser limpa: enquanto estiver alto,
+     quem despertou o núcleo foi só o sensor e o núcleo volta ao dormant */
+  while (gpio_get(WAKE_GPIO)) {
+    /* Os tombos já foram contados no handler: os eventos só saem da fila */
+    despacha_despertar();
+    pluviometro_aguarda_silencio();
+    supervisor_dorme();
+    /* Por nível, e não por borda: um alarme que chegue depois do gpio_get() acima tem a
+       borda consumida pelo handler do núcleo 0, mas o INT segue baixo até A1F ser limpo */
+    sleep_goto_dormant_until_level_low(WAKE_GPIO);
+
+    /* O tratamento de um tombo entre dois dormant também tem prazo */
+    supervisor_fase_entre_ciclos(PERFIL_SENSOR, DEBOUNCE_DELAY + SUPERVISOR_PRAZO_SENSOR_MS);
+    pluviometro_verifica_despertar();
+  }
+
+  gpio_set_dormant_irq_enabled(SENSOR_HALL_PIN, GPIO_IRQ_EDGE_FALL, false);
+  gpio_set_dormant_irq_enabled(WAKE_GPIO, GPIO_IRQ_LEVEL_LOW, false);
 }
+#endif
 
 /*
 * ===  FUNCTION  ======================================================================
@@ -91,103 +242,180 @@ void recover_from_sleep(uint scb_orig, uint clock0_orig, uint clock1_orig) {
   scb_hw->scr = scb_orig;
   clocks_hw->sleep_en0 = clock0_orig;
   clocks_hw->sleep_en1 = clock1_orig;
+#ifdef CLOCK_DESPERTAR_PERFIS
+  aplica_perfil_clock(CLOCK_PERFIL_SENSOR, &perifericos_clock);
+#else
   clocks_init();
+#endif
 }
 
 void setup() {
 
+  /* Registrando início do boot no perfil do ciclo */
+  PERFIL_MARCA(PERFIL_BOOT);
+
+  /* Armando o watchdog para o setup() e recuperando a fase de um travamento anterior */
+  inicializa_supervisor(SUPERVISOR_CICLO_MAX_MS);
+
   /* Inicializando UART */
   uart_init(UART_ID, BAUD_RATE);
   gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART); 
+  supervisor_informa_falha(UART_ID);
   
   /* Inicializando o módulo DS3231 com a instância I2C e os pinos definidos */
   inicializa_ds3231(&rtc_ds3231, i2c1, DS3231_I2C_ADDR, I2C_SDA_PIN, I2C_SCL_PIN);
 
   /* Inicializando sensor pluviométrico baseado em sensor Hall */
+#ifdef SONO_DORMANT
+  inicializa_pluviometro_gpio(SENSOR_HALL_PIN);
+  registra_fonte_despertar(SENSOR_HALL_PIN, GPIO_IRQ_EDGE_FALL, DESPERTAR_TOMBO, filtra_tombo);
+#else
   inicializa_sensor_pluviometro(SENSOR_HALL_PIN);
+#endif
+#ifdef PLUVIOMETRO_CARIMBOS
+  if (!inicializa_carimbos_chuva(SENSOR_HALL_PIN)) {
+    uart_puts(UART_ID, "Erro ao carregar o programa de carimbos na PIO!\n\r");
+  }
+#endif
+  PERFIL_MARCA(PERFIL_SENSOR);
  
   /* Configurando GPIO de wake-up como entrada (SQW/INT) */
   gpio_init(WAKE_GPIO);
   gpio_set_dir(WAKE_GPIO, GPIO_IN);
   
-  /* Declarando variável para armazenar o conteúdo do registrador de status */
-  uint8_t stat;
-
-  /* Lendo o registrador de status (0x0F) para verificar flags ativas */
-  ds3231_read_reg(rtc_ds3231.i2c, DS3231_REG_STATUS, &stat);
-
-  if (stat & DS3231_STAT_A1F) {
-    /* Limpando a flag A1F (bit 0), necessária para permitir futuros alarmes */
-    stat &= ~DS3231_STAT_A1F;
-
-    /* Escrevendo de volta no registrador de status com a flag A1F zerada */
-    ds3231_write_reg(rtc_ds3231.i2c, DS3231_REG_STATUS, stat);
-  }
-
-  /* Agendando um novo alarme relativo */
-  agenda_alarme_em(rtc_ds3231.i2c, 0, 3);  // Alarme em 1 minuto e 30 segundos
+  /* Agendando o primeiro alarme; flags pendentes são limpas na mesma escrita */
+#ifdef GRADE_PERIODO_MIN
+  agenda_alarme_grade(rtc_ds3231.i2c, &grade_alarme);
+#else
+  agenda_alarme_em(rtc_ds3231.i2c, 0, 3);
+#endif
 
-  /* Configurando interrupção na GPIO de wake-up para borda de descida */
-  gpio_set_irq_enabled_with_callback(
-    WAKE_GPIO,
-    GPIO_IRQ_EDGE_FALL,
-    true,
-    &gpio_callback
-  );
+  /* Registrando a GPIO de wake-up (borda de descida) no despachante dos despertares */
+  registra_fonte_despertar(WAKE_GPIO, GPIO_IRQ_EDGE_FALL, DESPERTAR_ALARME_RTC, NULL);
+  registra_tratador_despertar(DESPERTAR_ALARME_RTC, trata_alarme_rtc);
+  PERFIL_MARCA(PERFIL_RTC);
 
   uart_puts(UART_ID, "Sistema iniciado!!\n\r");
   uart_default_tx_wait_blocking();
+  PERFIL_MARCA(PERFIL_UART);
 }
   
 void loop() {
+
+  /* Encerrando o perfil do ciclo anterior (despejo periódico pela UART) */
+  PERFIL_ENCERRA_CICLO(UART_ID);
   
+#ifdef SONO_ROSC_KHZ
+  /* Configurando sistema para executar a partir do ROSC calibrado; a contagem de frequência
+     usa o XOSC como referência, então é feita antes da troca */
+  rosc_restore_calibration(SONO_ROSC_KHZ, SONO_ROSC_TOLERANCIA_KHZ);
+  sleep_run_from_rosc();
+#else
   /* Configurando sistema para executar a partir do cristal externo (XOSC) */
   sleep_run_from_xosc();
+#endif
+#ifndef SONO_DORMANT
+  pluviometro_ajusta_clock();
+#endif
+#ifdef PLUVIOMETRO_CARIMBOS
+  carimbos_ajusta_clock();
+#endif
   
-  /* Entrando em modo de baixo consumo até ocorrência de interrupção */
+  /* Entrando em modo de baixo consumo até ocorrência de interrupção; o watchdog só
+     fica desligado no sono, com o próximo alarme já agendado */
+#ifdef SONO_DORMANT
+  enter_dormant_until_alarm();
+#else
+  supervisor_dorme();
   enter_low_power_sleep_until_interrupt();
+#endif
+  PERFIL_MARCA(PERFIL_DESPERTOU);
   
   /* Restaurando estado dos clocks após o modo Sleep */
+  supervisor_inicia_ciclo();
   recover_from_sleep(scb_orig, clock0_orig, clock1_orig);
+#ifndef SONO_DORMANT
+  pluviometro_ajusta_clock();
+#endif
+#ifdef PLUVIOMETRO_CARIMBOS
+  carimbos_ajusta_clock();
+#endif
+  PERFIL_MARCA(PERFIL_CLOCKS);
   
+  /* Reagendando o alarme antes das fases que podem travar: se a flag estiver
+     ativa, ela é limpa e o próximo alarme agendado com uma leitura e uma escrita em
+     bloco. Um reset do watchdog no meio do ciclo já encontra o despertar garantido */
+  supervisor_fase(PERFIL_RTC, SUPERVISOR_PRAZO_RTC_MS);
+#ifdef GRADE_PERIODO_MIN
+  reagenda_grade_disparada(i2c1, &grade_alarme);
+#else
+  reagenda_alarme_disparado(i2c1, 0, 10);
+#endif
+  PERFIL_MARCA(PERFIL_RTC);
+
   /* Reconfigurando UART e notificando início do envio LoRa */
+  supervisor_fase(PERFIL_UART, SUPERVISOR_PRAZO_UART_MS);
   uart_init(UART_ID, BAUD_RATE);
   gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART);
   uart_puts(UART_ID, "Entrando no modo operacao\n\r");
   uart_default_tx_wait_blocking();
+  PERFIL_MARCA(PERFIL_UART);
   
   
-  /* Formatando mensagem com dados lidos (precipitação) */
+  /* Lendo os tombos do intervalo (os contadores não são zerados, evitando perder pulsos) */
+  supervisor_fase(PERFIL_SENSOR, SUPERVISOR_PRAZO_SENSOR_MS);
+  LeituraPluviometro chuva;
+#ifdef SONO_DORMANT
+  le_pluviometro_total(&chuva, pluviometro_tombos_gpio());
+#else
+  le_pluviometro(&chuva);
+#endif
+  PERFIL_MARCA(PERFIL_SENSOR);
+
+  /* Mensagens e despejo do perfil até o sono */
+  supervisor_fase(PERFIL_UART, SUPERVISOR_PRAZO_UART_MS);
+
+  /* Formatando mensagem com dados lidos (precipitação no intervalo e acumulada, em mm) */
   char message[100];
   snprintf(message, sizeof(message),
-          "|r|%.4f",
-          pwm_get_counter(slice_num) * PRECIPITACAO);
+          "|r|%lu.%02lu|t|%lu.%02lu",
+          (unsigned long)(chuva.chuva_centesimos / 100), (unsigned long)(chuva.chuva_centesimos % 100),
+          (unsigned long)(chuva.total_centesimos / 100), (unsigned long)(chuva.total_centesimos % 100));
 
   /* Enviando mensagem formatada via UART */
   uart_puts(UART_ID, message);
+#ifndef SONO_DORMANT
+  /* Diagnóstico do filtro: bordas descartadas desde o boot (bordas do PWM - tombos da PIO) */
+  snprintf(message, sizeof(message), "|g|%lu",
+          (unsigned long)(pluviometro_total_tombos() - chuva.total_tombos));
+  uart_puts(UART_ID, message);
+#endif
   uart_puts(UART_ID, "\n\r");
   uart_default_tx_wait_blocking();
-  
-  /* Resetando contador de pulsos do pluviômetro */
-  pwm_set_counter(slice_num, 0);
-
-  /* Reagendando alarme */
-  uint8_t stat;
-  ds3231_read_reg(i2c1, DS3231_REG_STATUS, &stat);
-
-  if (stat & DS3231_STAT_A1F) {
-    /* Limpando a flag A1F para permitir que futuros eventos de alarme */
-    stat &= ~DS3231_STAT_A1F;
-    ds3231_write_reg(i2c1, DS3231_REG_STATUS, stat);
-
-    /* Agendando um novo alarme */
-    agenda_alarme_em(i2c1, 0, 10);
-    // uart_puts(UART_ID, ">> Alarme tratado e reagendado <<\n\r");
-    // uart_tx_wait_blocking(UART_ID);
-  }
+  PERFIL_MARCA(PERFIL_UART);
+
+#ifdef PLUVIOMETRO_CARIMBOS
+  /* Calculando a intensidade a partir dos carimbos gravados durante o sono */
+  IntensidadeChuva intensidade;
+  le_intensidade_chuva(&intensidade);
+  PERFIL_MARCA(PERFIL_SENSOR);
+
+  /* Enviando picos (mm/h), histograma de minutos por classe e carimbos perdidos */
+  snprintf(message, sizeof(message),
+          "|i1|%lu.%02lu|i5|%lu.%02lu|h|%u,%u,%u,%u,%u|p|%lu\n\r",
+          (unsigned long)(intensidade.pico_1min / 100), (unsigned long)(intensidade.pico_1min % 100),
+          (unsigned long)(intensidade.pico_5min / 100), (unsigned long)(intensidade.pico_5min % 100),
+          intensidade.minutos_classe[0], intensidade.minutos_classe[1], intensidade.minutos_classe[2],
+          intensidade.minutos_classe[3], intensidade.minutos_classe[4],
+          (unsigned long)intensidade.perdidos);
+  uart_puts(UART_ID, message);
+  uart_default_tx_wait_blocking();
+  PERFIL_MARCA(PERFIL_UART);
+#endif
 
   uart_puts(UART_ID, ">> Indo dormir novamente... <<\n\r");
   uart_tx_wait_blocking(UART_ID);
+  PERFIL_MARCA(PERFIL_UART);
 }
 
 
@@ -21,6 +21,70 @@
 /* Declarando estrutura global para armazenar dados do sensor SHT30 */
 SensorSHT30 sht30;
 
+/* Comandos single shot sem clock stretching, indexados por RepetibilidadeSHT30 */
+static const uint8_t comandos_medicao[3][2] = {
+  {0x24, 0x16},  /* baixa */
+  {0x24, 0x0B},  /* média */
+  {0x24, 0x00},  /* alta */
+};
+
+/* Comandos do modo periódico, indexados por [FrequenciaSHT30][RepetibilidadeSHT30] */
+static const uint8_t comandos_periodico[5][3][2] = {
+  {{0x20, 0x2F}, {0x20, 0x24}, {0x20, 0x32}},  /* 0,5 mps */
+  {{0x21, 0x2D}, {0x21, 0x26}, {0x21, 0x30}},  /* 1 mps */
+  {{0x22, 0x2B}, {0x22, 0x20}, {0x22, 0x36}},  /* 2 mps */
+  {{0x23, 0x29}, {0x23, 0x22}, {0x23, 0x34}},  /* 4 mps */
+  {{0x27, 0x2A}, {0x27, 0x21}, {0x27, 0x37}},  /* 10 mps */
+};
+
+/* Duração máxima da conversão em microssegundos (datasheet SHT3x-DIS) */
+static const uint32_t duracao_medicao_us[3] = { 4500, 6500, 15500 };
+
+/* Tempo extra de consulta após o prazo antes de considerar o sensor em falha */
+#define SHT30_MARGEM_CONSULTA_US  5000
+
+/* Intervalo entre consultas quando o sensor ainda responde NACK */
+#define SHT30_INTERVALO_CONSULTA_US  500
+
+/* Espera após o soft reset (1,5 ms no datasheet), dobrada a cada nova tentativa */
+#define SHT30_ESPERA_RESET_US  1500
+
+/* Tabela do CRC-8 do SHT3x (polinômio 0x31), um byte por consulta */
+static const uint8_t crc8_tabela[256] = {
+  0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97,
+  0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E,
+  0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4,
+  0xFA, 0xCB, 0x98, 0xA9, 0x3E, 0x0F, 0x5C, 0x6D,
+  0x86, 0xB7, 0xE4, 0xD5, 0x42, 0x73, 0x20, 0x11,
+  0x3F, 0x0E, 0x5D, 0x6C, 0xFB, 0xCA, 0x99, 0xA8,
+  0xC5, 0xF4, 0xA7, 0x96, 0x01, 0x30, 0x63, 0x52,
+  0x7C, 0x4D, 0x1E, 0x2F, 0xB8, 0x89, 0xDA, 0xEB,
+  0x3D, 0x0C, 0x5F, 0x6E, 0xF9, 0xC8, 0x9B, 0xAA,
+  0x84, 0xB5, 0xE6, 0xD7, 0x40, 0x71, 0x22, 0x13,
+  0x7E, 0x4F, 0x1C, 0x2D, 0xBA, 0x8B, 0xD8, 0xE9,
+  0xC7, 0xF6, 0xA5, 0x94, 0x03, 0x32, 0x61, 0x50,
+  0xBB, 0x8A, 0xD9, 0xE8, 0x7F, 0x4E, 0x1D, 0x2C,
+  0x02, 0x33, 0x60, 0x51, 0xC6, 0xF7, 0xA4, 0x95,
+  0xF8, 0xC9, 0x9A, 0xAB, 0x3C, 0x0D, 0x5E, 0x6F,
+  0x41, 0x70, 0x23, 0x12, 0x85, 0xB4, 0xE7, 0xD6,
+  0x7A, 0x4B, 0x18, 0x29, 0xBE, 0x8F, 0xDC, 0xED,
+  0xC3, 0xF2, 0xA1, 0x90, 0x07, 0x36, 0x65, 0x54,
+  0x39, 0x08, 0x5B, 0x6A, 0xFD, 0xCC, 0x9F, 0xAE,
+  0x80, 0xB1, 0xE2, 0xD3, 0x44, 0x75, 0x26, 0x17,
+  0xFC, 0xCD, 0x9E, 0xAF, 0x38, 0x09, 0x5A, 0x6B,
+  0x45, 0x74, 0x27, 0x16, 0x81, 0xB0, 0xE3, 0xD2,
+  0xBF, 0x8E, 0xDD, 0xEC, 0x7B, 0x4A, 0x19, 0x28,
+  0x06, 0x37, 0x64, 0x55, 0xC2, 0xF3, 0xA0, 0x91,
+  0x47, 0x76, 0x25, 0x14, 0x83, 0xB2, 0xE1, 0xD0,
+  0xFE, 0xCF, 0x9C, 0xAD, 0x3A, 0x0B, 0x58, 0x69,
+  0x04, 0x35, 0x66, 0x57, 0xC0, 0xF1, 0xA2, 0x93,
+  0xBD, 0x8C, 0xDF, 0xEE, 0x79, 0x48, 0x1B, 0x2A,
+  0xC1, 0xF0, 0xA3, 0x92, 0x05, 0x34, 0x67, 0x56,
+  0x78, 0x49, 0x1A, 0x2B, 0xBC, 0x8D, 0xDE, 0xEF,
+  0x82, 0xB3, 0xE0, 0xD1, 0x46, 0x77, 0x24, 0x15,
+  0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D, 0xAC
+};
+
 void inicializa_sensor_sht30(SensorSHT30 *sensor, i2c_inst_t *i2c, uint8_t endereco, uint sda_pin, uint scl_pin) {
   /* Inicializando valores de temperatura e umidade como zero */
   sensor->temperatura = 0.0;
@@ -29,33 +93,41 @@ void inicializa_sensor_sht30(SensorSHT30 *sensor, i2c_inst_t *i2c, uint8_t ender
   /* Armazenando endereço e instância de I2C na estrutura */
   sensor->endereco = endereco;
   sensor->i2c = i2c;
+  sensor->medindo = false;
+  sensor->pronto_us = 0;
+  sensor->repetibilidade = SHT30_REPETIBILIDADE_ALTA;
+  sensor->periodico = false;
+  sensor->frequencia = SHT30_MPS_1;
 
-  /* Inicializando comunicação I2C com frequência de 400 kHz */
-  i2c_init(i2c, 400 * 1000);
-
-  /* Configurando pinos SDA e SCL para função I2C */
-  gpio_set_function(sda_pin, GPIO_FUNC_I2C);
-  gpio_set_function(scl_pin, GPIO_FUNC_I2C);
+  /* Zerando contadores de erro */
+  sensor->falhas_i2c = 0;
+  sensor->falhas_crc = 0;
+  sensor->resets = 0;
+  sensor->leituras_perdidas = 0;
 
-  /* Habilitando resistores de pull-up nos pinos SDA e SCL */
-  // gpio_pull_up(sda_pin);
-  // gpio_pull_up(scl_pin);
+  /* Configurando o barramento compartilhado (o i2c_init() é feito só pelo primeiro driver) */
+  inicializa_barramento_i2c(i2c, sda_pin, scl_pin);
 }
 
-bool ler_sensor_sht30(SensorSHT30 *sensor) {
-  /* Enviando comando de medição para o sensor */
-  uint8_t config[2] = {0x2C, 0x06};
-  if (i2c_write_blocking(sensor->i2c, sensor->endereco, config, 2, false) != 2) {
-    return false;  /* Retornando erro se não for possível enviar o comando */
-  }
+/* Comando de 2 bytes (com STOP) no barramento compartilhado, no baud do SHT30 */
+static bool envia_comando(SensorSHT30 *sensor, const uint8_t *comando) {
+  return barramento_i2c_transacao(sensor->i2c, sensor->endereco, SHT30_I2C_BAUD, comando, 2, NULL, 0);
+}
 
-  /* Aguardando tempo necessário para a medição (15 ms) */
-  sleep_ms(15);
+/* Leitura das duas palavras de medição com CRC (6 bytes); NACK enquanto não houver dado */
+static bool le_medicao(SensorSHT30 *sensor, uint8_t *data) {
+  return barramento_i2c_transacao(sensor->i2c, sensor->endereco, SHT30_I2C_BAUD, NULL, 0, data, 6);
+}
 
-  /* Lendo 6 bytes com os dados de temperatura e umidade */
-  uint8_t data[6] = {0};
-  if (i2c_read_blocking(sensor->i2c, sensor->endereco, data, 6, false) != 6) {
-    return false;  /* Retornando erro se leitura falhar */
+/*
+ * Valida o CRC das palavras de temperatura (data[0..2]) e umidade (data[3..5])
+ * e converte os valores brutos para unidades de engenharia.
+*/
+static ResultadoSHT30 converte_dados(SensorSHT30 *sensor, const uint8_t *data) {
+  /* Validando o CRC de cada palavra */
+  if (sht30_crc8(&data[0], 2) != data[2] || sht30_crc8(&data[3], 2) != data[5]) {
+    sensor->falhas_crc++;
+    return SHT30_ERRO;  /* Descartando leitura corrompida */
   }
 
   /* Convertendo dados brutos em temperatura e umidade reais */
@@ -68,7 +140,207 @@ bool ler_sensor_sht30(SensorSHT30 *sensor) {
   /* Calculando umidade relativa em porcentagem */
   sensor->umidade = (100.0 * raw_humidity) / 65535.0;
 
-  return true;  /* Retornando sucesso na leitura */
+  return SHT30_PRONTO;  /* Retornando sucesso na leitura */
+}
+
+/*
+ * Inicia uma conversão single shot sem clock stretching e retorna imediatamente.
+ * O barramento fica livre durante a conversão e a coleta é feita depois com
+ * sht30_try_fetch(), permitindo sobrepor a espera a outras tarefas do ciclo.
+*/
+bool sht30_start_measurement(SensorSHT30 *sensor, RepetibilidadeSHT30 repetibilidade) {
+  sensor->repetibilidade = repetibilidade;
+
+  /* Enviando comando de medição para o sensor */
+  if (!envia_comando(sensor, comandos_medicao[repetibilidade])) {
+    sensor->medindo = false;
+    sensor->falhas_i2c++;
+    return false;  /* Retornando erro se não for possível enviar o comando */
+  }
+
+  /* Registrando o instante em que a conversão estará concluída */
+  sensor->medindo = true;
+  sensor->pronto_us = time_us_64() + duracao_medicao_us[repetibilidade];
+  return true;
+}
+
+/*
+ * Tenta coletar a medição iniciada por sht30_start_measurement(). Antes do prazo
+ * da conversão o barramento nem é acessado; depois dele, um NACK indica que o
+ * sensor ainda está convertendo, até o limite de SHT30_MARGEM_CONSULTA_US.
+*/
+ResultadoSHT30 sht30_try_fetch(SensorSHT30 *sensor) {
+  if (!sensor->medindo) return SHT30_ERRO;
+
+  uint64_t agora = time_us_64();
+  if (agora < sensor->pronto_us) return SHT30_OCUPADO;
+
+  /* Lendo 6 bytes com os dados de temperatura e umidade */
+  uint8_t data[6] = {0};
+  if (!le_medicao(sensor, data)) {
+    if (agora < sensor->pronto_us + SHT30_MARGEM_CONSULTA_US) return SHT30_OCUPADO;
+    sensor->medindo = false;
+    sensor->falhas_i2c++;
+    return SHT30_ERRO;  /* Retornando erro se o sensor não responder após o prazo */
+  }
+  sensor->medindo = false;
+
+  return converte_dados(sensor, data);
+}
+
+/*
+ * Aguarda apenas o tempo que ainda falta da conversão em andamento e coleta o
+ * resultado. Em caso de falha (NACK após o prazo ou CRC inválido) o sensor
+ * recebe um soft reset e a medição é repetida, até SHT30_MAX_TENTATIVAS vezes,
+ * para que o ciclo não seja perdido por um erro transitório.
+*/
+bool sht30_wait_fetch(SensorSHT30 *sensor) {
+  for (uint8_t tentativa = 0; ; tentativa++) {
+    ResultadoSHT30 resultado;
+
+    while ((resultado = sht30_try_fetch(sensor)) == SHT30_OCUPADO) {
+      uint64_t agora = time_us_64();
+      sleep_us(agora < sensor->pronto_us ? sensor->pronto_us - agora : SHT30_INTERVALO_CONSULTA_US);
+    }
+    if (resultado == SHT30_PRONTO) return true;
+
+    if (tentativa >= SHT30_MAX_TENTATIVAS) {
+      sensor->leituras_perdidas++;
+      return false;  /* Retornando erro após esgotar as tentativas */
+    }
+
+    /* Reiniciando o sensor e aguardando com espera crescente antes de repetir */
+    sht30_soft_reset(sensor);
+    sleep_us((uint64_t)SHT30_ESPERA_RESET_US << tentativa);
+    sht30_start_measurement(sensor, sensor->repetibilidade);
+  }
+}
+
+/*
+ * Envia o comando de soft reset (0x30A2), descartando qualquer conversão em
+ * andamento. O sensor volta a responder em até 1,5 ms.
+*/
+bool sht30_soft_reset(SensorSHT30 *sensor) {
+  static const uint8_t comando_reset[2] = {0x30, 0xA2};
+
+  sensor->medindo = false;
+  sensor->periodico = false;
+  sensor->resets++;
+  return envia_comando(sensor, comando_reset);
+}
+
+/*
+ * Calcula o CRC-8 do SHT3x (polinômio 0x31, valor inicial 0xFF) por tabela.
+*/
+uint8_t sht30_crc8(const uint8_t *dados, size_t n) {
+  uint8_t crc = 0xFF;
+  for (size_t i = 0; i < n; i++) {
+    crc = crc8_tabela[crc ^ dados[i]];
+  }
+  return crc;
+}
+
+/*
+ * Coloca o sensor em aquisição periódica. O sensor passa a medir sozinho na
+ * frequência indicada enquanto o MCU dorme, ao custo de alguns uA a mais, e a
+ * cada despertar basta coletar a amostra mais recente com sht30_fetch_periodic(),
+ * sem esperar nenhuma conversão.
+*/
+bool sht30_start_periodic(SensorSHT30 *sensor, FrequenciaSHT30 frequencia, RepetibilidadeSHT30 repetibilidade) {
+  /* Enviando comando do modo periódico para o sensor */
+  if (!envia_comando(sensor, comandos_periodico[frequencia][repetibilidade])) {
+    sensor->falhas_i2c++;
+    return false;
+  }
+
+  sensor->periodico = true;
+  sensor->medindo = false;
+  sensor->frequencia = frequencia;
+  sensor->repetibilidade = repetibilidade;
+  return true;
+}
+
+/*
+ * Coleta a amostra mais recente do modo periódico (Fetch Data, 0xE000). O
+ * sensor responde NACK quando ainda não há amostra nova desde a última coleta,
+ * caso em que é retornado SHT30_OCUPADO.
+*/
+ResultadoSHT30 sht30_fetch_periodic(SensorSHT30 *sensor) {
+  static const uint8_t comando_fetch[2] = {0xE0, 0x00};
+
+  if (!sensor->periodico) return SHT30_ERRO;
+
+  /* Enviando comando de coleta */
+  if (!envia_comando(sensor, comando_fetch)) {
+    sensor->falhas_i2c++;
+    return SHT30_ERRO;
+  }
+
+  /* Lendo 6 bytes com os dados de temperatura e umidade */
+  uint8_t data[6] = {0};
+  if (!le_medicao(sensor, data)) {
+    return SHT30_OCUPADO;  /* Nenhuma amostra nova desde a última coleta */
+  }
+
+  return converte_dados(sensor, data);
+}
+
+/*
+ * Encerra o modo periódico (Break, 0x3093), devolvendo o sensor ao modo single
+ * shot de baixo consumo.
+*/
+bool sht30_stop_periodic(SensorSHT30 *sensor) {
+  static const uint8_t comando_break[2] = {0x30, 0x93};
+
+  if (!envia_comando(sensor, comando_break)) {
+    sensor->falhas_i2c++;
+    return false;
+  }
+
+  /* O sensor aceita o próximo comando após até 1 ms */
+  sensor->periodico = false;
+  sleep_us(1000);
+  return true;
+}
+
+void sht30_zera_acumulador(AcumuladorSHT30 *acumulador) {
+  acumulador->amostras = 0;
+  acumulador->temp_soma = 0.0f;
+  acumulador->umid_soma = 0.0f;
+}
+
+void sht30_acumula(AcumuladorSHT30 *acumulador, const SensorSHT30 *sensor) {
+  /* Iniciando mínimo e máximo com a primeira amostra */
+  if (acumulador->amostras == 0) {
+    acumulador->temp_min = acumulador->temp_max = sensor->temperatura;
+    acumulador->umid_min = acumulador->umid_max = sensor->umidade;
+  }
+
+  /* Atualizando extremos e somas para o cálculo da média */
+  if (sensor->temperatura < acumulador->temp_min) acumulador->temp_min = sensor->temperatura;
+  if (sensor->temperatura > acumulador->temp_max) acumulador->temp_max = sensor->temperatura;
+  if (sensor->umidade < acumulador->umid_min) acumulador->umid_min = sensor->umidade;
+  if (sensor->umidade > acumulador->umid_max) acumulador->umid_max = sensor->umidade;
+
+  acumulador->temp_soma += sensor->temperatura;
+  acumulador->umid_soma += sensor->umidade;
+  acumulador->amostras++;
+}
+
+float sht30_media_temperatura(const AcumuladorSHT30 *acumulador) {
+  return acumulador->amostras ? acumulador->temp_soma / acumulador->amostras : 0.0f;
+}
+
+float sht30_media_umidade(const AcumuladorSHT30 *acumulador) {
+  return acumulador->amostras ? acumulador->umid_soma / acumulador->amostras : 0.0f;
+}
+
+bool ler_sensor_sht30(SensorSHT30 *sensor) {
+  /* Iniciando a medição com repetibilidade alta e aguardando a conversão */
+  if (!sht30_start_measurement(sensor, SHT30_REPETIBILIDADE_ALTA)) {
+    return false;
+  }
+  return sht30_wait_fetch(sensor);
 }
 
 void exibe_dados_sht30(SensorSHT30 *sensor) {
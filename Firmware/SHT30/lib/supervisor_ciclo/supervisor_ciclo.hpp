@@ -0,0 +1,113 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  supervisor_ciclo.hpp
+ *
+ *    Description:  Supervisor do ciclo de despertar: o watchdog do RP2040 é armado
+ *                  com um prazo por fase e desligado só na entrada do sono. A fase
+ *                  em andamento fica nos registradores scratch, que sobrevivem ao
+ *                  reset do watchdog, e é informada no boot seguinte.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 23:58:04
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#ifndef SUPERVISOR_CICLO_HPP
+#define SUPERVISOR_CICLO_HPP
+
+#include <Arduino.h>
+#include "hardware/uart.h"
+#include "../perfil_ciclo/perfil_ciclo.hpp"
+
+/****************************************************************************
+**                          PRAZOS DAS FASES (ms)
+*****************************************************************************/
+
+/* Cada prazo cobre o pior caso normal da fase com folga; estourá-lo significa um
+   travamento (barramento, BUSY do rádio, oscilador que não parte) */
+#define SUPERVISOR_PRAZO_BOOT_MS      8000  /* setup(): partida do rádio e da sessão */
+#define SUPERVISOR_PRAZO_CLOCKS_MS     100  /* Partida do XOSC e trava dos PLLs */
+#define SUPERVISOR_PRAZO_RADIO_MS      500  /* Retomada ou radio.begin() */
+#define SUPERVISOR_PRAZO_SESSAO_MS    1000  /* Gravações na flash */
+#define SUPERVISOR_PRAZO_SENSOR_MS     200  /* Conversão do SHT30 e timeouts do barramento */
+#define SUPERVISOR_PRAZO_UART_MS      2000  /* Mensagens e despejo do perfil a 9600 bps */
+#define SUPERVISOR_PRAZO_ENVIO_MS     8000  /* TX e as duas janelas de RX de um uplink */
+#define SUPERVISOR_PRAZO_RTC_MS        100  /* Reagendamento do alarme */
+#define SUPERVISOR_PRAZO_ESPERA_MS    5000  /* Espera ativa do modo de execução (ds3231) */
+
+/* Maior prazo aceito pelo watchdog do RP2040 (contador de 24 bits decrementado
+   duas vezes por tick de 1 us, errata RP2040-E1) */
+#define SUPERVISOR_PRAZO_MAXIMO_MS    8388
+
+/* Identifica os registradores scratch gravados pelo supervisor (scratch 4 a 7
+   são usados pelo SDK no watchdog_reboot) */
+#define SUPERVISOR_MAGICO             0x5C1C0000u
+#define SUPERVISOR_MASCARA_MAGICO     0xFFFF0000u
+
+/* Falha registrada antes do último reset pelo watchdog */
+typedef struct {
+    bool ocorreu;               /* O boot atual veio de um estouro do watchdog */
+    uint8_t fase;               /* FasePerfil em que o prazo estourou */
+    uint32_t ciclo;             /* Ciclo (desde o boot anterior) em que ocorreu */
+    uint32_t prazo_ms;          /* Prazo que estava armado */
+    uint32_t reinicios;         /* Resets pelo watchdog desde a energização */
+} FalhaSupervisor;
+
+/****************************************************************************
+**                            FUNÇÕES AUXILIARES DE USO
+*****************************************************************************/
+
+/**
+ * @brief Lê os registradores scratch deixados pelo último reset e arma o watchdog
+ *        para o setup(); deve ser a primeira chamada do setup()
+ *
+ * @param ciclo_max_ms Limite do tempo acordado de um ciclo inteiro: a soma dos
+ *                     prazos de fase nunca passa dele
+ * @return Falha do boot anterior (ocorreu = false em uma energização normal)
+*/
+const FalhaSupervisor *inicializa_supervisor(uint32_t ciclo_max_ms);
+
+/**
+ * @brief Abre um ciclo logo após o despertar (arma o watchdog para a restauração
+ *        dos clocks)
+*/
+void supervisor_inicia_ciclo(void);
+
+/**
+ * @brief Entra em uma fase: registra a fase nos scratch e rearma o watchdog com
+ *        o prazo dela, limitado ao que resta do ciclo
+*/
+void supervisor_fase(FasePerfil fase, uint32_t prazo_ms);
+
+/**
+ * @brief Rearma o watchdog fora de um ciclo, sem o limite do ciclo (ex.: tombo
+ *        tratado entre dois períodos de dormant)
+*/
+void supervisor_fase_entre_ciclos(FasePerfil fase, uint32_t prazo_ms);
+
+/**
+ * @brief Desliga o watchdog antes do sono (o alarme do DS3231 já está agendado);
+ *        armado, ele reiniciaria o nó em todo sono mais longo que o prazo máximo
+*/
+void supervisor_dorme(void);
+
+/**
+ * @brief Tempo acordado do ciclo atual (ou do setup) em ms
+*/
+uint32_t supervisor_tempo_ciclo_ms(void);
+
+/**
+ * @brief Envia pela UART a fase que estourou o prazo antes deste boot (nada se o
+ *        boot foi normal)
+*/
+void supervisor_informa_falha(uart_inst_t *uart);
+
+#endif
+/*****************************END OF FILE**************************************/
@@ -23,12 +23,18 @@
 #include "hardware/rtc.h"
 #include "hardware/clocks.h"
 #include "hardware/gpio.h"
+#include "hardware/sync.h"
 #include "hardware/xosc.h"
 #include "hardware/structs/scb.h"
+#include "hardware/structs/syscfg.h"
 #include "hardware/uart.h"
 #include "pico/runtime_init.h"
 #include "../lib/sht30/SHT30.hpp"
 #include "../lib/ds3231_rtc/ds3231.hpp"
+#include "../lib/perfil_ciclo/perfil_ciclo.hpp"
+#include "../lib/clock_despertar/clock_despertar.hpp"
+#include "../lib/supervisor_ciclo/supervisor_ciclo.hpp"
+#include "../lib/despachante_despertar/despachante_despertar.hpp"
 
 #define UART_ID uart0
 #define BAUD_RATE 9600
@@ -38,11 +44,83 @@
 #define I2C_SCL_PIN 27
 #define WAKE_GPIO 28
 
+/* Agendamento em grade absoluta: definindo GRADE_PERIODO_MIN (divisor de 1440, ex.: -D GRADE_PERIODO_MIN=15)
+   os despertares ficam alinhados ao relógio do RTC (00:00, 00:15, ...) sem acumular atraso. GRADE_FASE_SEG
+   desloca a grade (escalonamento entre nós ou, com 1440, o horário do envio diário). Sem a definição o
+   alarme é relativo ao fim de cada ciclo */
+#ifdef GRADE_PERIODO_MIN
+#ifndef GRADE_FASE_SEG
+#define GRADE_FASE_SEG 0
+#endif
+static const GradeAlarme grade_alarme = { GRADE_PERIODO_MIN, GRADE_FASE_SEG };
+#endif
+
+/* Repetibilidade da medição do SHT30 (BAIXA/MEDIA/ALTA: 4,5/6,5/15,5 ms de conversão) */
+#define SHT30_REPETIBILIDADE SHT30_REPETIBILIDADE_ALTA
+
+/* Modo de aquisição do SHT30: definindo SHT30_MODO_PERIODICO (ex.: -D SHT30_MODO_PERIODICO=SHT30_MPS_1)
+   o sensor mede sozinho entre os despertares (alguns uA a mais) e o MCU apenas coleta a
+   amostra mais recente, sem esperar a conversão. Sem a definição é usado o single shot */
+
+/* Amostras acumuladas (mínimo/média/máximo) antes de cada envio; 1 envia cada leitura */
+#ifndef SHT30_AMOSTRAS_POR_ENVIO
+#define SHT30_AMOSTRAS_POR_ENVIO 1
+#endif
+
+/* Memórias desligadas no sono: definindo SONO_DESLIGA_MEMORIAS a ROM e a SRAM4 (scratch X, sem
+   conteúdo com o core 1 parado) são desligadas pelo SYSCFG durante o __wfi(), assim como a DPRAM
+   do USB com PIO_FRAMEWORK_ARDUINO_NO_USB. A região de retenção são as SRAMs 0-3 (intercaladas,
+   com .data, .bss e heap: sessão, contadores e anéis) e a SRAM5 (pilha do core 0) */
+#ifdef SONO_DESLIGA_MEMORIAS
+static uint32_t memorias_desligadas_no_sono(void) {
+  uint32_t mascara = SYSCFG_MEMPOWERDOWN_ROM_BITS;
+#ifdef PIO_FRAMEWORK_ARDUINO_NO_USB
+  mascara |= SYSCFG_MEMPOWERDOWN_USB_BITS;
+#endif
+  if (sleep_scratch_x_unused()) mascara |= SYSCFG_MEMPOWERDOWN_SRAM4_BITS;
+  return mascara;
+}
+#endif
+
+/* Sono a partir do ROSC: definindo SONO_ROSC_KHZ (ex.: -D SONO_ROSC_KHZ=6000) o sono roda do oscilador
+   em anel e o XOSC fica desligado. A calibração (busca binária contra o XOSC) guarda código e frequência
+   medida na RAM, e os ciclos seguintes só conferem o código com uma contagem, refazendo a busca se a
+   deriva passar de SONO_ROSC_TOLERANCIA_KHZ. Os clocks do sono usam a frequência medida */
+#ifdef SONO_ROSC_KHZ
+#ifndef SONO_ROSC_TOLERANCIA_KHZ
+#define SONO_ROSC_TOLERANCIA_KHZ (SONO_ROSC_KHZ / 50)
+#endif
+#endif
+
+/* Perfis de clock no despertar: definindo CLOCK_DESPERTAR_PERFIS o ciclo acorda em 12 MHz do
+   XOSC, sem religar os PLLs (clocks_init() trava os dois PLLs a cada despertar só para
+   sleep_run_from_xosc() desligá-los de novo). Sem rádio, todos os ciclos
+   usam o perfil dos sensores.
+   UART e I2C têm os divisores reajustados a cada troca de perfil. Com CLOCK_GOVERNADOR a tensão
+   do núcleo também acompanha o perfil (0,95 V nos 12 MHz do XOSC) */
+#ifdef CLOCK_DESPERTAR_PERFIS
+static const PerifericosClock perifericos_clock = { UART_ID, BAUD_RATE, i2c1, 400 * 1000, NULL, 0 };
+#endif
+
+/* Maior tempo acordado de um ciclo: com o despejo do perfil, a UART a 9600 bps domina */
+#define SUPERVISOR_CICLO_MAX_MS 3000
+
 extern SensorSHT30 sht30;
 extern DS3231 rtc_ds3231;
 
-/* Habilitando função de callback para tratar interrupções na GPIO */
-void gpio_callback(uint gpio, uint32_t events) {}
+/* Alarme do DS3231: o INT fica em nível baixo até A1F/A2F serem limpos no reagendamento,
+   então uma borda com a linha já de volta em nível alto foi ruído e não abre um ciclo */
+static bool trata_alarme_rtc(const EventoDespertar *evento) {
+  return !gpio_get(evento->origem);
+}
+
+/* O ciclo completo só roda com o alarme; o INT baixo sem evento na fila é uma borda perdida */
+static bool alarme_pendente(void) {
+  return (despacha_despertar() & DESPERTAR_BIT(DESPERTAR_ALARME_RTC)) || !gpio_get(WAKE_GPIO);
+}
+
+/* Declarando acumulador das amostras do SHT30 entre envios */
+static AcumuladorSHT30 acumulador_sht30;
 
 /* Declarando variáveis para salvar o estado atual dos clocks */
 static uint scb_orig;
@@ -74,8 +152,22 @@ void enter_low_power_sleep_until_interrupt(void) {
   uint save = scb_hw->scr;
   scb_hw->scr = save | M0PLUS_SCR_SLEEPDEEP_BITS;
 
-  /* Entrando em modo de baixo consumo até que ocorra uma interrupção */
-  __wfi();
+  /* Entrando em modo de baixo consumo até que ocorra uma interrupção. Despertares que não
+     exigem o ciclo (ruído no INT, IRQs de outros periféricos) são despachados ainda nos
+     clocks do sono e o núcleo volta direto ao __wfi(). Com as interrupções mascaradas entre
+     a verificação e o __wfi(), um evento que chegue no meio fica pendente e encerra o
+     __wfi() na hora, em vez de o núcleo dormir com o alarme já disparado */
+  uint32_t estado = save_and_disable_interrupts();
+  do {
+#ifdef SONO_DESLIGA_MEMORIAS
+    sleep_wfi_with_memories_powered_down(memorias_desligadas_no_sono());
+#else
+    __wfi();
+#endif
+    restore_interrupts(estado);
+    estado = save_and_disable_interrupts();
+  } while (!alarme_pendente());
+  restore_interrupts(estado);
 }
 
 /*
@@ -90,21 +182,60 @@ void recover_from_sleep(uint scb_orig, uint clock0_orig, uint clock1_orig) {
   scb_hw->scr = scb_orig;
   clocks_hw->sleep_en0 = clock0_orig;
   clocks_hw->sleep_en1 = clock1_orig;
+#ifdef CLOCK_DESPERTAR_PERFIS
+  aplica_perfil_clock(CLOCK_PERFIL_SENSOR, &perifericos_clock);
+#else
   clocks_init();
+#endif
 }
 
 
+/*
+* ===  FUNCTION  ======================================================================
+*         Name:  coleta_sht30
+*  Description:  Coleta a leitura do SHT30 conforme o modo de aquisição configurado.
+*                No modo periódico a amostra já está pronta; se o sensor não
+*                responder, a aquisição periódica é rearmada para o próximo ciclo.
+* =====================================================================================
+*/
+bool coleta_sht30(void) {
+#ifdef SHT30_MODO_PERIODICO
+  if (sht30_fetch_periodic(&sht30) == SHT30_PRONTO) {
+    return true;
+  }
+  sht30_stop_periodic(&sht30);
+  sht30_start_periodic(&sht30, SHT30_MODO_PERIODICO, SHT30_REPETIBILIDADE);
+  return false;
+#else
+  /* Aguardando apenas o restante da conversão iniciada ao despertar */
+  return sht30_wait_fetch(&sht30);
+#endif
+}
+
 void setup() {
 
+  /* Registrando início do boot no perfil do ciclo */
+  PERFIL_MARCA(PERFIL_BOOT);
+
+  /* Armando o watchdog para o setup() e recuperando a fase de um travamento anterior */
+  inicializa_supervisor(SUPERVISOR_CICLO_MAX_MS);
+
   /* Inicializando UART */
   uart_init(UART_ID, BAUD_RATE);
   gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART); 
+  supervisor_informa_falha(UART_ID);
 
   /* Inicializando o módulo DS3231 com a instância I2C e os pinos definidos */
   inicializa_ds3231(&rtc_ds3231, i2c1, DS3231_I2C_ADDR, I2C_SDA_PIN, I2C_SCL_PIN);
 
   /* Inicializando sensor SHT30 via barramento I2C */
   inicializa_sensor_sht30(&sht30, i2c1, 0x44, I2C_SDA_PIN, I2C_SCL_PIN);
+#ifdef SHT30_MODO_PERIODICO
+  /* Iniciando aquisição periódica: o sensor mede sozinho enquanto o MCU dorme */
+  sht30_start_periodic(&sht30, SHT30_MODO_PERIODICO, SHT30_REPETIBILIDADE);
+#endif
+  sht30_zera_acumulador(&acumulador_sht30);
+  PERFIL_MARCA(PERFIL_SENSOR);
 
   uart_init(UART_ID, BAUD_RATE);
   gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART); 
@@ -113,91 +244,120 @@ void setup() {
   gpio_init(WAKE_GPIO);
   gpio_set_dir(WAKE_GPIO, GPIO_IN);
 
-  /* Limpando possível alarme pendente */
-  uint8_t stat; /* Declarando variável para armazenar o conteúdo do registrador de status */
-
-  /* Lendo o registrador de status (0x0F) para verificar flags ativas */
-  ds3231_read_reg(rtc_ds3231.i2c, DS3231_REG_STATUS, &stat);
-
-  if (stat & DS3231_STAT_A1F) {
-    /* Limpando a flag A1F (bit 0), necessária para permitir futuros alarmes */
-    stat &= ~DS3231_STAT_A1F;
-
-    /* Escrevendo de volta no registrador de status com a flag A1F zerada */
-    ds3231_write_reg(rtc_ds3231.i2c, DS3231_REG_STATUS, stat);
-  }
-
-  /* Agendando um novo alarme relativo */
-  agenda_alarme_em(rtc_ds3231.i2c, 0, 10);  // Alarme em 1 minuto e 30 segundos
+  /* Agendando o primeiro alarme; flags pendentes são limpas na mesma escrita */
+#ifdef GRADE_PERIODO_MIN
+  agenda_alarme_grade(rtc_ds3231.i2c, &grade_alarme);
+#else
+  agenda_alarme_em(rtc_ds3231.i2c, 0, 10);
+#endif
 
-  /* Configurando interrupção na GPIO de wake-up para borda de descida */
-  gpio_set_irq_enabled_with_callback(
-    WAKE_GPIO,
-    GPIO_IRQ_EDGE_FALL,
-    true,
-    &gpio_callback
-  );
+  /* Registrando a GPIO de wake-up (borda de descida) no despachante dos despertares */
+  registra_fonte_despertar(WAKE_GPIO, GPIO_IRQ_EDGE_FALL, DESPERTAR_ALARME_RTC, NULL);
+  registra_tratador_despertar(DESPERTAR_ALARME_RTC, trata_alarme_rtc);
+  PERFIL_MARCA(PERFIL_RTC);
 
   uart_puts(UART_ID, "Sistema iniciado!!\n\r");
   uart_default_tx_wait_blocking();
+  PERFIL_MARCA(PERFIL_UART);
 }
 
       
 void loop() {
+
+  /* Encerrando o perfil do ciclo anterior (despejo periódico pela UART) */
+  PERFIL_ENCERRA_CICLO(UART_ID);
     
+#ifdef SONO_ROSC_KHZ
+  /* Configurando sistema para executar a partir do ROSC calibrado; a contagem de frequência
+     usa o XOSC como referência, então é feita antes da troca */
+  rosc_restore_calibration(SONO_ROSC_KHZ, SONO_ROSC_TOLERANCIA_KHZ);
+  sleep_run_from_rosc();
+#else
   /* Configurando sistema para executar a partir do cristal externo (XOSC) */
   sleep_run_from_xosc();
+#endif
   
-  /* Entrando em modo de baixo consumo até ocorrência de interrupção */
+  /* Entrando em modo de baixo consumo até ocorrência de interrupção; o watchdog só
+     fica desligado aqui, com o próximo alarme já agendado */
+  supervisor_dorme();
   enter_low_power_sleep_until_interrupt();
+  PERFIL_MARCA(PERFIL_DESPERTOU);
   
   /* Restaurando estado dos clocks após o modo Sleep */
+  supervisor_inicia_ciclo();
   recover_from_sleep(scb_orig, clock0_orig, clock1_orig);
+  PERFIL_MARCA(PERFIL_CLOCKS);
+
+  supervisor_fase(PERFIL_SENSOR, SUPERVISOR_PRAZO_SENSOR_MS);
+#ifndef SHT30_MODO_PERIODICO
+  /* Iniciando a conversão do SHT30 logo após o despertar; o resultado é coletado
+     mais adiante, depois das tarefas que não dependem dele */
+  sht30_start_measurement(&sht30, SHT30_REPETIBILIDADE);
+#endif
   
+  /* Reagendando o alarme antes das fases que podem travar: se a flag estiver
+     ativa, ela é limpa e o próximo alarme agendado com uma leitura e uma escrita em
+     bloco. Um reset do watchdog no meio do ciclo já encontra o despertar garantido */
+  supervisor_fase(PERFIL_RTC, SUPERVISOR_PRAZO_RTC_MS);
+#ifdef GRADE_PERIODO_MIN
+  reagenda_grade_disparada(i2c1, &grade_alarme);
+#else
+  reagenda_alarme_disparado(i2c1, 0, 10);
+#endif
+  PERFIL_MARCA(PERFIL_RTC);
+
   /* Reconfigurando UART e notificando início do envio LoRa */
+  supervisor_fase(PERFIL_UART, SUPERVISOR_PRAZO_UART_MS);
   uart_init(UART_ID, BAUD_RATE);
   gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART);
 
   uart_puts(UART_ID, "Entrando no modo operacao\n\r");
   uart_default_tx_wait_blocking();
+  PERFIL_MARCA(PERFIL_UART);
   
-  /* Lendo dados do sensor SHT30 (umidade e temperatura) */
-  if (!ler_sensor_sht30(&sht30)) {
-    /* Informando erro na leitura do sensor via UART */
-    uart_puts(UART_ID, "Erro ao ler sensor SHT30!\n\r");
-    uart_default_tx_wait_blocking();
-    return;
-  }
-
-  /* Formatando mensagem com dados lidos (umidade, temperatura e precipitação) */
-  char message[100];
-  snprintf(message, sizeof(message),
-          "Hum=%.1f%%,Temp=%.1fC",
-          sht30.umidade, sht30.temperatura);
-
-  /* Enviando mensagem formatada via UART */
-  uart_puts(UART_ID, message);
-  uart_puts(UART_ID, "\n\r");
-  uart_default_tx_wait_blocking();
+  /* Coletando a medição do SHT30 */
+  supervisor_fase(PERFIL_SENSOR, SUPERVISOR_PRAZO_SENSOR_MS);
+  bool leitura_ok = coleta_sht30();
+  PERFIL_MARCA(PERFIL_SENSOR);
 
+  /* Mensagens e despejo do perfil até o sono */
+  supervisor_fase(PERFIL_UART, SUPERVISOR_PRAZO_UART_MS);
 
-  /* Reagendando alarme */
-  uint8_t stat;
-  ds3231_read_reg(i2c1, DS3231_REG_STATUS, &stat);
+  if (leitura_ok) {
+    sht30_acumula(&acumulador_sht30, &sht30);
+  }
 
-  if (stat & DS3231_STAT_A1F) {
-    /* Limpando a flag A1F para permitir que futuros eventos de alarme */
-    stat &= ~DS3231_STAT_A1F;
-    ds3231_write_reg(i2c1, DS3231_REG_STATUS, stat);
+  if (leitura_ok && acumulador_sht30.amostras >= SHT30_AMOSTRAS_POR_ENVIO) {
+    /* Formatando mensagem com dados lidos (umidade, temperatura e precipitação) */
+    char message[100];
+#if SHT30_AMOSTRAS_POR_ENVIO > 1
+    snprintf(message, sizeof(message),
+            "Hum=%.1f/%.1f/%.1f%%,Temp=%.1f/%.1f/%.1fC,n=%u",
+            acumulador_sht30.umid_min, sht30_media_umidade(&acumulador_sht30), acumulador_sht30.umid_max,
+            acumulador_sht30.temp_min, sht30_media_temperatura(&acumulador_sht30), acumulador_sht30.temp_max,
+            acumulador_sht30.amostras);
+#else
+    snprintf(message, sizeof(message),
+            "Hum=%.1f%%,Temp=%.1fC",
+            sht30.umidade, sht30.temperatura);
+#endif
+    sht30_zera_acumulador(&acumulador_sht30);
 
-    /* Agendando um novo alarme */
-    agenda_alarme_em(i2c1, 0, 10);
-    // uart_puts(UART_ID, ">> Alarme tratado e reagendado <<\n\r");
-    // uart_tx_wait_blocking(UART_ID);
+    /* Enviando mensagem formatada via UART */
+    uart_puts(UART_ID, message);
+    uart_puts(UART_ID, "\n\r");
+    uart_default_tx_wait_blocking();
+    PERFIL_MARCA(PERFIL_UART);
+  } else if (!leitura_ok) {
+    /* Informando erro na leitura do sensor via UART; o alarme já foi reagendado */
+    uart_puts(UART_ID, "Erro ao ler sensor SHT30!\n\r");
+    uart_default_tx_wait_blocking();
+    PERFIL_MARCA(PERFIL_UART);
   }
 
   uart_puts(UART_ID, ">> Indo dormir novamente... <<\n\r");
   uart_tx_wait_blocking(UART_ID);
+  PERFIL_MARCA(PERFIL_UART);
 }
 
 #endif
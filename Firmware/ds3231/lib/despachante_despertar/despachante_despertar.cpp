@@ -0,0 +1,131 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  despachante_despertar.cpp
+ *
+ *    Description:  -
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 23:59:58
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include "despachante_despertar.hpp"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+#include "pico/time.h"
+
+/*
+ * Fila de um produtor e um consumidor: só os handlers avançam 'escrita' e só o
+ * laço principal avança 'leitura'. Os índices crescem livremente (a diferença
+ * é a ocupação) e cada um é escrito por um único lado, sem desligar interrupções.
+*/
+typedef struct {
+    EventoDespertar eventos[DESPERTAR_TAM_FILA];
+    volatile uint32_t escrita;
+    volatile uint32_t leitura;
+} FilaDespertar;
+
+/* Fonte registrada por GPIO */
+typedef struct {
+    bool registrada;
+    uint8_t tipo;
+    FiltroDespertar filtro;
+} FonteDespertar;
+
+static FilaDespertar fila;
+static FonteDespertar fontes[DESPERTAR_NUM_GPIOS];
+static TratadorDespertar tratadores[DESPERTAR_NUM_TIPOS];
+static EstatisticasDespertar estatisticas;
+
+/* ============================================================================
+ *  Produtor (handlers de interrupção)
+ * ============================================================================
+*/
+
+bool sinaliza_despertar(TipoDespertar tipo, uint8_t origem, uint32_t dado) {
+    uint32_t escrita = fila.escrita;
+    if (escrita - fila.leitura >= DESPERTAR_TAM_FILA) {
+        estatisticas.perdidos++;
+        return false;
+    }
+
+    EventoDespertar *evento = &fila.eventos[escrita & (DESPERTAR_TAM_FILA - 1)];
+    evento->t_us = time_us_32();
+    evento->dado = dado;
+    evento->tipo = (uint8_t)tipo;
+    evento->origem = origem;
+
+    /* O evento fica completo na memória antes de ser publicado pelo índice */
+    __dmb();
+    fila.escrita = escrita + 1;
+    return true;
+}
+
+/* Callback de GPIO do núcleo 0: toda borda de uma fonte registrada vira um evento */
+static void callback_despertar(uint gpio, uint32_t eventos) {
+    if (gpio >= DESPERTAR_NUM_GPIOS || !fontes[gpio].registrada) return;
+    if (fontes[gpio].filtro && !fontes[gpio].filtro(gpio, eventos)) return;
+    sinaliza_despertar((TipoDespertar)fontes[gpio].tipo, (uint8_t)gpio, eventos);
+}
+
+void registra_fonte_despertar(uint gpio, uint32_t eventos, TipoDespertar tipo, FiltroDespertar filtro) {
+    if (gpio >= DESPERTAR_NUM_GPIOS) return;
+
+    fontes[gpio].tipo = (uint8_t)tipo;
+    fontes[gpio].filtro = filtro;
+    fontes[gpio].registrada = true;
+    gpio_set_irq_enabled_with_callback(gpio, eventos, true, &callback_despertar);
+}
+
+/* ============================================================================
+ *  Consumidor (laço principal)
+ * ============================================================================
+*/
+
+static bool retira(EventoDespertar *evento) {
+    uint32_t leitura = fila.leitura;
+    if (leitura == fila.escrita) return false;
+
+    /* Lendo o evento só depois de ver o índice que o publicou, e liberando a posição
+       só depois de copiá-lo */
+    __dmb();
+    *evento = fila.eventos[leitura & (DESPERTAR_TAM_FILA - 1)];
+    __dmb();
+    fila.leitura = leitura + 1;
+    return true;
+}
+
+void registra_tratador_despertar(TipoDespertar tipo, TratadorDespertar tratador) {
+    if (tipo < DESPERTAR_NUM_TIPOS) tratadores[tipo] = tratador;
+}
+
+uint32_t despacha_despertar(void) {
+    uint32_t ciclo = 0;
+    EventoDespertar evento;
+
+    while (retira(&evento)) {
+        if (evento.tipo >= DESPERTAR_NUM_TIPOS) continue;
+        estatisticas.eventos[evento.tipo]++;
+
+        TratadorDespertar tratador = tratadores[evento.tipo];
+        if (tratador && tratador(&evento)) {
+            ciclo |= DESPERTAR_BIT(evento.tipo);
+        } else {
+            estatisticas.descartados++;
+        }
+    }
+    return ciclo;
+}
+
+const EstatisticasDespertar *estatisticas_despertar(void) {
+    return &estatisticas;
+}
+
+/*****************************END OF FILE**************************************/
@@ -0,0 +1,112 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  despachante_despertar.hpp
+ *
+ *    Description:  Despachante dos despertares: os handlers de interrupção (GPIO do
+ *                  INT do DS3231, sensor Hall, wrap do PWM) só enfileiram eventos
+ *                  tipados em uma fila sem trava, e o laço principal executa apenas
+ *                  os tratadores que cada evento pede. Um despertar que não exige
+ *                  o ciclo completo é descartado ainda nos clocks do sono.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 23:59:52
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#ifndef DESPACHANTE_DESPERTAR_HPP
+#define DESPACHANTE_DESPERTAR_HPP
+
+#include <Arduino.h>
+
+/****************************************************************************
+**                            CONFIGURAÇÃO
+*****************************************************************************/
+
+/* Eventos na fila (potência de 2); com a fila cheia o evento é contado como perdido */
+#define DESPERTAR_TAM_FILA            16
+
+/* GPIOs do banco 0 que podem ser registradas como fonte */
+#define DESPERTAR_NUM_GPIOS           30
+
+/* Origem dos eventos */
+typedef enum {
+    DESPERTAR_ALARME_RTC = 0,   /* INT/SQW do DS3231 (A1F/A2F) */
+    DESPERTAR_TOMBO,            /* Tombo do pluviômetro fora do dormant */
+    DESPERTAR_CONTADOR,         /* Wrap do contador PWM do pluviômetro */
+    DESPERTAR_NUM_TIPOS
+} TipoDespertar;
+
+#define DESPERTAR_BIT(tipo)           (1u << (tipo))
+
+/* Evento enfileirado pelo handler de interrupção (12 bytes) */
+typedef struct {
+    uint32_t t_us;              /* time_us_32() no handler */
+    uint32_t dado;              /* Bordas (GPIO_IRQ_*) ou valor informado pelo produtor */
+    uint8_t tipo;               /* TipoDespertar */
+    uint8_t origem;             /* GPIO ou slice que gerou o evento */
+} EventoDespertar;
+
+/*
+ * Filtro executado no próprio handler de GPIO, antes de enfileirar: retorna false
+ * para descartar a borda (ex.: repique do ímã). Deve ser curto.
+*/
+typedef bool (*FiltroDespertar)(uint gpio, uint32_t eventos);
+
+/* Tratador executado no laço principal: retorna true se o evento exige o ciclo completo */
+typedef bool (*TratadorDespertar)(const EventoDespertar *evento);
+
+/* Contadores acumulados desde o boot */
+typedef struct {
+    uint32_t eventos[DESPERTAR_NUM_TIPOS];  /* Eventos despachados por tipo */
+    uint32_t descartados;       /* Eventos sem tratador ou cujo tratador não pediu o ciclo */
+    uint32_t perdidos;          /* Eventos sinalizados com a fila cheia */
+} EstatisticasDespertar;
+
+/****************************************************************************
+**                            FUNÇÕES AUXILIARES DE USO
+*****************************************************************************/
+
+/**
+ * @brief Registra uma GPIO como fonte de despertar: habilita a interrupção nas
+ *        bordas indicadas e instala o callback de GPIO do despachante (único no
+ *        núcleo 0)
+ *
+ * @param filtro Executado no handler antes de enfileirar (NULL enfileira toda borda)
+*/
+void registra_fonte_despertar(uint gpio, uint32_t eventos, TipoDespertar tipo, FiltroDespertar filtro);
+
+/**
+ * @brief Define o tratador de um tipo de evento (NULL: o evento só é contado)
+*/
+void registra_tratador_despertar(TipoDespertar tipo, TratadorDespertar tratador);
+
+/**
+ * @brief Enfileira um evento. Só pode ser chamada de handlers de interrupção do
+ *        núcleo 0 com a mesma prioridade (não se preemptam: um único produtor por vez)
+ *
+ * @return false se a fila estava cheia
+*/
+bool sinaliza_despertar(TipoDespertar tipo, uint8_t origem, uint32_t dado);
+
+/**
+ * @brief Esvazia a fila executando o tratador de cada evento, no laço principal
+ *        (único consumidor)
+ *
+ * @return Máscara DESPERTAR_BIT() dos tipos cujo tratador pediu o ciclo completo
+*/
+uint32_t despacha_despertar(void);
+
+/**
+ * @brief Contadores de eventos desde o boot
+*/
+const EstatisticasDespertar *estatisticas_despertar(void);
+
+#endif
+/*****************************END OF FILE**************************************/
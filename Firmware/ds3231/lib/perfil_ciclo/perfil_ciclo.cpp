@@ -0,0 +1,180 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  perfil_ciclo.cpp
+ *
+ *    Description:  -
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 16:18:47
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include "perfil_ciclo.hpp"
+#include <stdio.h>
+
+/* Nomes curtos das fases, na ordem de FasePerfil */
+static const char *const nomes_fases[PERFIL_NUM_FASES] = {
+    "boot", "despertou", "clocks", "radio", "sessao", "sensor",
+    "uart", "envio", "rtc", "espera", "despejo", "dormir",
+};
+
+const char *perfil_nome_fase(uint8_t fase) {
+    return (fase < PERFIL_NUM_FASES) ? nomes_fases[fase] : "?";
+}
+
+/* Índice 0 reservado para clock desconhecido (ex.: clocks do sono, ROSC) */
+const uint8_t perfil_mhz_clock[PERFIL_NUM_MHZ_CLOCK] = { 0, 12, 24, 48, 125 };
+
+uint8_t perfil_codifica_clock(uint32_t sys_hz, uint8_t vsel) {
+    for (uint8_t i = 1; i < PERFIL_NUM_MHZ_CLOCK; i++) {
+        if (sys_hz == (uint32_t)perfil_mhz_clock[i] * 1000000u) {
+            return (uint8_t)((vsel << 4) | i);
+        }
+    }
+    return 0;
+}
+
+bool perfil_decodifica_clock(uint8_t clock, uint32_t *mhz, float *volts) {
+    uint8_t indice = PERFIL_CLOCK_INDICE(clock);
+    if (indice == 0 || indice >= PERFIL_NUM_MHZ_CLOCK) return false;
+
+    /* VSEL: 0,80 V até 0b0101, depois 50 mV por passo (0b1011 = 1,10 V) */
+    uint8_t vsel = PERFIL_CLOCK_VSEL(clock);
+    *mhz = perfil_mhz_clock[indice];
+    *volts = (vsel <= 5) ? 0.80f : 0.55f + 0.05f * vsel;
+    return true;
+}
+
+void perfil_serializa_marca(const MarcaPerfil *marca, uint8_t *dst) {
+    dst[0] = (uint8_t)(marca->t_us);
+    dst[1] = (uint8_t)(marca->t_us >> 8);
+    dst[2] = (uint8_t)(marca->t_us >> 16);
+    dst[3] = (uint8_t)(marca->t_us >> 24);
+    dst[4] = (uint8_t)(marca->ciclo);
+    dst[5] = (uint8_t)(marca->ciclo >> 8);
+    dst[6] = marca->fase;
+    dst[7] = marca->clock;
+}
+
+void perfil_desserializa_marca(const uint8_t *src, MarcaPerfil *marca) {
+    marca->t_us = (uint32_t)src[0] | ((uint32_t)src[1] << 8) |
+                  ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+    marca->ciclo = (uint16_t)(src[4] | (src[5] << 8));
+    marca->fase = src[6];
+    marca->clock = src[7];
+}
+
+
+/* ============================================================================
+ *  Registro das marcas (apenas no firmware)
+ * ============================================================================
+*/
+
+#if defined(ARDUINO_ARCH_RP2040) || defined(PICO_SIM)
+
+#include "pico/time.h"
+#include "hardware/uart.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/vreg_and_chip_reset.h"
+
+/* Buffer circular mantido na RAM, que é preservada durante o sono */
+static MarcaPerfil anel[PERFIL_TAM_ANEL];
+static uint32_t total_marcas = 0;      /* Marcas registradas desde o boot */
+static uint32_t total_despejadas = 0;  /* Marcas já enviadas (ou perdidas) */
+static uint16_t ciclo_atual = 0;
+static uint16_t ciclos_sem_despejo = 0;
+
+/**
+ * @brief Registra a marca de fim da fase indicada.
+ *
+ * O timer do RP2040 não é contado enquanto o clock do sistema está desligado no
+ * sono, por isso só as diferenças entre marcas do mesmo ciclo têm significado.
+*/
+void perfil_marca(FasePerfil fase) {
+    if (fase == PERFIL_DESPERTOU) ciclo_atual++;
+
+    MarcaPerfil *marca = &anel[total_marcas & (PERFIL_TAM_ANEL - 1)];
+    marca->t_us = (uint32_t)time_us_64();
+    marca->ciclo = ciclo_atual;
+    marca->fase = (uint8_t)fase;
+    marca->clock = perfil_codifica_clock(clock_get_hz(clk_sys),
+                                         (vreg_and_chip_reset_hw->vreg & VREG_AND_CHIP_RESET_VREG_VSEL_BITS) >>
+                                         VREG_AND_CHIP_RESET_VREG_VSEL_LSB);
+    total_marcas++;
+}
+
+/**
+ * @brief Envia pela UART as marcas ainda não despejadas.
+ *
+ * Marcas sobrescritas antes do despejo são contadas como perdidas.
+*/
+void perfil_despeja(uart_inst_t *uart) {
+    uint32_t perdidas = 0;
+    if (total_marcas - total_despejadas > PERFIL_TAM_ANEL) {
+        perdidas = total_marcas - total_despejadas - PERFIL_TAM_ANEL;
+        total_despejadas = total_marcas - PERFIL_TAM_ANEL;
+    }
+
+#ifdef PERFIL_FORMATO_BINARIO
+    while (total_despejadas < total_marcas || perdidas) {
+        uint32_t pendentes = total_marcas - total_despejadas;
+        uint8_t n = (uint8_t)(pendentes > PERFIL_MAX_POR_QUADRO ? PERFIL_MAX_POR_QUADRO : pendentes);
+        uint8_t cabecalho[4] = {
+            PERFIL_SINC_0, PERFIL_SINC_1, n, (uint8_t)(perdidas > 255 ? 255 : perdidas)
+        };
+        uint8_t soma = cabecalho[2] ^ cabecalho[3];
+        uart_write_blocking(uart, cabecalho, sizeof(cabecalho));
+
+        for (uint8_t i = 0; i < n; i++) {
+            uint8_t bytes[PERFIL_TAM_MARCA];
+            perfil_serializa_marca(&anel[total_despejadas & (PERFIL_TAM_ANEL - 1)], bytes);
+            for (uint8_t j = 0; j < PERFIL_TAM_MARCA; j++) soma ^= bytes[j];
+            uart_write_blocking(uart, bytes, sizeof(bytes));
+            total_despejadas++;
+        }
+        uart_write_blocking(uart, &soma, 1);
+        perdidas = 0;
+    }
+#else
+    char linha[40];
+    if (perdidas) {
+        snprintf(linha, sizeof(linha), "P!,%lu\n\r", (unsigned long)perdidas);
+        uart_puts(uart, linha);
+    }
+    while (total_despejadas < total_marcas) {
+        const MarcaPerfil *marca = &anel[total_despejadas & (PERFIL_TAM_ANEL - 1)];
+        snprintf(linha, sizeof(linha), "P,%u,%u,%lu,%u\n\r",
+                 marca->ciclo, marca->fase, (unsigned long)marca->t_us, marca->clock);
+        uart_puts(uart, linha);
+        total_despejadas++;
+    }
+#endif
+
+    uart_tx_wait_blocking(uart);
+}
+
+/**
+ * @brief Fecha o ciclo atual antes de dormir.
+ *
+ * O despejo é feito antes da marca PERFIL_DORMIR e registrado como PERFIL_DESPEJO,
+ * de modo que o seu custo aparece no ciclo em que ocorreu (e no próximo despejo).
+*/
+void perfil_encerra_ciclo(uart_inst_t *uart) {
+    if (++ciclos_sem_despejo >= PERFIL_CICLOS_POR_DESPEJO) {
+        ciclos_sem_despejo = 0;
+        perfil_despeja(uart);
+        perfil_marca(PERFIL_DESPEJO);
+    }
+    perfil_marca(PERFIL_DORMIR);
+}
+
+#endif
+
+/*****************************END OF FILE**************************************/
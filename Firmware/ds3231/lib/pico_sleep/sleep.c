@@ -19,6 +19,8 @@
 #include "hardware/sync.h"
 // For scb_hw so we can enable deep sleep
 #include "hardware/structs/scb.h"
+// For syscfg_hw so we can power down memories
+#include "hardware/structs/syscfg.h"
 
 // The difference between sleep and dormant is that ALL clocks are stopped in dormant mode,
 // until the source (either xosc or rosc) is started again by an external event.
@@ -27,7 +29,7 @@
 // can't be stopped in sleep mode otherwise there wouldn't be enough logic to wake up again.
 
 
-// TODO: Optionally, memories can also be powered down.
+// Memories can also be powered down while waiting: see sleep_wfi_with_memories_powered_down().
 
 static dormant_source_t _dormant_source;
 
@@ -42,8 +44,13 @@ void sleep_run_from_dormant_source(dormant_source_t dormant_source) {
     assert(dormant_source_valid(dormant_source));
     _dormant_source = dormant_source;
 
-    // FIXME: Just defining average rosc freq here.
-    uint src_hz = (dormant_source == DORMANT_SOURCE_XOSC) ? XOSC_MHZ * MHZ : 6.5 * MHZ;
+    // Measured rosc freq if rosc_calibrate() has run, otherwise the average one
+    uint src_hz;
+    if (dormant_source == DORMANT_SOURCE_XOSC) {
+        src_hz = XOSC_MHZ * MHZ;
+    } else {
+        src_hz = rosc_calibrated_khz() ? rosc_calibrated_khz() * KHZ : 6.5 * MHZ;
+    }
     uint clk_ref_src = (dormant_source == DORMANT_SOURCE_XOSC) ?
                        CLOCKS_CLK_REF_CTRL_SRC_VALUE_XOSC_CLKSRC :
                        CLOCKS_CLK_REF_CTRL_SRC_VALUE_ROSC_CLKSRC_PH;
@@ -121,6 +128,27 @@ void sleep_goto_sleep_until(datetime_t *t, rtc_callback_t callback) {
     __wfi();
 }
 
+void sleep_wfi_with_memories_powered_down(uint32_t mem_mask) {
+    // Masking interrupts: no handler may run (or touch ROM/RAM being powered down)
+    // until the memories are back. __wfi() still returns on a pending interrupt.
+    uint32_t status = save_and_disable_interrupts();
+    uint32_t previous = syscfg_hw->mempowerdown;
+
+    syscfg_hw->mempowerdown = previous | mem_mask;
+    __wfi();
+    syscfg_hw->mempowerdown = previous;
+
+    restore_interrupts(status);
+}
+
+// Symbols from the SDK linker script (memmap_default.ld)
+extern char __scratch_x_start__[];
+extern char __scratch_x_end__[];
+
+bool sleep_scratch_x_unused(void) {
+    return __scratch_x_start__ == __scratch_x_end__;
+}
+
 static void _go_dormant(void) {
     assert(dormant_source_valid(_dormant_source));
 
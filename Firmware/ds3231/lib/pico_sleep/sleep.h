@@ -103,6 +103,38 @@ static inline void sleep_goto_dormant_until_level_high(uint gpio_pin) {
     sleep_goto_dormant_until_pin(gpio_pin, false, true);
 }
 
+/*! \brief Send system to sleep until a low level is detected on GPIO
+ *  \ingroup hardware_sleep
+ *
+ * Wakes immediately if the pin is already low, so an edge consumed before
+ * going dormant is not lost. One of the sleep_run_* functions must be called
+ * prior to this call
+ *
+ * \param gpio_pin The pin to provide the wake up
+ */
+static inline void sleep_goto_dormant_until_level_low(uint gpio_pin) {
+    sleep_goto_dormant_until_pin(gpio_pin, false, false);
+}
+
+/*! \brief Wait for an interrupt (__wfi) with some memories powered down
+ *  \ingroup hardware_sleep
+ *
+ * The caller configures SLEEPDEEP and the SLEEP_EN registers. The memories in mem_mask
+ * (SYSCFG_MEMPOWERDOWN bits) lose their contents. Interrupts are masked around __wfi() so that
+ * the memories are powered up again before any handler runs; a pending interrupt still wakes
+ * the core, and its handler runs on return.
+ *
+ * \param mem_mask SYSCFG_MEMPOWERDOWN bits to power down while waiting
+ */
+void sleep_wfi_with_memories_powered_down(uint32_t mem_mask);
+
+/*! \brief Check that nothing was linked into scratch X (SRAM4)
+ *  \ingroup hardware_sleep
+ *
+ * With core 1 idle, SRAM4 then holds no state and can be powered down while sleeping.
+ */
+bool sleep_scratch_x_unused(void);
+
 #ifdef __cplusplus
 }
 #endif
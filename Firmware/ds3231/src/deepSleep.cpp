@@ -23,11 +23,17 @@
 #include "hardware/rtc.h"
 #include "hardware/clocks.h"
 #include "hardware/gpio.h"
+#include "hardware/sync.h"
 #include "hardware/xosc.h"
 #include "hardware/structs/scb.h"
+#include "hardware/structs/syscfg.h"
 #include "hardware/uart.h"
 #include "pico/runtime_init.h"
 #include "../lib/ds3231_rtc/ds3231.hpp"
+#include "../lib/perfil_ciclo/perfil_ciclo.hpp"
+#include "../lib/clock_despertar/clock_despertar.hpp"
+#include "../lib/supervisor_ciclo/supervisor_ciclo.hpp"
+#include "../lib/despachante_despertar/despachante_despertar.hpp"
 
 #define UART_ID uart0
 #define BAUD_RATE 9600
@@ -37,10 +43,67 @@
 #define I2C_SCL_PIN 27
 #define WAKE_GPIO 28
 
+/* Agendamento em grade absoluta: definindo GRADE_PERIODO_MIN (divisor de 1440, ex.: -D GRADE_PERIODO_MIN=15)
+   os despertares ficam alinhados ao relógio do RTC (00:00, 00:15, ...) sem acumular atraso. GRADE_FASE_SEG
+   desloca a grade (escalonamento entre nós ou, com 1440, o horário do envio diário). Sem a definição o
+   alarme é relativo ao fim de cada ciclo */
+#ifdef GRADE_PERIODO_MIN
+#ifndef GRADE_FASE_SEG
+#define GRADE_FASE_SEG 0
+#endif
+static const GradeAlarme grade_alarme = { GRADE_PERIODO_MIN, GRADE_FASE_SEG };
+#endif
+
+/* Memórias desligadas no sono: definindo SONO_DESLIGA_MEMORIAS a ROM e a SRAM4 (scratch X, sem
+   conteúdo com o core 1 parado) são desligadas pelo SYSCFG durante o __wfi(), assim como a DPRAM
+   do USB com PIO_FRAMEWORK_ARDUINO_NO_USB. A região de retenção são as SRAMs 0-3 (intercaladas,
+   com .data, .bss e heap: sessão, contadores e anéis) e a SRAM5 (pilha do core 0) */
+#ifdef SONO_DESLIGA_MEMORIAS
+static uint32_t memorias_desligadas_no_sono(void) {
+  uint32_t mascara = SYSCFG_MEMPOWERDOWN_ROM_BITS;
+#ifdef PIO_FRAMEWORK_ARDUINO_NO_USB
+  mascara |= SYSCFG_MEMPOWERDOWN_USB_BITS;
+#endif
+  if (sleep_scratch_x_unused()) mascara |= SYSCFG_MEMPOWERDOWN_SRAM4_BITS;
+  return mascara;
+}
+#endif
+
+/* Sono a partir do ROSC: definindo SONO_ROSC_KHZ (ex.: -D SONO_ROSC_KHZ=6000) o sono roda do oscilador
+   em anel e o XOSC fica desligado. A calibração (busca binária contra o XOSC) guarda código e frequência
+   medida na RAM, e os ciclos seguintes só conferem o código com uma contagem, refazendo a busca se a
+   deriva passar de SONO_ROSC_TOLERANCIA_KHZ. Os clocks do sono usam a frequência medida */
+#ifdef SONO_ROSC_KHZ
+#ifndef SONO_ROSC_TOLERANCIA_KHZ
+#define SONO_ROSC_TOLERANCIA_KHZ (SONO_ROSC_KHZ / 50)
+#endif
+#endif
+
+/* Perfis de clock no despertar: definindo CLOCK_DESPERTAR_PERFIS o ciclo acorda em 12 MHz do
+   XOSC, sem religar os PLLs (clocks_init() trava os dois PLLs a cada despertar só para
+   sleep_run_from_xosc() desligá-los de novo). Sem rádio, todos os ciclos
+   usam o perfil dos sensores.
+   UART e I2C têm os divisores reajustados a cada troca de perfil. Com CLOCK_GOVERNADOR a tensão
+   do núcleo também acompanha o perfil (0,95 V nos 12 MHz do XOSC) */
+#ifdef CLOCK_DESPERTAR_PERFIS
+static const PerifericosClock perifericos_clock = { UART_ID, BAUD_RATE, i2c1, 400 * 1000, NULL, 0 };
+#endif
+
+/* Maior tempo acordado de um ciclo: a espera de 3 s do modo de execução domina */
+#define SUPERVISOR_CICLO_MAX_MS 5000
+
 extern DS3231 rtc_ds3231;
 
-/* Habilitando função de callback para tratar interrupções na GPIO */
-void gpio_callback(uint gpio, uint32_t events) {}
+/* Alarme do DS3231: o INT fica em nível baixo até A1F/A2F serem limpos no reagendamento,
+   então uma borda com a linha já de volta em nível alto foi ruído e não abre um ciclo */
+static bool trata_alarme_rtc(const EventoDespertar *evento) {
+  return !gpio_get(evento->origem);
+}
+
+/* O ciclo completo só roda com o alarme; o INT baixo sem evento na fila é uma borda perdida */
+static bool alarme_pendente(void) {
+  return (despacha_despertar() & DESPERTAR_BIT(DESPERTAR_ALARME_RTC)) || !gpio_get(WAKE_GPIO);
+}
 
 /* Declarando variáveis para salvar o estado atual dos clocks */
 static uint scb_orig;
@@ -72,8 +135,22 @@ void enter_low_power_sleep_until_interrupt(void) {
   uint save = scb_hw->scr;
   scb_hw->scr = save | M0PLUS_SCR_SLEEPDEEP_BITS;
 
-  /* Entrando em modo de baixo consumo até que ocorra uma interrupção */
-  __wfi();
+  /* Entrando em modo de baixo consumo até que ocorra uma interrupção. Despertares que não
+     exigem o ciclo (ruído no INT, IRQs de outros periféricos) são despachados ainda nos
+     clocks do sono e o núcleo volta direto ao __wfi(). Com as interrupções mascaradas entre
+     a verificação e o __wfi(), um evento que chegue no meio fica pendente e encerra o
+     __wfi() na hora, em vez de o núcleo dormir com o alarme já disparado */
+  uint32_t estado = save_and_disable_interrupts();
+  do {
+#ifdef SONO_DESLIGA_MEMORIAS
+    sleep_wfi_with_memories_powered_down(memorias_desligadas_no_sono());
+#else
+    __wfi();
+#endif
+    restore_interrupts(estado);
+    estado = save_and_disable_interrupts();
+  } while (!alarme_pendente());
+  restore_interrupts(estado);
 }
 
 /*
@@ -88,14 +165,25 @@ void recover_from_sleep(uint scb_orig, uint clock0_orig, uint clock1_orig) {
   scb_hw->scr = scb_orig;
   clocks_hw->sleep_en0 = clock0_orig;
   clocks_hw->sleep_en1 = clock1_orig;
+#ifdef CLOCK_DESPERTAR_PERFIS
+  aplica_perfil_clock(CLOCK_PERFIL_SENSOR, &perifericos_clock);
+#else
   clocks_init();
+#endif
 }
 
 void setup() {
 
+  /* Registrando início do boot no perfil do ciclo */
+  PERFIL_MARCA(PERFIL_BOOT);
+
+  /* Armando o watchdog para o setup() e recuperando a fase de um travamento anterior */
+  inicializa_supervisor(SUPERVISOR_CICLO_MAX_MS);
+
   /* Inicializando UART */
   uart_init(UART_ID, BAUD_RATE);
   gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART); 
+  supervisor_informa_falha(UART_ID);
   
   /* Inicializando o módulo DS3231 com a instância I2C e os pinos definidos */
   inicializa_ds3231(&rtc_ds3231, i2c1, DS3231_I2C_ADDR, I2C_SDA_PIN, I2C_SCL_PIN);
@@ -104,71 +192,77 @@ void setup() {
   gpio_init(WAKE_GPIO);
   gpio_set_dir(WAKE_GPIO, GPIO_IN);
   
-  /* Declarando variável para armazenar o conteúdo do registrador de status */
-  uint8_t stat;
-
-  /* Lendo o registrador de status (0x0F) para verificar flags ativas */
-  ds3231_read_reg(rtc_ds3231.i2c, DS3231_REG_STATUS, &stat);
-
-  if (stat & DS3231_STAT_A1F) {
-    /* Limpando a flag A1F (bit 0), necessária para permitir futuros alarmes */
-    stat &= ~DS3231_STAT_A1F;
-
-    /* Escrevendo de volta no registrador de status com a flag A1F zerada */
-    ds3231_write_reg(rtc_ds3231.i2c, DS3231_REG_STATUS, stat);
-  }
-
-  /* Agendando um novo alarme relativo */
-  agenda_alarme_em(rtc_ds3231.i2c, 0, 1);  // Alarme em 1 minuto e 30 segundos
+  /* Agendando o primeiro alarme; flags pendentes são limpas na mesma escrita */
+#ifdef GRADE_PERIODO_MIN
+  agenda_alarme_grade(rtc_ds3231.i2c, &grade_alarme);
+#else
+  agenda_alarme_em(rtc_ds3231.i2c, 0, 1);
+#endif
 
-  /* Configurando interrupção na GPIO de wake-up para borda de descida */
-  gpio_set_irq_enabled_with_callback(
-    WAKE_GPIO,
-    GPIO_IRQ_EDGE_FALL,
-    true,
-    &gpio_callback
-  );
+  /* Registrando a GPIO de wake-up (borda de descida) no despachante dos despertares */
+  registra_fonte_despertar(WAKE_GPIO, GPIO_IRQ_EDGE_FALL, DESPERTAR_ALARME_RTC, NULL);
+  registra_tratador_despertar(DESPERTAR_ALARME_RTC, trata_alarme_rtc);
+  PERFIL_MARCA(PERFIL_RTC);
 
   uart_puts(UART_ID, "Sistema iniciado!!\n\r");
   uart_default_tx_wait_blocking();
+  PERFIL_MARCA(PERFIL_UART);
 }
   
 void loop() {
 
+  /* Encerrando o perfil do ciclo anterior (despejo periódico pela UART) */
+  PERFIL_ENCERRA_CICLO(UART_ID);
+
+#ifdef SONO_ROSC_KHZ
+  /* Configurando sistema para executar a partir do ROSC calibrado; a contagem de frequência
+     usa o XOSC como referência, então é feita antes da troca */
+  rosc_restore_calibration(SONO_ROSC_KHZ, SONO_ROSC_TOLERANCIA_KHZ);
+  sleep_run_from_rosc();
+#else
   /* Configurando sistema para executar a partir do cristal externo (XOSC) */
   sleep_run_from_xosc();
+#endif
   
-  /* Entrando em modo de baixo consumo até ocorrência de interrupção */
+  /* Entrando em modo de baixo consumo até ocorrência de interrupção; o watchdog só
+     fica desligado aqui, com o próximo alarme já agendado */
+  supervisor_dorme();
   enter_low_power_sleep_until_interrupt();
+  PERFIL_MARCA(PERFIL_DESPERTOU);
   
   /* Restaurando estado dos clocks após o modo Sleep */
+  supervisor_inicia_ciclo();
   recover_from_sleep(scb_orig, clock0_orig, clock1_orig);
+  PERFIL_MARCA(PERFIL_CLOCKS);
+
+  /* Reagendando o alarme antes das fases que podem travar: se a flag estiver
+     ativa, ela é limpa e o próximo alarme agendado com uma leitura e uma escrita em
+     bloco. Um reset do watchdog no meio do ciclo já encontra o despertar garantido */
+  supervisor_fase(PERFIL_RTC, SUPERVISOR_PRAZO_RTC_MS);
+#ifdef GRADE_PERIODO_MIN
+  reagenda_grade_disparada(i2c1, &grade_alarme);
+#else
+  reagenda_alarme_disparado(i2c1, 0, 10);
+#endif
+  PERFIL_MARCA(PERFIL_RTC);
 
   /* Reconfigurando UART e notificando início do envio LoRa */
+  supervisor_fase(PERFIL_UART, SUPERVISOR_PRAZO_UART_MS);
   uart_init(UART_ID, BAUD_RATE);
   gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART);
   uart_puts(UART_ID, "Entrando no modo operacao\n\r");
   uart_default_tx_wait_blocking();
+  PERFIL_MARCA(PERFIL_UART);
 
+  supervisor_fase(PERFIL_ESPERA, SUPERVISOR_PRAZO_ESPERA_MS);
   sleep_ms(3000); // RUN MODE
+  PERFIL_MARCA(PERFIL_ESPERA);
 
-  /* Reagendando alarme */
-  uint8_t stat;
-  ds3231_read_reg(i2c1, DS3231_REG_STATUS, &stat);
-
-  if (stat & DS3231_STAT_A1F) {
-    /* Limpando a flag A1F para permitir que futuros eventos de alarme */
-    stat &= ~DS3231_STAT_A1F;
-    ds3231_write_reg(i2c1, DS3231_REG_STATUS, stat);
-
-    /* Agendando um novo alarme */
-    agenda_alarme_em(i2c1, 0, 10);
-    // uart_puts(UART_ID, ">> Alarme tratado e reagendado <<\n\r");
-    // uart_tx_wait_blocking(UART_ID);
-  }
+  supervisor_fase(PERFIL_UART, SUPERVISOR_PRAZO_UART_MS);
 
   uart_puts(UART_ID, ">> Entrando em sleep... <<\n\r");
   uart_tx_wait_blocking(UART_ID);
+  PERFIL_MARCA(PERFIL_UART);
 
 }
 
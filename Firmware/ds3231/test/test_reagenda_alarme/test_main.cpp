@@ -0,0 +1,151 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  test_main.cpp
+ *
+ *    Description:  Testes do reagendamento do alarme contra o DS3231 simulado: cada
+ *                  despertar custa no máximo 2 transações I2C, no alarme relativo e
+ *                  na grade absoluta. Uso: pio test -e native
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 23:59:59
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include <unity.h>
+#include "pico_sim.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+#include "../../lib/ds3231_rtc/ds3231.hpp"
+
+/* Mesma ligação do firmware */
+#define I2C_SDA_PIN 26
+#define I2C_SCL_PIN 27
+#define WAKE_GPIO 28
+
+/* Limite do reagendamento: leitura em bloco da hora e do status + escrita em bloco */
+#define MAX_TRANSACOES_REAGENDA 2
+
+/* Despertares conferidos em cada teste */
+#define DESPERTARES 20
+
+static DS3231 rtc_ds3231;
+static uint32_t despertares = 0;
+
+static void gpio_callback(uint gpio, uint32_t events) {
+    (void)gpio;
+    (void)events;
+    despertares++;
+}
+
+/**
+ * @brief Dorme até a borda de descida do INT e devolve a hora do RTC no despertar
+*/
+static uint32_t dorme_ate_alarme(void) {
+    uint32_t antes = despertares;
+    __wfi();
+    TEST_ASSERT_EQUAL_UINT32(antes + 1, despertares);
+    TEST_ASSERT_FALSE(gpio_get(WAKE_GPIO));
+
+    uint32_t agora = 0;
+    TEST_ASSERT_TRUE(segundos_rtc(rtc_ds3231.i2c, &agora));
+    return agora;
+}
+
+/**
+ * @brief Transações I2C gastas por uma chamada de reagendamento
+*/
+static uint32_t transacoes_desde(uint32_t inicio) {
+    return sim_i2c_transacoes(i2c1) - inicio;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+
+/* ============================================================================
+ *  Casos de teste
+ * ============================================================================
+*/
+
+void test_reagenda_relativo(void) {
+    TEST_ASSERT_TRUE(agenda_alarme_em(rtc_ds3231.i2c, 0, 10));
+
+    uint32_t anterior = dorme_ate_alarme();
+    for (int i = 0; i < DESPERTARES; i++) {
+        uint32_t inicio = sim_i2c_transacoes(i2c1);
+        TEST_ASSERT_TRUE(reagenda_alarme_disparado(i2c1, 0, 10));
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(MAX_TRANSACOES_REAGENDA, transacoes_desde(inicio));
+
+        /* A flag foi limpa (INT liberado) e o próximo alarme vem 10 s depois */
+        TEST_ASSERT_TRUE(gpio_get(WAKE_GPIO));
+        uint32_t agora = dorme_ate_alarme();
+        TEST_ASSERT_EQUAL_UINT32(anterior + 10, agora);
+        anterior = agora;
+    }
+}
+
+void test_reagenda_relativo_sem_alarme(void) {
+    TEST_ASSERT_TRUE(agenda_alarme_em(rtc_ds3231.i2c, 0, 10));
+
+    /* Sem a flag ativa só a leitura em bloco é feita */
+    uint32_t inicio = sim_i2c_transacoes(i2c1);
+    TEST_ASSERT_FALSE(reagenda_alarme_disparado(i2c1, 0, 10));
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, transacoes_desde(inicio));
+}
+
+void test_reagenda_grade(void) {
+    const GradeAlarme grade = { 1, 15 };
+    TEST_ASSERT_TRUE(agenda_alarme_grade(rtc_ds3231.i2c, &grade));
+
+    uint32_t agora = dorme_ate_alarme();
+    TEST_ASSERT_EQUAL_UINT32(15, agora % 60);
+    for (int i = 0; i < DESPERTARES; i++) {
+        uint32_t inicio = sim_i2c_transacoes(i2c1);
+        TEST_ASSERT_TRUE(reagenda_grade_disparada(i2c1, &grade));
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(MAX_TRANSACOES_REAGENDA, transacoes_desde(inicio));
+
+        /* Despertares alinhados à grade, sem deriva */
+        TEST_ASSERT_TRUE(gpio_get(WAKE_GPIO));
+        uint32_t proximo = dorme_ate_alarme();
+        TEST_ASSERT_EQUAL_UINT32(agora + 60, proximo);
+        agora = proximo;
+    }
+}
+
+void test_reagenda_grade_sem_alarme(void) {
+    const GradeAlarme grade = { 5, 0 };
+    TEST_ASSERT_TRUE(agenda_alarme_grade(rtc_ds3231.i2c, &grade));
+
+    uint32_t inicio = sim_i2c_transacoes(i2c1);
+    TEST_ASSERT_FALSE(reagenda_grade_disparada(i2c1, &grade));
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, transacoes_desde(inicio));
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+
+    /* DS3231 simulado no barramento e INT ligado à GPIO de wake-up */
+    sim_ds3231_inicializa(i2c1, WAKE_GPIO);
+    inicializa_ds3231(&rtc_ds3231, i2c1, DS3231_I2C_ADDR, I2C_SDA_PIN, I2C_SCL_PIN);
+    gpio_init(WAKE_GPIO);
+    gpio_set_dir(WAKE_GPIO, GPIO_IN);
+    gpio_pull_up(WAKE_GPIO);
+    gpio_set_irq_enabled_with_callback(WAKE_GPIO, GPIO_IRQ_EDGE_FALL, true, &gpio_callback);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_reagenda_relativo);
+    RUN_TEST(test_reagenda_relativo_sem_alarme);
+    RUN_TEST(test_reagenda_grade);
+    RUN_TEST(test_reagenda_grade_sem_alarme);
+    return UNITY_END();
+}
+
+/*****************************END OF FILE**************************************/
@@ -0,0 +1,315 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  analisa_perfil.cpp
+ *
+ *    Description:  Analisador (host) do perfil do ciclo de despertar. Lê o log da
+ *                  UART (linhas CSV "P,..." ou quadros binários misturados às
+ *                  demais mensagens) e resume o tempo acordado por fase.
+ *
+ *                  Compilação:
+ *                    g++ -O2 -I../SHT30/lib/perfil_ciclo -o analisa_perfil \
+ *                        analisa_perfil.cpp ../SHT30/lib/perfil_ciclo/perfil_ciclo.cpp
+ *
+ *                  Uso:
+ *                    ./analisa_perfil [-c] [-i corrente_mA] [-m base:mA_por_MHz] [log_uart]
+ *                      -c  imprime também uma linha CSV por ciclo (us por fase)
+ *                      -i  corrente média acordado, para estimar a carga por ciclo
+ *                      -m  modelo de corrente por clock, para a carga por fase:
+ *                          I = base + mA_por_MHz x f x (V / 1,10)^2, com f e V
+ *                          tirados do byte de clock de cada marca (padrão 1.0:0.15)
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 16:52:10
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include "perfil_ciclo.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+/* Ciclo reconstruído a partir das marcas */
+typedef struct {
+    uint16_t ciclo;
+    bool boot;                             /* Aberto por PERFIL_BOOT */
+    bool completo;                         /* Fechado por PERFIL_DORMIR sem perdas */
+    uint32_t total_us;                     /* Da abertura até PERFIL_DORMIR */
+    uint32_t fase_us[PERFIL_NUM_FASES];    /* Tempo acumulado por fase */
+    double fase_uc[PERFIL_NUM_FASES];      /* Carga acumulada por fase (uC = mA x ms) */
+} Ciclo;
+
+/* Modelo de corrente acordado em função do clock e da tensão do núcleo */
+typedef struct {
+    double base_ma;                        /* Parcela que não depende do clock */
+    double ma_por_mhz;                     /* Parcela dinâmica a 1,10 V */
+    double sem_clock_ma;                   /* Marcas sem clock conhecido (-i, ou só a base) */
+} ModeloCorrente;
+
+static std::vector<MarcaPerfil> marcas;
+static std::vector<size_t> perdas;         /* Índice em marcas onde houve perda */
+static uint32_t quadros_invalidos = 0;
+
+
+/* ============================================================================
+ *  Extração das marcas do log
+ * ============================================================================
+*/
+
+/**
+ * @brief Tenta interpretar um quadro binário em buf[i]; retorna o tamanho ou 0
+*/
+static size_t le_quadro(const std::vector<uint8_t> &buf, size_t i) {
+    if (i + 5 > buf.size() || buf[i] != PERFIL_SINC_0 || buf[i + 1] != PERFIL_SINC_1) return 0;
+
+    uint8_t n = buf[i + 2];
+    size_t tam = 4 + (size_t)n * PERFIL_TAM_MARCA + 1;
+    if (i + tam > buf.size()) return 0;
+
+    uint8_t soma = 0;
+    for (size_t k = i + 2; k < i + tam - 1; k++) soma ^= buf[k];
+    if (soma != buf[i + tam - 1]) {
+        quadros_invalidos++;
+        return 0;
+    }
+
+    if (buf[i + 3]) perdas.push_back(marcas.size());
+    for (uint8_t k = 0; k < n; k++) {
+        MarcaPerfil marca;
+        perfil_desserializa_marca(&buf[i + 4 + (size_t)k * PERFIL_TAM_MARCA], &marca);
+        marcas.push_back(marca);
+    }
+    return tam;
+}
+
+/**
+ * @brief Tenta interpretar uma linha CSV em buf[i]; retorna o tamanho ou 0
+*/
+static size_t le_linha(const std::vector<uint8_t> &buf, size_t i) {
+    if (i > 0 && buf[i - 1] != '\n' && buf[i - 1] != '\r') return 0;
+    if (i + 2 > buf.size() || buf[i] != 'P' || (buf[i + 1] != ',' && buf[i + 1] != '!')) return 0;
+
+    char linha[48];
+    size_t n = 0;
+    while (i + n < buf.size() && buf[i + n] != '\n' && buf[i + n] != '\r' && n < sizeof(linha) - 1) {
+        linha[n] = (char)buf[i + n];
+        n++;
+    }
+    linha[n] = '\0';
+
+    /* O campo de clock é opcional: logs antigos têm só quatro campos */
+    unsigned ciclo, fase, clock = 0;
+    unsigned long t_us;
+    if (sscanf(linha, "P,%u,%u,%lu,%u", &ciclo, &fase, &t_us, &clock) >= 3) {
+        MarcaPerfil marca = { (uint32_t)t_us, (uint16_t)ciclo, (uint8_t)fase, (uint8_t)clock };
+        marcas.push_back(marca);
+        return n;
+    }
+    if (strncmp(linha, "P!,", 3) == 0) {
+        perdas.push_back(marcas.size());
+        return n;
+    }
+    return 0;
+}
+
+
+/* ============================================================================
+ *  Reconstrução dos ciclos
+ * ============================================================================
+*/
+
+/**
+ * @brief Corrente estimada (mA) de uma fase a partir do byte de clock da marca
+*/
+static double corrente_fase_ma(const ModeloCorrente &modelo, uint8_t clock) {
+    uint32_t mhz;
+    float volts;
+    if (!perfil_decodifica_clock(clock, &mhz, &volts)) return modelo.sem_clock_ma;
+
+    double escala = volts / 1.10;
+    return modelo.base_ma + modelo.ma_por_mhz * mhz * escala * escala;
+}
+
+static std::vector<Ciclo> monta_ciclos(const ModeloCorrente &modelo) {
+    std::vector<Ciclo> ciclos;
+    Ciclo atual;
+    bool aberto = false;
+    uint32_t t_abertura = 0, t_anterior = 0;
+    size_t proxima_perda = 0;
+
+    for (size_t k = 0; k < marcas.size(); k++) {
+        const MarcaPerfil &m = marcas[k];
+
+        /* Marcas perdidas invalidam o ciclo em andamento */
+        if (proxima_perda < perdas.size() && perdas[proxima_perda] == k) {
+            aberto = false;
+            proxima_perda++;
+        }
+
+        if (m.fase == PERFIL_BOOT || m.fase == PERFIL_DESPERTOU) {
+            memset(&atual, 0, sizeof(atual));
+            atual.ciclo = m.ciclo;
+            atual.boot = (m.fase == PERFIL_BOOT);
+            t_abertura = t_anterior = m.t_us;
+            aberto = true;
+            continue;
+        }
+        if (!aberto || m.fase >= PERFIL_NUM_FASES || m.ciclo != atual.ciclo) {
+            aberto = false;
+            continue;
+        }
+
+        /* Subtração em 32 bits: válida mesmo com o contador dando a volta */
+        uint32_t duracao_us = m.t_us - t_anterior;
+        atual.fase_us[m.fase] += duracao_us;
+        atual.fase_uc[m.fase] += corrente_fase_ma(modelo, m.clock) * duracao_us / 1000.0;
+        t_anterior = m.t_us;
+
+        if (m.fase == PERFIL_DORMIR) {
+            atual.total_us = m.t_us - t_abertura;
+            atual.completo = true;
+            ciclos.push_back(atual);
+            aberto = false;
+        }
+    }
+    return ciclos;
+}
+
+
+/* ============================================================================
+ *  Relatório
+ * ============================================================================
+*/
+
+static double percentil(std::vector<uint32_t> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    size_t idx = (size_t)(p * (double)(v.size() - 1) + 0.5);
+    return v[idx] / 1000.0;
+}
+
+static void imprime_resumo(const std::vector<Ciclo> &ciclos, double corrente_ma) {
+    std::vector<uint32_t> totais;
+    std::vector<uint32_t> por_fase[PERFIL_NUM_FASES];
+    double carga_fase[PERFIL_NUM_FASES] = { 0.0 };
+    double soma_total = 0.0, carga_total = 0.0;
+
+    for (const Ciclo &c : ciclos) {
+        if (c.boot) {
+            printf("boot (ciclo %u): %.3f ms\n", c.ciclo, c.total_us / 1000.0);
+            continue;
+        }
+        totais.push_back(c.total_us);
+        soma_total += c.total_us;
+        for (int f = 0; f < PERFIL_NUM_FASES; f++) {
+            if (c.fase_us[f]) por_fase[f].push_back(c.fase_us[f]);
+            carga_fase[f] += c.fase_uc[f];
+            carga_total += c.fase_uc[f];
+        }
+    }
+
+    printf("marcas: %zu | ciclos completos: %zu | perdas: %zu | quadros invalidos: %u\n\n",
+           marcas.size(), totais.size(), perdas.size(), quadros_invalidos);
+    if (totais.empty()) return;
+
+    printf("%-10s %7s %10s %10s %10s %10s %9s %10s\n",
+           "fase", "ciclos", "media_ms", "min_ms", "max_ms", "p95_ms", "%acordado", "carga_uC");
+
+    for (int f = 0; f < PERFIL_NUM_FASES; f++) {
+        const std::vector<uint32_t> &v = por_fase[f];
+        if (v.empty()) continue;
+
+        double soma = 0.0;
+        for (uint32_t d : v) soma += d;
+        printf("%-10s %7zu %10.3f %10.3f %10.3f %10.3f %8.1f%% %10.3f\n",
+               perfil_nome_fase((uint8_t)f), v.size(), soma / v.size() / 1000.0,
+               *std::min_element(v.begin(), v.end()) / 1000.0,
+               *std::max_element(v.begin(), v.end()) / 1000.0,
+               percentil(v, 0.95), 100.0 * soma / soma_total, carga_fase[f] / totais.size());
+    }
+
+    double media_ms = soma_total / totais.size() / 1000.0;
+    printf("%-10s %7zu %10.3f %10.3f %10.3f %10.3f %8.1f%% %10.3f\n", "total", totais.size(), media_ms,
+           *std::min_element(totais.begin(), totais.end()) / 1000.0,
+           *std::max_element(totais.begin(), totais.end()) / 1000.0,
+           percentil(totais, 0.95), 100.0, carga_total / totais.size());
+
+    if (corrente_ma > 0.0) {
+        /* Carga consumida acordado por ciclo: ms x mA / 3600 = uAh */
+        printf("\ncarga acordado por ciclo: %.4f uAh (%.1f mA x %.3f ms)\n",
+               media_ms * corrente_ma / 3600.0, corrente_ma, media_ms);
+    }
+}
+
+static void imprime_csv(const std::vector<Ciclo> &ciclos) {
+    printf("\nciclo,total_us");
+    for (int f = PERFIL_CLOCKS; f < PERFIL_NUM_FASES; f++) printf(",%s", perfil_nome_fase((uint8_t)f));
+    printf("\n");
+
+    for (const Ciclo &c : ciclos) {
+        if (c.boot) continue;
+        printf("%u,%lu", c.ciclo, (unsigned long)c.total_us);
+        for (int f = PERFIL_CLOCKS; f < PERFIL_NUM_FASES; f++) printf(",%lu", (unsigned long)c.fase_us[f]);
+        printf("\n");
+    }
+}
+
+
+int main(int argc, char **argv) {
+    bool csv = false;
+    double corrente_ma = 0.0;
+    ModeloCorrente modelo = { 1.0, 0.15, 0.0 };
+    const char *caminho = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0) {
+            csv = true;
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            corrente_ma = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc &&
+                   sscanf(argv[i + 1], "%lf:%lf", &modelo.base_ma, &modelo.ma_por_mhz) == 2) {
+            i++;
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            fprintf(stderr, "uso: %s [-c] [-i corrente_mA] [-m base:mA_por_MHz] [log_uart]\n", argv[0]);
+            return 2;
+        } else {
+            caminho = argv[i];
+        }
+    }
+
+    FILE *arq = caminho ? fopen(caminho, "rb") : stdin;
+    if (!arq) {
+        perror(caminho);
+        return 1;
+    }
+
+    std::vector<uint8_t> buf;
+    uint8_t bloco[4096];
+    size_t n;
+    while ((n = fread(bloco, 1, sizeof(bloco), arq)) > 0) buf.insert(buf.end(), bloco, bloco + n);
+    if (arq != stdin) fclose(arq);
+
+    /* Varrendo o log: o texto comum da UART é ignorado */
+    for (size_t i = 0; i < buf.size();) {
+        size_t usados = le_quadro(buf, i);
+        if (!usados) usados = le_linha(buf, i);
+        i += usados ? usados : 1;
+    }
+
+    modelo.sem_clock_ma = (corrente_ma > 0.0) ? corrente_ma : modelo.base_ma;
+    std::vector<Ciclo> ciclos = monta_ciclos(modelo);
+    imprime_resumo(ciclos, corrente_ma);
+    if (csv) imprime_csv(ciclos);
+    return 0;
+}
+
+/*****************************END OF FILE**************************************/
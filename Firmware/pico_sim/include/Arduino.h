@@ -0,0 +1,38 @@
+/*
+ * HAL simulada - subconjunto do Arduino.h (core arduino-pico) usado pelo firmware.
+ * setup() e loop() são chamados pelo executor da simulação (sim_main.cpp).
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "pico.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define noInterrupts() save_and_disable_interrupts()
+#define interrupts()   restore_interrupts(0)
+
+void setup(void);
+void loop(void);
+
+#endif
@@ -0,0 +1,39 @@
+/*
+ * HAL simulada do Pico SDK - hardware/adc.h
+ * Conversões únicas (START_ONCE) do canal selecionado, a partir da tensão de cada
+ * entrada definida pelo executor (sim_adc_tensao_mv). Cada conversão leva 96 ciclos
+ * de clk_adc; sem clk_adc ou com o ADC desligado a simulação é encerrada.
+ */
+
+#ifndef _HARDWARE_ADC_H
+#define _HARDWARE_ADC_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NUM_ADC_CHANNELS    5
+
+#define ADC_CS_EN_BITS      0x00000001u
+#define ADC_CS_READY_BITS   0x00000100u
+
+typedef struct {
+    uint32_t cs;
+    uint32_t result;
+} adc_hw_t;
+
+extern adc_hw_t adc_sim_hw;
+#define adc_hw (&adc_sim_hw)
+
+void adc_init(void);
+void adc_gpio_init(uint gpio);
+void adc_select_input(uint input);
+uint16_t adc_read(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
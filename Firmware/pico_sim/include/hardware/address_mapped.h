@@ -0,0 +1,30 @@
+/*
+ * HAL simulada do Pico SDK - hardware/address_mapped.h
+ * Registradores são campos comuns em RAM: os aliases atômicos viram operações diretas.
+ */
+
+#ifndef _HARDWARE_ADDRESS_MAPPED_H
+#define _HARDWARE_ADDRESS_MAPPED_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef volatile uint32_t io_rw_32;
+typedef const volatile uint32_t io_ro_32;
+
+static inline void hw_set_bits(io_rw_32 *addr, uint32_t mask) {
+    *addr |= mask;
+}
+
+static inline void hw_clear_bits(io_rw_32 *addr, uint32_t mask) {
+    *addr &= ~mask;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * HAL simulada do Pico SDK - hardware/clocks.h
+ * Mantém apenas a frequência de cada clock e os registradores SLEEP_EN.
+ */
+
+#ifndef _HARDWARE_CLOCKS_H
+#define _HARDWARE_CLOCKS_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum clock_index {
+    clk_gpout0 = 0,
+    clk_gpout1,
+    clk_gpout2,
+    clk_gpout3,
+    clk_ref,
+    clk_sys,
+    clk_peri,
+    clk_usb,
+    clk_adc,
+    clk_rtc,
+    CLK_COUNT
+};
+
+typedef struct {
+    uint32_t sleep_en0;
+    uint32_t sleep_en1;
+} clocks_hw_t;
+
+extern clocks_hw_t clocks_sim_hw;
+#define clocks_hw (&clocks_sim_hw)
+
+#define CLOCKS_SLEEP_EN0_CLK_RTC_RTC_BITS      0x00040000u
+#define CLOCKS_SLEEP_EN0_CLK_SYS_PWM_BITS      0x00008000u
+#define CLOCKS_SLEEP_EN0_CLK_SYS_I2C1_BITS     0x00000400u
+#define CLOCKS_SLEEP_EN0_CLK_SYS_I2C0_BITS     0x00000200u
+#define CLOCKS_SLEEP_EN0_CLK_SYS_PIO1_BITS     0x00002000u
+#define CLOCKS_SLEEP_EN0_CLK_SYS_PIO0_BITS     0x00001000u
+#define CLOCKS_SLEEP_EN0_CLK_SYS_DMA_BITS      0x00000020u
+#define CLOCKS_SLEEP_EN0_CLK_SYS_BUSFABRIC_BITS 0x00000010u
+#define CLOCKS_SLEEP_EN0_CLK_SYS_SRAM3_BITS    0x80000000u
+#define CLOCKS_SLEEP_EN0_CLK_SYS_SRAM2_BITS    0x40000000u
+#define CLOCKS_SLEEP_EN0_CLK_SYS_SRAM1_BITS    0x20000000u
+#define CLOCKS_SLEEP_EN0_CLK_SYS_SRAM0_BITS    0x10000000u
+
+#define CLOCKS_CLK_REF_CTRL_SRC_VALUE_ROSC_CLKSRC_PH   0x0
+#define CLOCKS_CLK_REF_CTRL_SRC_VALUE_XOSC_CLKSRC      0x2
+#define CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLK_REF          0x0
+#define CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX 0x1
+#define CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS 0x0
+#define CLOCKS_CLK_RTC_CTRL_AUXSRC_VALUE_XOSC_CLKSRC   0x3
+#define CLOCKS_CLK_RTC_CTRL_AUXSRC_VALUE_ROSC_CLKSRC_PH 0x2
+#define CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLK_SYS      0x0
+#define CLOCKS_CLK_ADC_CTRL_AUXSRC_VALUE_XOSC_CLKSRC   0x3
+#define CLOCKS_FC0_SRC_VALUE_ROSC_CLKSRC               0x03
+
+/* Custo estimado de clocks_init() (partida do XOSC + travamento dos PLLs) */
+#define SIM_CUSTO_CLOCKS_INIT_US 1000
+
+/* Partida do XOSC parado (sono a partir do ROSC): atraso de partida do xosc_init() */
+#define SIM_CUSTO_PARTIDA_XOSC_US 1000
+
+/* Partida do XOSC ao sair do modo dormant (núcleo parado até o oscilador estabilizar) */
+#define SIM_CUSTO_PARTIDA_DORMANT_US 1000
+
+/* Uma contagem do FC0 com o intervalo padrão do SDK (2^10 ciclos de clk_ref a 1 MHz) */
+#define SIM_CUSTO_CONTAGEM_FREQ_US 1000
+
+/* Modelo de corrente da placa em uA, para comparar estratégias de sono. São estimativas
+   típicas: substitua pelos valores medidos no nó (-D SIM_CORRENTE_...=...) */
+#ifndef SIM_CORRENTE_BASE_UA
+#define SIM_CORRENTE_BASE_UA        1000    /* Acordado: parcela fixa */
+#endif
+#ifndef SIM_CORRENTE_UA_POR_MHZ
+#define SIM_CORRENTE_UA_POR_MHZ     150     /* Acordado: parcela proporcional a clk_sys */
+#endif
+#ifndef SIM_CORRENTE_SONO_UA
+#define SIM_CORRENTE_SONO_UA        800     /* SLEEPDEEP com o XOSC e o clk_sys do PWM ligados */
+#endif
+#ifndef SIM_CORRENTE_XOSC_UA
+#define SIM_CORRENTE_XOSC_UA        150     /* Parcela do sono gasta pelo XOSC (parado no sono a partir do ROSC) */
+#endif
+#ifndef SIM_FRACAO_CORRENTE_WFE
+#define SIM_FRACAO_CORRENTE_WFE     0.5     /* Núcleo em __wfe(): fração da parcela de clk_sys que continua */
+#endif
+#ifndef SIM_CORRENTE_DORMANT_UA
+#define SIM_CORRENTE_DORMANT_UA     180     /* DORMANT: todos os osciladores parados */
+#endif
+
+void clocks_init(void);
+bool clock_configure(enum clock_index clk_index, uint32_t src, uint32_t auxsrc, uint32_t src_freq, uint32_t freq);
+void clock_stop(enum clock_index clk_index);
+uint32_t clock_get_hz(enum clock_index clk_index);
+uint32_t frequency_count_khz(uint src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
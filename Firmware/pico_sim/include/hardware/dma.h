@@ -0,0 +1,61 @@
+/*
+ * HAL simulada do Pico SDK - hardware/dma.h
+ * Canais disparados por DREQ da FIFO RX da PIO, com anel no endereço de escrita,
+ * e pelos DREQ de TX e RX dos controladores I2C.
+ */
+
+#ifndef _HARDWARE_DMA_H
+#define _HARDWARE_DMA_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NUM_DMA_CHANNELS 12
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2,
+};
+
+typedef struct {
+    enum dma_channel_transfer_size tamanho;
+    bool incrementa_leitura;
+    bool incrementa_escrita;
+    bool anel_na_escrita;
+    uint bits_anel;
+    uint dreq;
+} dma_channel_config;
+
+/* Registradores do canal (endereços com a largura do ponteiro do host) */
+typedef struct {
+    uintptr_t read_addr;
+    uintptr_t write_addr;
+    uint32_t transfer_count;
+    uint32_t ctrl_trig;
+} dma_channel_hw_t;
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(uint channel);
+dma_channel_config dma_channel_get_default_config(uint channel);
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config *c, bool incr);
+void channel_config_set_write_increment(dma_channel_config *c, bool incr);
+void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits);
+void channel_config_set_dreq(dma_channel_config *c, uint dreq);
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint32_t transfer_count, bool trigger);
+void dma_channel_abort(uint channel);
+bool dma_channel_is_busy(uint channel);
+dma_channel_hw_t *dma_channel_hw_addr(uint channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * HAL simulada do Pico SDK - hardware/i2c.h
+ * As transferências são encaminhadas aos dispositivos conectados com
+ * sim_i2c_conecta() e consomem tempo de barramento no relógio virtual.
+ * Pelo DMA, a transação inteira é executada quando o canal TX dispara e o
+ * STOP_DET aparece ao fim do tempo de barramento.
+ */
+
+#ifndef _HARDWARE_I2C_H
+#define _HARDWARE_I2C_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Números de DREQ dos controladores I2C */
+#define DREQ_I2C0_TX 32
+#define DREQ_I2C0_RX 33
+#define DREQ_I2C1_TX 34
+#define DREQ_I2C1_RX 35
+
+/* Bits de IC_DATA_CMD e das interrupções usados pelo firmware */
+#define I2C_IC_DATA_CMD_RESTART_BITS        0x00000400u
+#define I2C_IC_DATA_CMD_STOP_BITS           0x00000200u
+#define I2C_IC_DATA_CMD_CMD_BITS            0x00000100u
+#define I2C_IC_RAW_INTR_STAT_STOP_DET_BITS  0x00000200u
+#define I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS   0x00000040u
+#define I2C_IC_INTR_MASK_M_STOP_DET_BITS    0x00000200u
+#define I2C_IC_INTR_MASK_M_TX_ABRT_BITS     0x00000040u
+
+/* Subconjunto dos registradores. A leitura de clr_intr não tem efeito colateral no
+   host: as flags são zeradas quando o canal TX dispara a transação seguinte */
+typedef struct {
+    volatile uint32_t tar;
+    volatile uint32_t data_cmd;
+    volatile uint32_t intr_mask;
+    volatile uint32_t raw_intr_stat;
+    volatile uint32_t clr_intr;
+    volatile uint32_t enable;
+} i2c_hw_t;
+
+typedef struct i2c_inst {
+    i2c_hw_t hw;
+    uint indice;
+    uint baudrate;
+    uint32_t clk_peri_hz;   /* clk_peri usado no cálculo dos divisores de SCL */
+    uint32_t transacoes;    /* Transações (START ... STOP); START repetido não conta */
+    bool sem_stop;          /* Última transferência terminou sem STOP */
+    bool travado;
+    uint8_t pulsos_para_liberar;   /* Pulsos de SCL que o escravo travado ainda espera */
+    uint32_t pulsos_scl;           /* Pulsos de SCL gerados por GPIO (recuperação) */
+    uint64_t dma_fim_us;           /* Fim da transação em DMA em andamento (UINT64_MAX = nenhuma) */
+    uint32_t dma_intr;             /* Flags que a transação em DMA ativa no STOP */
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+void i2c_deinit(i2c_inst_t *i2c);
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate);
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop, uint timeout_us);
+int i2c_read_timeout_us(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop, uint timeout_us);
+
+static inline uint i2c_hw_index(i2c_inst_t *i2c) { return i2c->indice; }
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) { return &i2c->hw; }
+static inline uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) {
+    return (i2c->indice ? DREQ_I2C1_TX : DREQ_I2C0_TX) + (is_tx ? 0u : 1u);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,32 @@
+/*
+ * HAL simulada do Pico SDK - hardware/irq.h
+ * Apenas o registro de handlers exclusivos e a habilitação no NVIC são modelados.
+ */
+
+#ifndef _HARDWARE_IRQ_H
+#define _HARDWARE_IRQ_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Números das interrupções do RP2040 usadas pelo firmware */
+#define IO_IRQ_BANK0    13
+#define PWM_IRQ_WRAP    4
+#define I2C0_IRQ        23
+#define I2C1_IRQ        24
+#define NUM_IRQS        32
+
+typedef void (*irq_handler_t)(void);
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+void irq_set_enabled(uint num, bool enabled);
+bool irq_is_enabled(uint num);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
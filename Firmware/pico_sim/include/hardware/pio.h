@@ -0,0 +1,116 @@
+/*
+ * HAL simulada do Pico SDK - hardware/pio.h
+ * As instruções não são executadas: uma SM habilitada com jmp_pin definido
+ * se comporta como o programa carimbo_tombo (contador X decrementado a cada
+ * 2 ciclos e ~X enviado à FIFO RX em cada borda de descida do pino, seguido
+ * de um bloqueio de OSR + 1 ticks em que as bordas são ignoradas). Se o
+ * programa carregado começa com "jmp pin", ela se comporta como o conta_tombo:
+ * X só é decrementado em cada borda aceita, com o mesmo bloqueio.
+ */
+
+#ifndef _HARDWARE_PIO_H
+#define _HARDWARE_PIO_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NUM_PIOS                4
+#define NUM_PIO_STATE_MACHINES  4
+#define PIO_INSTRUCTION_COUNT   32
+
+typedef struct pio_hw {
+    uint indice;
+    uint32_t rxf[NUM_PIO_STATE_MACHINES];   /* Apenas o endereço é usado (leitura pelo DMA) */
+} pio_hw_t;
+
+typedef pio_hw_t *PIO;
+
+extern pio_hw_t pio0_sim_hw;
+extern pio_hw_t pio1_sim_hw;
+
+#define pio0 (&pio0_sim_hw)
+#define pio1 (&pio1_sim_hw)
+
+struct pio_program {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+};
+
+enum pio_fifo_join {
+    PIO_FIFO_JOIN_NONE = 0,
+    PIO_FIFO_JOIN_TX = 1,
+    PIO_FIFO_JOIN_RX = 2,
+};
+
+enum pio_src_dest {
+    pio_pins = 0,
+    pio_x = 1,
+    pio_y = 2,
+    pio_null = 3,
+    pio_status = 5,
+    pio_isr = 6,
+    pio_osr = 7,
+};
+
+typedef struct {
+    float clkdiv;
+    uint jmp_pin;
+    uint wrap_target;
+    uint wrap;
+    enum pio_fifo_join join;
+    bool autopush;
+} pio_sm_config;
+
+pio_sm_config pio_get_default_sm_config(void);
+void sm_config_set_wrap(pio_sm_config *c, uint wrap_target, uint wrap);
+void sm_config_set_jmp_pin(pio_sm_config *c, uint pin);
+void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join);
+void sm_config_set_clkdiv(pio_sm_config *c, float div);
+void sm_config_set_in_shift(pio_sm_config *c, bool shift_right, bool autopush, uint push_threshold);
+
+bool pio_can_add_program(PIO pio, const struct pio_program *program);
+uint pio_add_program(PIO pio, const struct pio_program *program);
+int pio_claim_unused_sm(PIO pio, bool required);
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config);
+void pio_sm_set_config(PIO pio, uint sm, const pio_sm_config *config);
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+void pio_sm_set_clkdiv(PIO pio, uint sm, float div);
+void pio_sm_exec(PIO pio, uint sm, uint instr);
+
+uint pio_sm_get_rx_fifo_level(PIO pio, uint sm);
+uint32_t pio_sm_get(PIO pio, uint sm);
+uint32_t pio_sm_get_blocking(PIO pio, uint sm);
+void pio_sm_put(PIO pio, uint sm, uint32_t data);
+
+static inline uint pio_get_dreq(PIO pio, uint sm, bool is_tx) {
+    return pio->indice * 8u + (is_tx ? 0u : 4u) + sm;
+}
+
+/* Codificação real das instruções MOV (101 ddddd dst op src) */
+static inline uint pio_encode_mov(enum pio_src_dest dest, enum pio_src_dest src) {
+    return 0xA000u | ((uint)dest << 5) | (uint)src;
+}
+
+static inline uint pio_encode_mov_not(enum pio_src_dest dest, enum pio_src_dest src) {
+    return 0xA000u | ((uint)dest << 5) | (1u << 3) | (uint)src;
+}
+
+/* Codificação real da instrução IN (010 ddddd src bit_count, 32 codificado como 0) */
+static inline uint pio_encode_in(enum pio_src_dest src, uint count) {
+    return 0x4000u | ((uint)src << 5) | (count & 0x1fu);
+}
+
+/* Codificação real da instrução PULL (100 ddddd 1 if_empty block 00000) */
+static inline uint pio_encode_pull(bool if_empty, bool block) {
+    return 0x8080u | (if_empty ? 0x40u : 0u) | (block ? 0x20u : 0u);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
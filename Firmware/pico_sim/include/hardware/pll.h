@@ -0,0 +1,37 @@
+/*
+ * HAL simulada do Pico SDK - hardware/pll.h
+ * Apenas o tempo de travamento e a frequência de saída de cada PLL.
+ */
+
+#ifndef _HARDWARE_PLL_H
+#define _HARDWARE_PLL_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct pll_inst {
+    uint32_t saida_hz;      /* 0 com o PLL desligado */
+} pll_inst_t;
+
+typedef pll_inst_t *PLL;
+
+extern pll_inst_t pll_sys_inst;
+extern pll_inst_t pll_usb_inst;
+
+#define pll_sys (&pll_sys_inst)
+#define pll_usb (&pll_usb_inst)
+
+/* Travamento do PLL depois de ligar o VCO */
+#define SIM_CUSTO_TRAVA_PLL_US 100
+
+void pll_init(PLL pll, uint ref_div, uint vco_freq, uint post_div1, uint post_div2);
+void pll_deinit(PLL pll);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
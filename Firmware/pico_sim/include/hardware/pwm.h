@@ -0,0 +1,57 @@
+/*
+ * HAL simulada do Pico SDK - hardware/pwm.h
+ * Apenas o modo de contagem de bordas (PWM_DIV_B_*) é modelado.
+ */
+
+#ifndef _HARDWARE_PWM_H
+#define _HARDWARE_PWM_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NUM_PWM_SLICES 8
+
+enum pwm_clkdiv_mode {
+    PWM_DIV_FREE_RUNNING = 0,
+    PWM_DIV_B_HIGH = 1,
+    PWM_DIV_B_RISING = 2,
+    PWM_DIV_B_FALLING = 3,
+};
+
+enum pwm_chan {
+    PWM_CHAN_A = 0,
+    PWM_CHAN_B = 1,
+};
+
+typedef struct {
+    uint32_t csr;
+    uint32_t div;
+    uint32_t top;
+} pwm_config;
+
+static inline uint pwm_gpio_to_slice_num(uint gpio) { return (gpio >> 1u) & 7u; }
+static inline uint pwm_gpio_to_channel(uint gpio) { return gpio & 1u; }
+
+pwm_config pwm_get_default_config(void);
+void pwm_config_set_clkdiv_mode(pwm_config *c, enum pwm_clkdiv_mode mode);
+void pwm_config_set_clkdiv(pwm_config *c, float div);
+void pwm_config_set_wrap(pwm_config *c, uint16_t wrap);
+void pwm_init(uint slice_num, pwm_config *c, bool start);
+void pwm_set_enabled(uint slice_num, bool enabled);
+void pwm_set_wrap(uint slice_num, uint16_t wrap);
+uint16_t pwm_get_counter(uint slice_num);
+void pwm_set_counter(uint slice_num, uint16_t c);
+
+/* Interrupção de wrap (contador passando de TOP para 0), por slice */
+void pwm_set_irq_enabled(uint slice_num, bool enabled);
+void pwm_clear_irq(uint slice_num);
+uint32_t pwm_get_irq_status_mask(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
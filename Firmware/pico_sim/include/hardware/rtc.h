@@ -0,0 +1,22 @@
+/*
+ * HAL simulada do Pico SDK - hardware/rtc.h
+ */
+
+#ifndef _HARDWARE_RTC_H
+#define _HARDWARE_RTC_H
+
+#include "pico.h"
+
+typedef struct {
+    int16_t year;
+    int8_t month;
+    int8_t day;
+    int8_t dotw;
+    int8_t hour;
+    int8_t min;
+    int8_t sec;
+} datetime_t;
+
+typedef void (*rtc_callback_t)(void);
+
+#endif
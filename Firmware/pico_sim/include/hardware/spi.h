@@ -0,0 +1,33 @@
+/*
+ * HAL simulada do Pico SDK - hardware/spi.h
+ * Só o baud rate: nenhum projeto simulado tem dispositivo SPI.
+ */
+
+#ifndef _HARDWARE_SPI_H
+#define _HARDWARE_SPI_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct spi_inst {
+    uint indice;
+    uint baudrate;
+} spi_inst_t;
+
+extern spi_inst_t spi0_inst;
+extern spi_inst_t spi1_inst;
+
+#define spi0 (&spi0_inst)
+#define spi1 (&spi1_inst)
+
+uint spi_init(spi_inst_t *spi, uint baudrate);
+uint spi_set_baudrate(spi_inst_t *spi, uint baudrate);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
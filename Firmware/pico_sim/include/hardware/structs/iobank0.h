@@ -0,0 +1,34 @@
+/*
+ * HAL simulada do Pico SDK - hardware/structs/iobank0.h
+ * Apenas o INTR bruto e o bloco de interrupções de despertar do dormant.
+ * Cada GPIO ocupa 4 bits (LEVEL_LOW, LEVEL_HIGH, EDGE_LOW, EDGE_HIGH).
+ */
+
+#ifndef _HARDWARE_STRUCTS_IOBANK0_H
+#define _HARDWARE_STRUCTS_IOBANK0_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t inte[4];
+    uint32_t intf[4];
+    uint32_t ints[4];
+} io_irq_ctrl_hw_t;
+
+typedef struct {
+    uint32_t intr[4];
+    io_irq_ctrl_hw_t dormant_wake_irq_ctrl;
+} iobank0_hw_t;
+
+extern iobank0_hw_t iobank0_sim_hw;
+#define io_bank0_hw (&iobank0_sim_hw)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
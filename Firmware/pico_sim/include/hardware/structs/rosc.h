@@ -0,0 +1,44 @@
+/*
+ * HAL simulada do Pico SDK - hardware/structs/rosc.h
+ * Registradores do ROSC escritos por lib/pico_sleep/rosc.c (com as senhas de escrita).
+ */
+
+#ifndef _HARDWARE_STRUCTS_ROSC_H
+#define _HARDWARE_STRUCTS_ROSC_H
+
+#include "pico.h"
+#include "hardware/address_mapped.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ROSC_CTRL_ENABLE_BITS           0x00fff000u
+#define ROSC_CTRL_ENABLE_LSB            12u
+#define ROSC_CTRL_ENABLE_VALUE_DISABLE  0xd1eu
+#define ROSC_CTRL_ENABLE_VALUE_ENABLE   0xfabu
+#define ROSC_FREQA_PASSWD_LSB           16u
+#define ROSC_FREQA_PASSWD_VALUE_PASS    0x9696u
+#define ROSC_DORMANT_VALUE_DORMANT      0x636f6d61u
+#define ROSC_DIV_VALUE_PASS             0xaa0u
+#define ROSC_STATUS_STABLE_BITS         0x80000000u
+#define ROSC_STATUS_BADWRITE_BITS       0x01000000u
+
+typedef struct {
+    io_rw_32 ctrl;
+    io_rw_32 freqa;
+    io_rw_32 freqb;
+    io_rw_32 dormant;
+    io_rw_32 div;
+    io_rw_32 phase;
+    io_rw_32 status;
+} rosc_hw_t;
+
+extern rosc_hw_t rosc_sim_hw;
+#define rosc_hw (&rosc_sim_hw)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
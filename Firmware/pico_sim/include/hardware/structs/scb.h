@@ -0,0 +1,28 @@
+/*
+ * HAL simulada do Pico SDK - hardware/structs/scb.h
+ */
+
+#ifndef _HARDWARE_STRUCTS_SCB_H
+#define _HARDWARE_STRUCTS_SCB_H
+
+#include "pico.h"
+#include "hardware/sync.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t scr;
+} armv6m_scb_hw_t;
+
+extern armv6m_scb_hw_t scb_sim_hw;
+#define scb_hw (&scb_sim_hw)
+
+#define M0PLUS_SCR_SLEEPDEEP_BITS 0x00000004u
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
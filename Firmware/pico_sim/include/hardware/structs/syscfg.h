@@ -0,0 +1,35 @@
+/*
+ * HAL simulada do Pico SDK - hardware/structs/syscfg.h
+ * Apenas o controle de desligamento das memórias (MEMPOWERDOWN).
+ */
+
+#ifndef _HARDWARE_STRUCTS_SYSCFG_H
+#define _HARDWARE_STRUCTS_SYSCFG_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SYSCFG_MEMPOWERDOWN_SRAM0_BITS  0x00000001u
+#define SYSCFG_MEMPOWERDOWN_SRAM1_BITS  0x00000002u
+#define SYSCFG_MEMPOWERDOWN_SRAM2_BITS  0x00000004u
+#define SYSCFG_MEMPOWERDOWN_SRAM3_BITS  0x00000008u
+#define SYSCFG_MEMPOWERDOWN_SRAM4_BITS  0x00000010u
+#define SYSCFG_MEMPOWERDOWN_SRAM5_BITS  0x00000020u
+#define SYSCFG_MEMPOWERDOWN_USB_BITS    0x00000040u
+#define SYSCFG_MEMPOWERDOWN_ROM_BITS    0x00000080u
+
+typedef struct {
+    uint32_t mempowerdown;
+} syscfg_hw_t;
+
+extern syscfg_hw_t syscfg_sim_hw;
+#define syscfg_hw (&syscfg_sim_hw)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,33 @@
+/*
+ * HAL simulada do Pico SDK - hardware/structs/vreg_and_chip_reset.h
+ * Apenas o registrador VREG (tensão selecionada pelo VSEL).
+ */
+
+#ifndef _HARDWARE_STRUCTS_VREG_AND_CHIP_RESET_H
+#define _HARDWARE_STRUCTS_VREG_AND_CHIP_RESET_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VREG_AND_CHIP_RESET_VREG_EN_BITS    0x00000001u
+#define VREG_AND_CHIP_RESET_VREG_VSEL_BITS  0x000000f0u
+#define VREG_AND_CHIP_RESET_VREG_VSEL_LSB   4u
+
+/* Valor de reset: regulador ligado em 1,10 V */
+#define VREG_AND_CHIP_RESET_VREG_RESET      0x000000b1u
+
+typedef struct {
+    uint32_t vreg;
+} vreg_and_chip_reset_hw_t;
+
+extern vreg_and_chip_reset_hw_t vreg_and_chip_reset_sim_hw;
+#define vreg_and_chip_reset_hw (&vreg_and_chip_reset_sim_hw)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
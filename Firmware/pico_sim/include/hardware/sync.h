@@ -0,0 +1,27 @@
+/*
+ * HAL simulada do Pico SDK - hardware/sync.h
+ * __wfi() avança o relógio virtual até a próxima fonte de despertar registrada.
+ */
+
+#ifndef _HARDWARE_SYNC_H
+#define _HARDWARE_SYNC_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void __wfi(void);
+void __wfe(void);
+void __sev(void);
+void __dmb(void);
+
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
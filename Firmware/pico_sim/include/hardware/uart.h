@@ -0,0 +1,44 @@
+/*
+ * HAL simulada do Pico SDK - hardware/uart.h
+ * O tempo de transmissão (10 bits por byte no baud rate configurado) é
+ * contabilizado no relógio virtual.
+ */
+
+#ifndef _HARDWARE_UART_H
+#define _HARDWARE_UART_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct uart_inst {
+    uint indice;
+    uint baudrate;
+    uint32_t clk_peri_hz;   /* clk_peri usado no cálculo do divisor de baud */
+} uart_inst_t;
+
+extern uart_inst_t uart0_inst;
+extern uart_inst_t uart1_inst;
+
+#define uart0 (&uart0_inst)
+#define uart1 (&uart1_inst)
+
+uint uart_init(uart_inst_t *uart, uint baudrate);
+void uart_deinit(uart_inst_t *uart);
+uint uart_set_baudrate(uart_inst_t *uart, uint baudrate);
+void uart_putc(uart_inst_t *uart, char c);
+void uart_puts(uart_inst_t *uart, const char *s);
+void uart_write_blocking(uart_inst_t *uart, const uint8_t *src, size_t len);
+void uart_tx_wait_blocking(uart_inst_t *uart);
+
+static inline void uart_default_tx_wait_blocking(void) {
+    uart_tx_wait_blocking(uart0);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * HAL simulada do Pico SDK - hardware/vreg.h
+ * Tensão de saída do regulador do núcleo (DVDD). O modelo de corrente escala a
+ * parcela dinâmica com o quadrado da tensão, e o clk_sys acima do suportado pela
+ * tensão atual encerra a simulação.
+ */
+
+#ifndef _HARDWARE_VREG_H
+#define _HARDWARE_VREG_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Mesmos valores de VSEL do SDK */
+enum vreg_voltage {
+    VREG_VOLTAGE_0_85 = 0b0110,
+    VREG_VOLTAGE_0_90 = 0b0111,
+    VREG_VOLTAGE_0_95 = 0b1000,
+    VREG_VOLTAGE_1_00 = 0b1001,
+    VREG_VOLTAGE_1_05 = 0b1010,
+    VREG_VOLTAGE_1_10 = 0b1011,
+    VREG_VOLTAGE_1_15 = 0b1100,
+    VREG_VOLTAGE_1_20 = 0b1101,
+    VREG_VOLTAGE_1_25 = 0b1110,
+    VREG_VOLTAGE_1_30 = 0b1111,
+    VREG_VOLTAGE_MIN = VREG_VOLTAGE_0_85,
+    VREG_VOLTAGE_DEFAULT = VREG_VOLTAGE_1_10,
+    VREG_VOLTAGE_MAX = VREG_VOLTAGE_1_30,
+};
+
+/* Maior clk_sys aceito pelo modelo em cada tensão (estimativa com folga) */
+#define SIM_VREG_MAX_MHZ(vsel) ((vsel) < VREG_VOLTAGE_0_95 ? 24 : \
+                                (vsel) < VREG_VOLTAGE_1_00 ? 48 : \
+                                (vsel) < VREG_VOLTAGE_1_05 ? 100 : 133)
+
+void vreg_set_voltage(enum vreg_voltage voltage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,39 @@
+/*
+ * HAL simulada do Pico SDK - hardware/watchdog.h
+ * O prazo conta no relógio virtual. Estourado, o núcleo é reiniciado: o simulador
+ * volta ao setup() preservando os registradores scratch e o motivo do reset.
+ */
+
+#ifndef _HARDWARE_WATCHDOG_H
+#define _HARDWARE_WATCHDOG_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WATCHDOG_CTRL_ENABLE_BITS   0x40000000u
+#define WATCHDOG_REASON_TIMER_BITS  0x00000001u
+
+typedef struct {
+    uint32_t ctrl;
+    uint32_t load;
+    uint32_t reason;
+    uint32_t scratch[8];
+} watchdog_hw_t;
+
+extern watchdog_hw_t watchdog_sim_hw;
+#define watchdog_hw (&watchdog_sim_hw)
+
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug);
+void watchdog_disable(void);
+void watchdog_update(void);
+bool watchdog_caused_reboot(void);
+bool watchdog_enable_caused_reboot(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
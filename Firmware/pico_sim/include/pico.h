@@ -0,0 +1,31 @@
+/*
+ * HAL simulada do Pico SDK - tipos e definições básicas.
+ * Apenas o subconjunto usado pelo firmware é reproduzido.
+ */
+
+#ifndef _PICO_H
+#define _PICO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <assert.h>
+
+typedef unsigned int uint;
+
+#define KHZ 1000
+#define MHZ 1000000
+#define XOSC_MHZ 12
+
+#define PICO_OK                 0
+#define PICO_ERROR_NONE         0
+#define PICO_ERROR_TIMEOUT     -1
+#define PICO_ERROR_GENERIC     -2
+#define PICO_ERROR_NO_DATA     -3
+
+static inline void tight_loop_contents(void) {}
+
+#define __not_in_flash_func(f) f
+#define __time_critical_func(f) f
+
+#endif
@@ -0,0 +1,10 @@
+/*
+ * HAL simulada do Pico SDK - pico/runtime_init.h
+ */
+
+#ifndef _PICO_RUNTIME_INIT_H
+#define _PICO_RUNTIME_INIT_H
+
+#include "pico.h"
+
+#endif
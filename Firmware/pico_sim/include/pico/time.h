@@ -0,0 +1,35 @@
+/*
+ * HAL simulada do Pico SDK - pico/time.h
+ * As esperas apenas avançam o relógio virtual.
+ */
+
+#ifndef _PICO_TIME_H
+#define _PICO_TIME_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+void busy_wait_us(uint64_t us);
+void busy_wait_us_32(uint32_t us);
+void busy_wait_ms(uint32_t ms);
+
+typedef uint64_t absolute_time_t;
+
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+static inline absolute_time_t make_timeout_time_us(uint64_t us) { return time_us_64() + us; }
+
+/* __wfe() com prazo: avança até a próxima interrupção ou até o prazo (retorna true se ele passou) */
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,199 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  pico_sim.h
+ *
+ *    Description:  API de controle da HAL simulada (relógio virtual, barramento
+ *                  I2C programável, contador PWM, saída UART e fontes de despertar).
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 14:20:05
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#ifndef _PICO_SIM_H_
+#define _PICO_SIM_H_
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct i2c_inst i2c_inst_t;
+
+/****************************************************************************
+**                            RELÓGIO VIRTUAL
+*****************************************************************************/
+
+/* Tempo simulado desde o boot (nenhuma espera real é feita) */
+uint64_t sim_tempo_us(void);
+
+/* Avança o relógio virtual, gerando os pulsos de chuva do intervalo */
+void sim_avanca_us(uint64_t dt_us);
+
+/* Tempo acumulado em __wfi() / dormant e tempo acordado */
+uint64_t sim_tempo_dormindo_us(void);
+uint64_t sim_tempo_acordado_us(void);
+
+/* Parcela do tempo dormindo passada em modo dormant */
+uint64_t sim_tempo_dormant_us(void);
+
+/* Carga consumida desde o boot segundo o modelo de corrente (uA x s) */
+double sim_carga_uas(void);
+
+/* Trocas de tensão do regulador do núcleo (vreg_set_voltage com outro VSEL) */
+uint32_t sim_vreg_trocas(void);
+
+/****************************************************************************
+**                            BARRAMENTO I2C
+*****************************************************************************/
+
+/* Dispositivo escravo programável: retorna bytes transferidos ou < 0 para NACK */
+typedef struct {
+    int (*escrita)(void *ctx, const uint8_t *src, size_t n, bool nostop);
+    int (*leitura)(void *ctx, uint8_t *dst, size_t n, bool nostop);
+    void *ctx;
+} SimDispositivoI2C;
+
+void sim_i2c_conecta(i2c_inst_t *i2c, uint8_t endereco, const SimDispositivoI2C *disp);
+
+/* Transações (START até STOP) executadas no barramento */
+uint32_t sim_i2c_transacoes(i2c_inst_t *i2c);
+void sim_i2c_zera_transacoes(i2c_inst_t *i2c);
+
+/* Mantém SDA em nível baixo (escravo travado no meio de um byte): ele só solta a
+   linha após SIM_I2C_PULSOS_LIBERACAO pulsos de SCL ou com travado = false */
+#define SIM_I2C_PULSOS_LIBERACAO 5
+void sim_i2c_trava_barramento(i2c_inst_t *i2c, bool travado);
+
+/* Pulsos de SCL gerados por GPIO desde o boot (recuperação do barramento) */
+uint32_t sim_i2c_pulsos_scl(i2c_inst_t *i2c);
+
+/****************************************************************************
+**                            UART, GPIO E PWM
+*****************************************************************************/
+
+/* Repete no stdout o que o firmware escreve na UART */
+void sim_uart_eco(bool habilitado);
+uint32_t sim_uart_bytes(void);
+
+/* Gera um evento de GPIO (chama o callback registrado, se habilitado) */
+void sim_gpio_evento(uint gpio, uint32_t eventos);
+
+/* Define o nível lido por gpio_get() */
+void sim_gpio_nivel(uint gpio, bool nivel);
+
+/* Injeta bordas de descida no canal B do slice PWM (tombos do pluviômetro) */
+void sim_pwm_pulsos(uint slice, uint32_t n);
+
+/* Gera tombos continuamente no pino indicado à taxa informada */
+void sim_chuva_taxa(uint gpio, uint32_t tombos_por_hora);
+
+/* Tombos gerados desde a última chamada a sim_chuva_taxa() */
+uint64_t sim_chuva_tombos(void);
+
+/* Repique do ímã: cada tombo passa a gerar mais 'bordas_extras' bordas de descida,
+   espaçadas de intervalo_us (0 bordas desliga) */
+void sim_chuva_repique(uint32_t bordas_extras, uint32_t intervalo_us);
+
+/* Bordas de repique entregues desde a última chamada a sim_chuva_repique() */
+uint64_t sim_chuva_repiques(void);
+
+/* Ruído na linha de despertar: pulsos curtos em nível baixo (borda de descida sem alarme)
+   à taxa informada, e os pulsos entregues até agora */
+void sim_ruido_gpio(uint gpio, uint32_t pulsos_por_hora);
+uint64_t sim_ruido_pulsos(void);
+
+/* Tensão em uma entrada do ADC (canais 0 a 3 nas GPIOs 26 a 29, referência de 3,3 V) */
+void sim_adc_tensao_mv(uint canal, uint32_t mv);
+
+/* Conversões feitas pelo firmware e tempo total com o ADC ligado */
+uint32_t sim_adc_conversoes(void);
+uint64_t sim_adc_ligado_us(void);
+
+/* Contagens de frequência do ROSC (FC0) feitas pelo firmware */
+uint32_t sim_rosc_contagens(void);
+
+/* Código de drive strength e frequência do ROSC nos registradores, pelo modelo */
+uint32_t sim_rosc_codigo(void);
+uint32_t sim_rosc_khz(void);
+
+/* O núcleo fica preso em um laço a partir do próximo despertar (oscilador que não
+   parte, espera sem prazo): só o watchdog o reinicia */
+void sim_trava_nucleo(void);
+
+/****************************************************************************
+**                            FONTES DE DESPERTAR
+*****************************************************************************/
+
+/* proximo(): instante absoluto (us) do próximo evento, ou UINT64_MAX se nenhum */
+typedef struct {
+    uint64_t (*proximo)(void *ctx);
+    void (*dispara)(void *ctx);
+    void *ctx;
+} SimFonteDespertar;
+
+void sim_registra_despertar(const SimFonteDespertar *fonte);
+
+/****************************************************************************
+**                            USO INTERNO DO SIMULADOR
+*****************************************************************************/
+
+/* Núcleo dentro de __wfi() / dormant */
+bool sim_dormindo(void);
+
+/* Núcleo em dormant: todos os osciladores parados (sem clock para PWM, PIO e DMA) */
+bool sim_dormant(void);
+
+/* Atualiza os contadores da PIO antes de mudar clk_sys ou o estado de sono */
+void sim_pio_sincroniza(void);
+
+/* Borda de descida em um pino de entrada monitorado pela PIO */
+void sim_pio_borda_descida(uint gpio);
+
+/* Sinaliza uma interrupção: executa o handler (ou o adia com PRIMASK) e desperta __wfi()/__wfe() */
+void sim_irq_sinaliza(uint num);
+
+/* Pinos I2C vistos como GPIO: registro pelo gpio_set_function(), nível das linhas e
+   borda de subida de SCL (linha solta com o pino passando a entrada) */
+void sim_i2c_registra_pino(uint gpio);
+bool sim_i2c_nivel_pino(uint gpio, bool *nivel);
+void sim_i2c_scl_solto(uint gpio);
+
+/* DMA: entrega um valor ao canal com o DREQ indicado e dispara uma transação I2C
+   a partir do canal TX (palavras de IC_DATA_CMD) */
+bool sim_dma_entrega(uint dreq, uint32_t valor);
+void sim_i2c_dma_dispara(uint dreq, uint canal);
+
+/* Recomeça pelo setup() após o reset do watchdog (implementada pelo executor) */
+__attribute__((noreturn)) void sim_reinicia_pelo_watchdog(void);
+
+/* Encerra a simulação imprimindo o resumo (código 1 indica falha, ex.: nó sem despertar) */
+__attribute__((noreturn)) void sim_encerra(int codigo, const char *motivo);
+
+/****************************************************************************
+**                            MODELOS DE DISPOSITIVOS
+*****************************************************************************/
+
+/* DS3231 no endereço 0x68, com INT/SQW ligado ao GPIO indicado */
+void sim_ds3231_inicializa(i2c_inst_t *i2c, uint int_gpio);
+
+/* SHT30 no endereço indicado, com temperatura e umidade configuráveis */
+void sim_sht30_inicializa(i2c_inst_t *i2c, uint8_t endereco);
+void sim_sht30_define(float temperatura, float umidade);
+
+/* Faz as próximas n leituras responderem com NACK ou com CRC corrompido */
+void sim_sht30_injeta_falhas(uint32_t nacks, uint32_t crc_corrompidos);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
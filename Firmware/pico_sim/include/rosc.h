@@ -0,0 +1,49 @@
+/*
+ * HAL simulada - substitui lib/pico_sleep/rosc.h no ambiente native.
+ */
+
+#ifndef _HARDWARE_ROSC_H_
+#define _HARDWARE_ROSC_H_
+
+#include "pico.h"
+#include "hardware/structs/rosc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Implementadas pelo lib/pico_sleep/rosc.c do projeto, compilado também no build nativo */
+void rosc_set_freq(uint32_t code);
+void rosc_set_range(uint range);
+void rosc_disable(void);
+void rosc_set_dormant(void);
+uint32_t next_rosc_code(uint32_t code);
+uint rosc_find_freq(uint32_t low_mhz, uint32_t high_mhz);
+void rosc_set_div(uint32_t div);
+
+#define ROSC_DRIVE_LEVELS 25u
+
+uint32_t rosc_code_for_level(uint level);
+uint32_t rosc_calibrate(uint32_t target_khz);
+uint32_t rosc_restore_calibration(uint32_t target_khz, uint32_t tolerance_khz);
+uint32_t rosc_calibrated_code(void);
+uint32_t rosc_calibrated_khz(void);
+
+/* Modelo do ROSC: cresce com o número de bits de drive strength ligados. A base
+   foge propositalmente dos 6,5 MHz nominais (variação de processo) */
+#ifndef SIM_ROSC_BASE_KHZ
+#define SIM_ROSC_BASE_KHZ       5800
+#endif
+#ifndef SIM_ROSC_PCT_POR_BIT
+#define SIM_ROSC_PCT_POR_BIT    12
+#endif
+
+static inline void rosc_write(io_rw_32 *addr, uint32_t value) {
+    *addr = value;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ * HAL simulada - substitui lib/pico_sleep/sleep.h no ambiente native.
+ */
+
+#ifndef _PICO_SLEEP_H_
+#define _PICO_SLEEP_H_
+
+#include "pico.h"
+#include "hardware/rtc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    DORMANT_SOURCE_NONE,
+    DORMANT_SOURCE_XOSC,
+    DORMANT_SOURCE_ROSC
+} dormant_source_t;
+
+void sleep_run_from_dormant_source(dormant_source_t dormant_source);
+
+static inline void sleep_run_from_xosc(void) {
+    sleep_run_from_dormant_source(DORMANT_SOURCE_XOSC);
+}
+
+static inline void sleep_run_from_rosc(void) {
+    sleep_run_from_dormant_source(DORMANT_SOURCE_ROSC);
+}
+
+void sleep_goto_dormant_until_pin(uint gpio_pin, bool edge, bool high);
+
+static inline void sleep_goto_dormant_until_edge_high(uint gpio_pin) {
+    sleep_goto_dormant_until_pin(gpio_pin, true, true);
+}
+static inline void sleep_goto_dormant_until_edge_low(uint gpio_pin) {
+    sleep_goto_dormant_until_pin(gpio_pin, true, false);
+}
+
+/* Por nível o dormant nem começa com o pino já em nível baixo */
+static inline void sleep_goto_dormant_until_level_low(uint gpio_pin) {
+    sleep_goto_dormant_until_pin(gpio_pin, false, false);
+}
+
+/* Memórias em SYSCFG_MEMPOWERDOWN desligadas durante o __wfi(), com as interrupções
+   mascaradas: os handlers só executam depois que elas são religadas */
+void sleep_wfi_with_memories_powered_down(uint32_t mem_mask);
+
+/* No host não há seção scratch X: a SRAM4 é sempre considerada livre */
+bool sleep_scratch_x_unused(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,976 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  sim_core.c
+ *
+ *    Description:  Relógio virtual, GPIO, UART, PWM, clocks e sleep simulados.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 14:31:12
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "pico_sim.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+#include "hardware/uart.h"
+#include "hardware/pwm.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "hardware/xosc.h"
+#include "hardware/pll.h"
+#include "hardware/spi.h"
+#include "hardware/vreg.h"
+#include "hardware/watchdog.h"
+#include "hardware/adc.h"
+#include "pico/stdlib.h"
+#include "hardware/structs/scb.h"
+#include "hardware/structs/iobank0.h"
+#include "hardware/structs/syscfg.h"
+#include "hardware/structs/vreg_and_chip_reset.h"
+#include "rosc.h"
+#include "sleep.h"
+
+/* Maior tempo dormindo sem despertar antes de considerar o nó travado */
+#define SIM_SONO_MAXIMO_US  (7ULL * 24 * 3600 * 1000000)
+
+#define SIM_MAX_FONTES      8
+
+/* Registradores simulados */
+clocks_hw_t clocks_sim_hw;
+armv6m_scb_hw_t scb_sim_hw;
+iobank0_hw_t iobank0_sim_hw;
+syscfg_hw_t syscfg_sim_hw;
+vreg_and_chip_reset_hw_t vreg_and_chip_reset_sim_hw = { VREG_AND_CHIP_RESET_VREG_RESET };
+rosc_hw_t rosc_sim_hw = { .status = ROSC_STATUS_STABLE_BITS };   /* Ligado e estável, como no boot */
+watchdog_hw_t watchdog_sim_hw;
+adc_hw_t adc_sim_hw;
+uart_inst_t uart0_inst = { 0, 0, 0 };
+uart_inst_t uart1_inst = { 1, 0, 0 };
+spi_inst_t spi0_inst = { 0, 0 };
+spi_inst_t spi1_inst = { 1, 0 };
+pll_inst_t pll_sys_inst = { 125 * MHZ };
+pll_inst_t pll_usb_inst = { 48 * MHZ };
+
+static uint64_t tempo_us = 0;
+static uint64_t dormindo_us = 0;
+static uint64_t dormant_us = 0;
+static bool dormindo = false;
+static bool dormant = false;
+static bool esperando_evento = false;  /* Núcleo em __wfe() com clk_sys ligado (DMA do I2C) */
+static bool xosc_ligado = true;
+static uint32_t rosc_contagens = 0;
+static uint32_t vreg_trocas = 0;
+static double carga_uaus = 0.0;        /* uA x us acumulados pelo modelo de corrente */
+
+/* Watchdog: instante em que o contador chega a zero (UINT64_MAX desligado) */
+static uint64_t watchdog_prazo_us = UINT64_MAX;
+static bool travar_no_despertar = false;   /* Injeção: laço sem saída no próximo despertar */
+static bool nucleo_travado = false;
+
+/* Clocks deixados pelo runtime do SDK (clocks_init) antes do setup() */
+static uint32_t clk_hz[CLK_COUNT] = {
+    [clk_ref] = XOSC_MHZ * MHZ, [clk_sys] = 125 * MHZ, [clk_peri] = 125 * MHZ,
+    [clk_usb] = 48 * MHZ, [clk_adc] = 48 * MHZ, [clk_rtc] = 46875,
+};
+
+static bool uart_eco = false;
+static uint32_t uart_bytes = 0;
+
+/* Estado de cada GPIO */
+typedef struct {
+    enum gpio_function funcao;
+    bool saida;
+    bool nivel;
+    uint32_t irq_eventos;
+    uint32_t dormant_eventos;
+} SimGpio;
+
+static SimGpio gpios[NUM_BANK0_GPIOS];
+static gpio_irq_callback_t gpio_callback = NULL;
+static bool irq_pendente = false;
+
+/* PRIMASK: com as interrupções mascaradas os handlers ficam adiados até restore_interrupts() */
+static bool interrupcoes_mascaradas = false;
+static uint32_t gpio_adiados[NUM_BANK0_GPIOS];
+
+/* Estado de cada slice PWM */
+typedef struct {
+    enum pwm_clkdiv_mode modo;
+    bool habilitado;
+    uint16_t contador;
+    uint16_t topo;
+} SimPwm;
+
+static SimPwm pwms[NUM_PWM_SLICES];
+static uint32_t pwm_irq_habilitada = 0;   /* INTE: um bit por slice */
+static uint32_t pwm_irq_status = 0;       /* INTR: wrap ocorrido e ainda não limpo */
+
+/* Handlers exclusivos e habilitação no NVIC */
+static irq_handler_t irq_handlers[NUM_IRQS];
+static uint32_t irq_habilitadas = 0;
+static uint32_t irq_adiadas = 0;          /* Sinalizadas com PRIMASK, atendidas no restore */
+
+/* Gerador de tombos do pluviômetro */
+static int chuva_gpio = -1;
+static uint32_t chuva_taxa = 0;        /* tombos por hora */
+static uint64_t chuva_acumulado = 0;   /* fração acumulada (us * tombos/h) */
+static uint64_t chuva_tombos = 0;      /* tombos entregues desde o início */
+
+/* Repique sintético: bordas extras após cada tombo, com intervalo fixo */
+static uint32_t repique_bordas = 0;
+static uint32_t repique_intervalo_us = 0;
+static uint32_t repiques_pendentes = 0;
+static uint64_t proximo_repique_us = UINT64_MAX;
+static uint64_t repiques_entregues = 0;
+#define SIM_US_POR_HORA 3600000000ULL
+
+/* Ruído na linha de despertar: pulsos curtos em nível baixo, a intervalos fixos */
+static int ruido_gpio = -1;
+static uint64_t ruido_periodo_us = 0;
+static uint64_t proximo_ruido_us = UINT64_MAX;
+static uint64_t ruidos_entregues = 0;
+
+static SimFonteDespertar fontes[SIM_MAX_FONTES];
+static uint num_fontes = 0;
+
+/* ADC: tensão em cada entrada, canal selecionado, conversões e tempo com o ADC ligado */
+static uint32_t adc_tensao_mv[NUM_ADC_CHANNELS];
+static uint adc_canal = 0;
+static uint32_t adc_conversoes = 0;
+static uint64_t adc_ligado_us = 0;
+
+
+/* ============================================================================
+ *  Relógio virtual
+ * ============================================================================
+*/
+
+static void entrega_tombo(void);
+static void entrega_borda(void);
+static void dispara_watchdog(void);
+
+uint64_t sim_tempo_us(void) { return tempo_us; }
+uint64_t sim_tempo_dormindo_us(void) { return dormindo_us; }
+uint64_t sim_tempo_dormant_us(void) { return dormant_us; }
+uint64_t sim_tempo_acordado_us(void) { return tempo_us - dormindo_us; }
+double sim_carga_uas(void) { return carga_uaus / 1e6; }
+bool sim_dormindo(void) { return dormindo; }
+bool sim_dormant(void) { return dormindo && dormant; }
+
+static uint vreg_vsel(void) {
+    return (vreg_and_chip_reset_hw->vreg & VREG_AND_CHIP_RESET_VREG_VSEL_BITS) >> VREG_AND_CHIP_RESET_VREG_VSEL_LSB;
+}
+
+/* Corrente no estado atual: acordado ela cresce com clk_sys e com o quadrado da
+   tensão do núcleo (SIM_CORRENTE_UA_POR_MHZ vale para 1,10 V) */
+static double corrente_ua(void) {
+    if (dormindo && dormant) return SIM_CORRENTE_DORMANT_UA;
+    if (dormindo) return SIM_CORRENTE_SONO_UA - (xosc_ligado ? 0 : SIM_CORRENTE_XOSC_UA);
+    double escala = (0.55 + 0.05 * vreg_vsel()) / 1.10;
+    double parcela_clk = (double)SIM_CORRENTE_UA_POR_MHZ * clk_hz[clk_sys] / MHZ * escala * escala;
+    if (esperando_evento) parcela_clk *= SIM_FRACAO_CORRENTE_WFE;
+    return SIM_CORRENTE_BASE_UA + parcela_clk;
+}
+
+/* O watchdog também conta durante o sono: armado ao dormir, ele reinicia o nó */
+static void passa_tempo(uint64_t passo) {
+    bool estoura = (watchdog_prazo_us - tempo_us <= passo);
+    if (estoura) passo = watchdog_prazo_us - tempo_us;
+
+    tempo_us += passo;
+    carga_uaus += corrente_ua() * (double)passo;
+    if (dormindo) dormindo_us += passo;
+    if (dormindo && dormant) dormant_us += passo;
+    if (adc_hw->cs & ADC_CS_EN_BITS) adc_ligado_us += passo;
+    if (estoura) dispara_watchdog();
+}
+
+void sim_avanca_us(uint64_t dt_us) {
+    /* Núcleo preso em um laço: só o watchdog o tira de lá */
+    if (nucleo_travado && !dormindo) {
+        nucleo_travado = false;
+        if (watchdog_prazo_us == UINT64_MAX) {
+            sim_encerra(1, "nucleo travado com o watchdog desligado (o no nao acordaria)");
+        }
+        passa_tempo(watchdog_prazo_us - tempo_us);
+    }
+
+    bool chove = (chuva_gpio >= 0 && chuva_taxa != 0);
+    if (!chove && !repiques_pendentes) {
+        passa_tempo(dt_us);
+        return;
+    }
+
+    /* Avançando até cada tombo (ou borda de repique) para entregá-lo no instante correto */
+    while (dt_us > 0) {
+        uint64_t passo = dt_us;
+        if (chove) {
+            uint64_t falta = (SIM_US_POR_HORA - chuva_acumulado + chuva_taxa - 1) / chuva_taxa;
+            if (falta < passo) passo = falta;
+        }
+        if (repiques_pendentes && proximo_repique_us - tempo_us < passo) passo = proximo_repique_us - tempo_us;
+
+        passa_tempo(passo);
+        if (chove) chuva_acumulado += passo * chuva_taxa;
+        dt_us -= passo;
+
+        if (repiques_pendentes && tempo_us == proximo_repique_us) {
+            repiques_pendentes--;
+            repiques_entregues++;
+            proximo_repique_us = repiques_pendentes ? tempo_us + repique_intervalo_us : UINT64_MAX;
+            entrega_borda();
+        }
+        if (chove && chuva_acumulado >= SIM_US_POR_HORA) {
+            chuva_acumulado -= SIM_US_POR_HORA;
+            entrega_tombo();
+        }
+    }
+}
+
+uint64_t time_us_64(void) { return tempo_us; }
+uint32_t time_us_32(void) { return (uint32_t)tempo_us; }
+void sleep_us(uint64_t us) { sim_avanca_us(us); }
+void sleep_ms(uint32_t ms) { sim_avanca_us((uint64_t)ms * 1000); }
+void busy_wait_us(uint64_t us) { sim_avanca_us(us); }
+void busy_wait_us_32(uint32_t us) { sim_avanca_us(us); }
+void busy_wait_ms(uint32_t ms) { sim_avanca_us((uint64_t)ms * 1000); }
+
+unsigned long millis(void) { return (unsigned long)(tempo_us / 1000); }
+unsigned long micros(void) { return (unsigned long)tempo_us; }
+void delay(unsigned long ms) { sim_avanca_us((uint64_t)ms * 1000); }
+void delayMicroseconds(unsigned int us) { sim_avanca_us(us); }
+
+
+/* ============================================================================
+ *  GPIO
+ * ============================================================================
+*/
+
+void gpio_init(uint gpio) {
+    gpios[gpio].funcao = GPIO_FUNC_SIO;
+    gpios[gpio].saida = false;
+}
+
+/* Uma saída em 0 que passa a entrada solta a linha: em SCL do I2C é uma borda de subida */
+void gpio_set_dir(uint gpio, bool out) {
+    bool soltou = gpios[gpio].saida && !out;
+    gpios[gpio].saida = out;
+    if (soltou && gpios[gpio].funcao == GPIO_FUNC_SIO) sim_i2c_scl_solto(gpio);
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    gpios[gpio].funcao = fn;
+    if (fn == GPIO_FUNC_I2C) sim_i2c_registra_pino(gpio);
+}
+
+enum gpio_function gpio_get_function(uint gpio) { return gpios[gpio].funcao; }
+
+void gpio_pull_up(uint gpio) { gpios[gpio].nivel = true; }
+void gpio_pull_down(uint gpio) { gpios[gpio].nivel = false; }
+void gpio_disable_pulls(uint gpio) { (void)gpio; }
+
+bool gpio_get(uint gpio) {
+    bool nivel;
+    if (gpios[gpio].funcao == GPIO_FUNC_SIO && !gpios[gpio].saida && sim_i2c_nivel_pino(gpio, &nivel)) return nivel;
+    return gpios[gpio].nivel;
+}
+void gpio_put(uint gpio, bool value) { gpios[gpio].nivel = value; }
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled) {
+    if (enabled) gpios[gpio].irq_eventos |= event_mask;
+    else gpios[gpio].irq_eventos &= ~event_mask;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback) {
+    gpio_set_irq_enabled(gpio, event_mask, enabled);
+    if (enabled) gpio_callback = callback;
+}
+
+void gpio_set_dormant_irq_enabled(uint gpio, uint32_t event_mask, bool enabled) {
+    uint32_t bits = event_mask << (4 * (gpio % 8));
+    if (enabled) {
+        gpios[gpio].dormant_eventos |= event_mask;
+        io_bank0_hw->dormant_wake_irq_ctrl.inte[gpio / 8] |= bits;
+    } else {
+        gpios[gpio].dormant_eventos &= ~event_mask;
+        io_bank0_hw->dormant_wake_irq_ctrl.inte[gpio / 8] &= ~bits;
+    }
+}
+
+/* Limpando as bordas em INTR (e, com elas, o status de despertar do dormant) */
+void gpio_acknowledge_irq(uint gpio, uint32_t event_mask) {
+    uint32_t bits = (event_mask & (GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE)) << (4 * (gpio % 8));
+    io_bank0_hw->intr[gpio / 8] &= ~bits;
+    io_bank0_hw->dormant_wake_irq_ctrl.ints[gpio / 8] &= ~bits;
+}
+
+void sim_gpio_nivel(uint gpio, bool nivel) { gpios[gpio].nivel = nivel; }
+
+/* Um handler nunca pode executar com memórias desligadas (ROM ou SRAM sem conteúdo) */
+static void verifica_memorias_ligadas(void) {
+    if (syscfg_hw->mempowerdown) sim_encerra(1, "handler executado com memorias desligadas");
+}
+
+static void atende_gpio(uint gpio) {
+    uint32_t eventos = gpio_adiados[gpio];
+    gpio_adiados[gpio] = 0;
+    verifica_memorias_ligadas();
+    if (gpio_callback) gpio_callback(gpio, eventos);
+
+    /* O handler do SDK reconhece as bordas atendidas, limpando INTR */
+    gpio_acknowledge_irq(gpio, eventos);
+}
+
+void sim_gpio_evento(uint gpio, uint32_t eventos) {
+    if (eventos & GPIO_IRQ_EDGE_FALL) gpios[gpio].nivel = false;
+    if (eventos & GPIO_IRQ_EDGE_RISE) gpios[gpio].nivel = true;
+
+    /* Bordas ficam registradas em INTR até gpio_acknowledge_irq() */
+    uint32_t bits = (eventos & (GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE)) << (4 * (gpio % 8));
+    io_bank0_hw->intr[gpio / 8] |= bits;
+
+    /* Evento habilitado para despertar do modo dormant (borda ou o nível que ela deixou) */
+    uint32_t nivel = gpios[gpio].nivel ? GPIO_IRQ_LEVEL_HIGH : GPIO_IRQ_LEVEL_LOW;
+    if (gpios[gpio].dormant_eventos & (eventos | nivel)) {
+        io_bank0_hw->dormant_wake_irq_ctrl.ints[gpio / 8] |= bits;
+        irq_pendente = true;
+    }
+
+    /* Evento habilitado no NVIC: executando o callback e despertando de __wfi(). Em dormant
+       não há clock para a detecção de borda do banco de IO, só o despertar acima */
+    if ((gpios[gpio].irq_eventos & eventos) && !sim_dormant()) {
+        irq_pendente = true;
+        gpio_adiados[gpio] |= gpios[gpio].irq_eventos & eventos;
+        if (!interrupcoes_mascaradas) atende_gpio(gpio);
+    }
+}
+
+
+/* ============================================================================
+ *  UART
+ * ============================================================================
+*/
+
+uint uart_init(uart_inst_t *uart, uint baudrate) {
+    uart->baudrate = baudrate;
+    uart->clk_peri_hz = clk_hz[clk_peri];
+    return baudrate;
+}
+
+void uart_deinit(uart_inst_t *uart) { uart->baudrate = 0; }
+
+uint uart_set_baudrate(uart_inst_t *uart, uint baudrate) { return uart_init(uart, baudrate); }
+
+void uart_write_blocking(uart_inst_t *uart, const uint8_t *src, size_t len) {
+    if (uart->baudrate == 0) return;
+    /* Divisor calculado para outro clk_peri: o receptor veria lixo */
+    if (uart->clk_peri_hz != clk_hz[clk_peri]) sim_encerra(1, "UART com divisor de baud de outro clk_peri");
+
+    /* Contabilizando 10 bits (start + 8 dados + stop) por byte */
+    sim_avanca_us((uint64_t)len * 10 * 1000000 / uart->baudrate);
+    uart_bytes += (uint32_t)len;
+    if (uart_eco) fwrite(src, 1, len, stdout);
+}
+
+void uart_putc(uart_inst_t *uart, char c) { uart_write_blocking(uart, (const uint8_t *)&c, 1); }
+
+void uart_puts(uart_inst_t *uart, const char *s) {
+    uart_write_blocking(uart, (const uint8_t *)s, strlen(s));
+}
+
+void uart_tx_wait_blocking(uart_inst_t *uart) { (void)uart; }
+
+uint spi_init(spi_inst_t *spi, uint baudrate) {
+    spi->baudrate = baudrate;
+    return baudrate;
+}
+
+uint spi_set_baudrate(spi_inst_t *spi, uint baudrate) { return spi_init(spi, baudrate); }
+
+void sim_uart_eco(bool habilitado) { uart_eco = habilitado; }
+uint32_t sim_uart_bytes(void) { return uart_bytes; }
+
+
+/* ============================================================================
+ *  PWM (contagem de bordas no canal B)
+ * ============================================================================
+*/
+
+pwm_config pwm_get_default_config(void) {
+    pwm_config c = { 0, 1 << 4, 0xFFFF };
+    return c;
+}
+
+void pwm_config_set_clkdiv_mode(pwm_config *c, enum pwm_clkdiv_mode mode) { c->csr = (uint32_t)mode; }
+void pwm_config_set_clkdiv(pwm_config *c, float div) { c->div = (uint32_t)(div * 16); }
+void pwm_config_set_wrap(pwm_config *c, uint16_t wrap) { c->top = wrap; }
+
+void pwm_init(uint slice_num, pwm_config *c, bool start) {
+    pwms[slice_num].modo = (enum pwm_clkdiv_mode)c->csr;
+    pwms[slice_num].topo = (uint16_t)c->top;
+    pwms[slice_num].contador = 0;
+    pwms[slice_num].habilitado = start;
+}
+
+void pwm_set_enabled(uint slice_num, bool enabled) { pwms[slice_num].habilitado = enabled; }
+void pwm_set_wrap(uint slice_num, uint16_t wrap) { pwms[slice_num].topo = wrap; }
+uint16_t pwm_get_counter(uint slice_num) { return pwms[slice_num].contador; }
+void pwm_set_counter(uint slice_num, uint16_t c) { pwms[slice_num].contador = c; }
+
+void pwm_set_irq_enabled(uint slice_num, bool enabled) {
+    if (enabled) pwm_irq_habilitada |= 1u << slice_num;
+    else pwm_irq_habilitada &= ~(1u << slice_num);
+}
+
+void pwm_clear_irq(uint slice_num) { pwm_irq_status &= ~(1u << slice_num); }
+uint32_t pwm_get_irq_status_mask(void) { return pwm_irq_status; }
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) { irq_handlers[num] = handler; }
+
+void irq_set_enabled(uint num, bool enabled) {
+    if (enabled) irq_habilitadas |= 1u << num;
+    else irq_habilitadas &= ~(1u << num);
+}
+
+bool irq_is_enabled(uint num) { return (irq_habilitadas >> num) & 1u; }
+
+void sim_irq_sinaliza(uint num) {
+    if (!irq_is_enabled(num) || !irq_handlers[num]) return;
+    irq_pendente = true;
+    if (interrupcoes_mascaradas) {
+        irq_adiadas |= 1u << num;
+        return;
+    }
+    verifica_memorias_ligadas();
+    irq_handlers[num]();
+}
+
+void sim_pwm_pulsos(uint slice, uint32_t n) {
+    SimPwm *pwm = &pwms[slice];
+    if (!pwm->habilitado || pwm->modo != PWM_DIV_B_FALLING) return;
+
+    /* Durante o sleep o contador só avança se clk_sys do PWM estiver em SLEEP_EN0 (nunca em dormant) */
+    if (dormindo && (dormant || !(clocks_hw->sleep_en0 & CLOCKS_SLEEP_EN0_CLK_SYS_PWM_BITS))) return;
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (pwm->contador != pwm->topo) {
+            pwm->contador++;
+            continue;
+        }
+
+        /* Wrap: INTR é ativado e, se habilitada no slice e no NVIC, a interrupção é atendida */
+        pwm->contador = 0;
+        pwm_irq_status |= 1u << slice;
+        if ((pwm_irq_habilitada & (1u << slice)) && irq_is_enabled(PWM_IRQ_WRAP) && irq_handlers[PWM_IRQ_WRAP]) {
+            irq_pendente = true;
+            if (!interrupcoes_mascaradas) {
+                verifica_memorias_ligadas();
+                irq_handlers[PWM_IRQ_WRAP]();
+            }
+        }
+    }
+}
+
+void sim_chuva_taxa(uint gpio, uint32_t tombos_por_hora) {
+    chuva_gpio = (int)gpio;
+    chuva_taxa = tombos_por_hora;
+    chuva_acumulado = 0;
+    chuva_tombos = 0;
+}
+
+uint64_t sim_chuva_tombos(void) { return chuva_tombos; }
+
+void sim_chuva_repique(uint32_t bordas_extras, uint32_t intervalo_us) {
+    repique_bordas = bordas_extras;
+    repique_intervalo_us = intervalo_us ? intervalo_us : 1;
+    repiques_pendentes = 0;
+    proximo_repique_us = UINT64_MAX;
+    repiques_entregues = 0;
+}
+
+uint64_t sim_chuva_repiques(void) { return repiques_entregues; }
+
+/* Instante absoluto do próximo tombo ou borda de repique, ou UINT64_MAX se não houver */
+static uint64_t proximo_tombo_us(void) {
+    uint64_t proximo = proximo_repique_us;
+    if (chuva_gpio >= 0 && chuva_taxa != 0) {
+        uint64_t tombo = tempo_us + (SIM_US_POR_HORA - chuva_acumulado + chuva_taxa - 1) / chuva_taxa;
+        if (tombo < proximo) proximo = tombo;
+    }
+    return proximo;
+}
+
+/* Uma borda de descida no pino do sensor Hall (tombo ou repique) */
+static void entrega_borda(void) {
+    uint gpio = (uint)chuva_gpio;
+    if (gpios[gpio].funcao == GPIO_FUNC_PWM && pwm_gpio_to_channel(gpio) == PWM_CHAN_B) {
+        sim_pwm_pulsos(pwm_gpio_to_slice_num(gpio), 1);
+    }
+    sim_pio_borda_descida(gpio);
+    sim_gpio_evento(gpio, GPIO_IRQ_EDGE_FALL);
+    gpios[gpio].nivel = true;
+}
+
+/* Pulso de ruído: borda de descida e a linha de volta em nível alto logo em seguida, antes
+   do handler (adiado ou não) ler o nível. Com a linha já baixa não há borda */
+static uint64_t ruido_proximo(void *ctx) {
+    (void)ctx;
+    /* Um pulso do tempo acordado é entregue na entrada do sono */
+    return (proximo_ruido_us < tempo_us) ? tempo_us : proximo_ruido_us;
+}
+
+static void ruido_dispara(void *ctx) {
+    (void)ctx;
+    uint gpio = (uint)ruido_gpio;
+    proximo_ruido_us += ruido_periodo_us;
+    if (!gpios[gpio].nivel) return;
+
+    ruidos_entregues++;
+    sim_gpio_evento(gpio, GPIO_IRQ_EDGE_FALL);
+    gpios[gpio].nivel = true;
+}
+
+void sim_ruido_gpio(uint gpio, uint32_t pulsos_por_hora) {
+    if (pulsos_por_hora == 0) return;
+    if (ruido_gpio < 0) {
+        SimFonteDespertar fonte = { ruido_proximo, ruido_dispara, NULL };
+        sim_registra_despertar(&fonte);
+    }
+    ruido_gpio = (int)gpio;
+    ruido_periodo_us = SIM_US_POR_HORA / pulsos_por_hora;
+    proximo_ruido_us = tempo_us + ruido_periodo_us;
+    ruidos_entregues = 0;
+}
+
+uint64_t sim_ruido_pulsos(void) { return ruidos_entregues; }
+
+/* Um tombo gera uma borda de descida, seguida das bordas de repique configuradas */
+static void entrega_tombo(void) {
+    chuva_tombos++;
+    entrega_borda();
+    if (repique_bordas) {
+        repiques_pendentes = repique_bordas;
+        proximo_repique_us = tempo_us + repique_intervalo_us;
+    }
+}
+
+
+/* ============================================================================
+ *  ADC
+ * ============================================================================
+*/
+
+void sim_adc_tensao_mv(uint canal, uint32_t mv) {
+    if (canal < NUM_ADC_CHANNELS) adc_tensao_mv[canal] = mv;
+}
+
+uint32_t sim_adc_conversoes(void) { return adc_conversoes; }
+uint64_t sim_adc_ligado_us(void) { return adc_ligado_us; }
+
+/* Sem clk_adc o bit READY nunca sobe e o SDK ficaria preso esperando por ele */
+void adc_init(void) {
+    if (!clk_hz[clk_adc]) sim_encerra(1, "adc_init() sem clk_adc (o no travaria)");
+    adc_hw->cs = ADC_CS_EN_BITS | ADC_CS_READY_BITS;
+    adc_hw->result = 0;
+    adc_canal = 0;
+}
+
+void adc_gpio_init(uint gpio) {
+    gpios[gpio].funcao = GPIO_FUNC_NULL;
+}
+
+void adc_select_input(uint input) {
+    if (input < NUM_ADC_CHANNELS) adc_canal = input;
+}
+
+/* Código de 12 bits da tensão do canal (referência de 3,3 V), com ±1 LSB de ruído */
+uint16_t adc_read(void) {
+    static const int ruido[4] = { 0, 1, 0, -1 };
+
+    if (!(adc_hw->cs & ADC_CS_EN_BITS) || !clk_hz[clk_adc]) {
+        sim_encerra(1, "adc_read() com o ADC desligado (o no travaria)");
+    }
+    sim_avanca_us((96ULL * MHZ + clk_hz[clk_adc] - 1) / clk_hz[clk_adc]);
+
+    int32_t codigo = (int32_t)((adc_tensao_mv[adc_canal] * 4096ULL + 1650) / 3300) + ruido[adc_conversoes % 4];
+    if (codigo < 0) codigo = 0;
+    if (codigo > 4095) codigo = 4095;
+    adc_conversoes++;
+    adc_hw->result = (uint32_t)codigo;
+    return (uint16_t)codigo;
+}
+
+
+/* ============================================================================
+ *  Clocks, osciladores e sleep
+ * ============================================================================
+*/
+
+/* clk_sys acima do que a tensão atual sustenta travaria o núcleo real */
+static void confere_tensao(uint vsel, uint32_t sys_hz) {
+    if (sys_hz > (uint32_t)SIM_VREG_MAX_MHZ(vsel) * MHZ) {
+        sim_encerra(1, "clk_sys acima do suportado pela tensao do nucleo");
+    }
+}
+
+void vreg_set_voltage(enum vreg_voltage voltage) {
+    confere_tensao(voltage, clk_hz[clk_sys]);
+    if ((uint)voltage != vreg_vsel()) vreg_trocas++;
+    vreg_and_chip_reset_hw->vreg = (vreg_and_chip_reset_hw->vreg & ~VREG_AND_CHIP_RESET_VREG_VSEL_BITS) |
+                                   ((uint32_t)voltage << VREG_AND_CHIP_RESET_VREG_VSEL_LSB);
+}
+
+uint32_t sim_vreg_trocas(void) { return vreg_trocas; }
+
+void clocks_init(void) {
+    confere_tensao(vreg_vsel(), 125 * MHZ);
+    sim_pio_sincroniza();
+    xosc_ligado = true;
+    pll_sys_inst.saida_hz = 125 * MHZ;
+    pll_usb_inst.saida_hz = 48 * MHZ;
+    clk_hz[clk_ref] = XOSC_MHZ * MHZ;
+    clk_hz[clk_sys] = 125 * MHZ;
+    clk_hz[clk_peri] = 125 * MHZ;
+    clk_hz[clk_usb] = 48 * MHZ;
+    clk_hz[clk_adc] = 48 * MHZ;
+    clk_hz[clk_rtc] = 46875;
+    sim_avanca_us(SIM_CUSTO_CLOCKS_INIT_US);
+}
+
+bool clock_configure(enum clock_index clk_index, uint32_t src, uint32_t auxsrc, uint32_t src_freq, uint32_t freq) {
+    (void)src; (void)auxsrc;
+    if (freq > src_freq) return false;
+    if (clk_index == clk_sys) confere_tensao(vreg_vsel(), freq);
+    sim_pio_sincroniza();
+    clk_hz[clk_index] = freq;
+    return true;
+}
+
+void clock_stop(enum clock_index clk_index) { clk_hz[clk_index] = 0; }
+uint32_t clock_get_hz(enum clock_index clk_index) { return clk_hz[clk_index]; }
+
+/* Código de drive strength nos registradores, sem as senhas de escrita */
+uint32_t sim_rosc_codigo(void) {
+    return (rosc_hw->freqa & 0xffffu) | ((rosc_hw->freqb & 0xffffu) << 16u);
+}
+
+/* Frequência real do ROSC no modelo: cresce com os bits de drive strength ligados */
+uint32_t sim_rosc_khz(void) {
+    uint32_t div = rosc_hw->div > ROSC_DIV_VALUE_PASS ? rosc_hw->div - ROSC_DIV_VALUE_PASS : 1;
+    return SIM_ROSC_BASE_KHZ * (100u + SIM_ROSC_PCT_POR_BIT * __builtin_popcount(sim_rosc_codigo())) / 100u / div;
+}
+
+uint32_t frequency_count_khz(uint src) {
+    sim_avanca_us(SIM_CUSTO_CONTAGEM_FREQ_US);
+    if (src != CLOCKS_FC0_SRC_VALUE_ROSC_CLKSRC) return 0;
+    rosc_contagens++;
+    return sim_rosc_khz();
+}
+
+uint32_t sim_rosc_contagens(void) { return rosc_contagens; }
+
+void xosc_init(void) {
+    if (!xosc_ligado) sim_avanca_us(SIM_CUSTO_PARTIDA_XOSC_US);
+    xosc_ligado = true;
+}
+
+void pll_init(PLL pll, uint ref_div, uint vco_freq, uint post_div1, uint post_div2) {
+    uint32_t saida = vco_freq / ref_div / (post_div1 * post_div2);
+    if (pll->saida_hz == saida) return;
+    pll->saida_hz = saida;
+    sim_avanca_us(SIM_CUSTO_TRAVA_PLL_US);
+}
+
+void pll_deinit(PLL pll) { pll->saida_hz = 0; }
+
+/* Mesma busca do SDK: VCO entre 750 e 1600 MHz, o mais alto primeiro */
+bool check_sys_clock_khz(uint32_t freq_khz, uint *vco_freq_out, uint *post_div1_out, uint *post_div2_out) {
+    uint ref_khz = XOSC_MHZ * 1000;
+    for (uint fbdiv = 320; fbdiv >= 16; fbdiv--) {
+        uint vco_khz = fbdiv * ref_khz;
+        if (vco_khz < 750000 || vco_khz > 1600000) continue;
+        for (uint pd1 = 7; pd1 >= 1; pd1--) {
+            for (uint pd2 = pd1; pd2 >= 1; pd2--) {
+                if (vco_khz / (pd1 * pd2) == freq_khz && vco_khz % (pd1 * pd2) == 0) {
+                    *vco_freq_out = vco_khz * 1000;
+                    *post_div1_out = pd1;
+                    *post_div2_out = pd2;
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+void xosc_disable(void) {}
+void xosc_dormant(void) {}
+
+void sleep_run_from_dormant_source(dormant_source_t dormant_source) {
+    uint32_t src_hz;
+    if (dormant_source == DORMANT_SOURCE_XOSC) src_hz = XOSC_MHZ * MHZ;
+    else src_hz = sim_rosc_khz() * KHZ;
+    sim_pio_sincroniza();
+    xosc_ligado = dormant_source == DORMANT_SOURCE_XOSC;
+    pll_deinit(pll_sys);
+    pll_deinit(pll_usb);
+    clk_hz[clk_ref] = src_hz;
+    clk_hz[clk_sys] = src_hz;
+    clk_hz[clk_peri] = src_hz;
+    clk_hz[clk_usb] = 0;
+    clk_hz[clk_adc] = 0;
+}
+
+uint32_t save_and_disable_interrupts(void) {
+    uint32_t status = interrupcoes_mascaradas;
+    interrupcoes_mascaradas = true;
+    return status;
+}
+
+/* Desmascarando: os handlers adiados executam na ordem das GPIOs, depois o wrap do PWM */
+void restore_interrupts(uint32_t status) {
+    interrupcoes_mascaradas = status != 0;
+    if (interrupcoes_mascaradas) return;
+
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++) {
+        if (gpio_adiados[gpio]) atende_gpio(gpio);
+    }
+    if ((pwm_irq_status & pwm_irq_habilitada) && irq_is_enabled(PWM_IRQ_WRAP) && irq_handlers[PWM_IRQ_WRAP]) {
+        verifica_memorias_ligadas();
+        irq_handlers[PWM_IRQ_WRAP]();
+    }
+    for (uint num = 0; irq_adiadas && num < NUM_IRQS; num++) {
+        if (!(irq_adiadas & (1u << num))) continue;
+        irq_adiadas &= ~(1u << num);
+        verifica_memorias_ligadas();
+        irq_handlers[num]();
+    }
+}
+
+/* Pino já no nível habilitado para despertar do dormant: o oscilador para e volta na hora */
+static bool ha_nivel_despertar_dormant(void) {
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++) {
+        uint32_t nivel = gpio_get(gpio) ? GPIO_IRQ_LEVEL_HIGH : GPIO_IRQ_LEVEL_LOW;
+        if (gpios[gpio].dormant_eventos & nivel) return true;
+    }
+    return false;
+}
+
+/* Interrupção sinalizada com PRIMASK e ainda não atendida */
+static bool ha_interrupcao_adiada(void) {
+    if (!interrupcoes_mascaradas) return false;
+    if (irq_adiadas) return true;
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++) {
+        if (gpio_adiados[gpio]) return true;
+    }
+    return (pwm_irq_status & pwm_irq_habilitada) && irq_is_enabled(PWM_IRQ_WRAP) && irq_handlers[PWM_IRQ_WRAP];
+}
+
+void sleep_wfi_with_memories_powered_down(uint32_t mem_mask) {
+    uint32_t status = save_and_disable_interrupts();
+    uint32_t anterior = syscfg_hw->mempowerdown;
+
+    syscfg_hw->mempowerdown = anterior | mem_mask;
+    __wfi();
+    syscfg_hw->mempowerdown = anterior;
+
+    restore_interrupts(status);
+}
+
+bool sleep_scratch_x_unused(void) { return true; }
+void __wfe(void) {}
+void __sev(void) {}
+void __dmb(void) {}
+
+
+/* ============================================================================
+ *  Fontes de despertar
+ * ============================================================================
+*/
+
+void sim_registra_despertar(const SimFonteDespertar *fonte) {
+    if (num_fontes < SIM_MAX_FONTES) fontes[num_fontes++] = *fonte;
+}
+
+/**
+ * @brief Dorme (no relógio virtual) até que alguma fonte gere uma interrupção habilitada.
+ *
+ * Se nenhuma fonte tiver evento agendado, ou se o nó passar do limite de sono
+ * sem despertar, a simulação é encerrada com falha: no hardware o nó ficaria
+ * parado para sempre.
+*/
+static void espera_interrupcao(bool modo_dormant) {
+    uint64_t inicio = tempo_us;
+
+    /* Com PRIMASK, uma interrupção já pendente encerra o __wfi() sem dormir */
+    irq_pendente = modo_dormant ? ha_nivel_despertar_dormant() : ha_interrupcao_adiada();
+    sim_pio_sincroniza();
+    dormindo = true;
+    dormant = modo_dormant;
+
+    while (!irq_pendente) {
+        uint64_t alvo = UINT64_MAX;
+        int escolhida = -1;
+        for (uint i = 0; i < num_fontes; i++) {
+            uint64_t t = fontes[i].proximo(fontes[i].ctx);
+            if (t < alvo) { alvo = t; escolhida = (int)i; }
+        }
+
+        /* Tombos durante o sono também podem gerar a interrupção */
+        uint64_t tombo = proximo_tombo_us();
+        uint64_t limite = (tombo < alvo) ? tombo : alvo;
+
+        if (limite == UINT64_MAX || limite - inicio > SIM_SONO_MAXIMO_US) {
+            sim_pio_sincroniza();
+            dormindo = false;
+            dormant = false;
+            sim_encerra(1, "nenhuma fonte de despertar agendada (o no nao acordaria)");
+        }
+
+        /* Em empate o avanço até o alarme já entrega o tombo; atendê-lo antes faria
+           o DS3231 procurar o próximo disparo a partir do segundo já passado */
+        if (tombo < alvo) {
+            sim_avanca_us(tombo - tempo_us);
+            continue;
+        }
+
+        if (alvo > tempo_us) sim_avanca_us(alvo - tempo_us);
+        fontes[escolhida].dispara(fontes[escolhida].ctx);
+    }
+
+    sim_pio_sincroniza();
+    dormindo = false;
+    dormant = false;
+
+    /* Saindo do dormant o núcleo só executa depois que o oscilador estabiliza */
+    if (modo_dormant) sim_avanca_us(SIM_CUSTO_PARTIDA_DORMANT_US);
+
+    if (travar_no_despertar) {
+        travar_no_despertar = false;
+        nucleo_travado = true;
+    }
+}
+
+void __wfi(void) {
+    espera_interrupcao(false);
+}
+
+/**
+ * @brief Núcleo parado em __wfe() até uma interrupção ou até o prazo.
+ *
+ * Diferente do __wfi() do sono, clk_sys continua ligado (o DMA e o I2C seguem
+ * trabalhando): o tempo conta como acordado, com a corrente reduzida do núcleo
+ * parado (SIM_FRACAO_CORRENTE_WFE).
+*/
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp) {
+    irq_pendente = false;
+    esperando_evento = true;
+
+    while (!irq_pendente && tempo_us < timeout_timestamp) {
+        uint64_t alvo = UINT64_MAX;
+        int escolhida = -1;
+        for (uint i = 0; i < num_fontes; i++) {
+            uint64_t t = fontes[i].proximo(fontes[i].ctx);
+            if (t < alvo) { alvo = t; escolhida = (int)i; }
+        }
+        if (alvo >= timeout_timestamp) {
+            sim_avanca_us(timeout_timestamp - tempo_us);
+            break;
+        }
+        if (alvo > tempo_us) sim_avanca_us(alvo - tempo_us);
+        fontes[escolhida].dispara(fontes[escolhida].ctx);
+    }
+
+    esperando_evento = false;
+    return tempo_us >= timeout_timestamp;
+}
+
+/* ============================================================================
+ *  Watchdog
+ * ============================================================================
+*/
+
+/* scratch[4] gravado pelo watchdog_enable() do SDK (distingue do watchdog_reboot()) */
+#define SIM_WATCHDOG_NAO_REBOOT 0x6ab73121u
+
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug) {
+    (void)pause_on_debug;
+    watchdog_hw->scratch[4] = SIM_WATCHDOG_NAO_REBOOT;
+    watchdog_hw->load = delay_ms * 1000;
+    watchdog_hw->ctrl |= WATCHDOG_CTRL_ENABLE_BITS;
+    watchdog_prazo_us = tempo_us + watchdog_hw->load;
+}
+
+void watchdog_update(void) {
+    if (watchdog_hw->ctrl & WATCHDOG_CTRL_ENABLE_BITS) watchdog_prazo_us = tempo_us + watchdog_hw->load;
+}
+
+void watchdog_disable(void) {
+    watchdog_hw->ctrl &= ~WATCHDOG_CTRL_ENABLE_BITS;
+    watchdog_prazo_us = UINT64_MAX;
+}
+
+bool watchdog_caused_reboot(void) { return watchdog_hw->reason != 0; }
+
+bool watchdog_enable_caused_reboot(void) {
+    return watchdog_hw->reason && watchdog_hw->scratch[4] == SIM_WATCHDOG_NAO_REBOOT;
+}
+
+void sim_trava_nucleo(void) { travar_no_despertar = true; }
+
+/**
+ * @brief Reset pelo watchdog: núcleo, clocks, regulador e interrupções voltam ao
+ *        estado do boot e o executor recomeça pelo setup().
+ *
+ * Os registradores scratch e o motivo do reset são preservados, como no RP2040.
+ * Os modelos dos dispositivos externos (DS3231, SHT30) não são afetados.
+*/
+static void dispara_watchdog(void) {
+    watchdog_disable();
+    watchdog_hw->reason = WATCHDOG_REASON_TIMER_BITS;
+
+    dormindo = false;
+    dormant = false;
+    esperando_evento = false;
+    nucleo_travado = false;
+    irq_pendente = false;
+    interrupcoes_mascaradas = false;
+    gpio_callback = NULL;
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++) {
+        gpios[gpio].irq_eventos = 0;
+        gpios[gpio].dormant_eventos = 0;
+        gpio_adiados[gpio] = 0;
+    }
+    memset(irq_handlers, 0, sizeof(irq_handlers));
+    irq_habilitadas = 0;
+    irq_adiadas = 0;
+    pwm_irq_habilitada = 0;
+    pwm_irq_status = 0;
+    scb_hw->scr = 0;
+    syscfg_hw->mempowerdown = 0;
+    vreg_and_chip_reset_hw->vreg = VREG_AND_CHIP_RESET_VREG_RESET;
+    adc_hw->cs = 0;
+
+    /* O runtime do SDK refaz clocks_init() antes do setup() */
+    clocks_init();
+    sim_reinicia_pelo_watchdog();
+}
+
+void sleep_goto_dormant_until_pin(uint gpio_pin, bool edge, bool high) {
+    uint32_t evento = edge ? (high ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL)
+                           : (high ? GPIO_IRQ_LEVEL_HIGH : GPIO_IRQ_LEVEL_LOW);
+    gpio_set_dormant_irq_enabled(gpio_pin, evento, true);
+    espera_interrupcao(true);
+    gpio_set_dormant_irq_enabled(gpio_pin, evento, false);
+}
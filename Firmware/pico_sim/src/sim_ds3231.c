@@ -0,0 +1,293 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  sim_ds3231.c
+ *
+ *    Description:  Modelo do RTC DS3231: mapa de registradores, hora derivada do
+ *                  relógio virtual, alarmes 1 e 2 e linha INT/SQW.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 15:10:44
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include <string.h>
+
+#include "pico_sim.h"
+#include "hardware/i2c.h"
+#include "hardware/gpio.h"
+
+#define DS3231_ENDERECO     0x68
+#define DS3231_NUM_REGS     0x13
+
+#define REG_ALARM1          0x07
+#define REG_ALARM2          0x0B
+#define REG_CONTROLE        0x0E
+#define REG_STATUS          0x0F
+
+#define CTRL_A1IE           0x01
+#define CTRL_A2IE           0x02
+#define CTRL_INTCN          0x04
+#define STAT_A1F            0x01
+#define STAT_A2F            0x02
+
+#define SEGUNDOS_POR_DIA    86400ULL
+
+/* Maior distância procurada para o próximo disparo de alarme */
+#define BUSCA_MAXIMA_S      (32 * SEGUNDOS_POR_DIA)
+
+typedef struct {
+    uint8_t regs[DS3231_NUM_REGS];
+    uint8_t ponteiro;
+    uint64_t base_s;        /* Segundos desde 01/01/2000 00:00:00 em base_us */
+    uint64_t base_us;
+    uint int_gpio;
+    int proximo_alarme;     /* Alarme (1 ou 2) do próximo evento calculado */
+} SimDS3231;
+
+static SimDS3231 rtc;
+
+/* Campos de data e hora em decimal */
+typedef struct {
+    uint8_t seg, min, hora, dia_semana, dia, mes, ano;
+} Calendario;
+
+
+/* ============================================================================
+ *  Conversões de calendário
+ * ============================================================================
+*/
+
+static uint8_t para_bcd(uint8_t v) { return (uint8_t)(((v / 10) << 4) | (v % 10)); }
+static uint8_t de_bcd(uint8_t v) { return (uint8_t)(((v >> 4) * 10) + (v & 0x0F)); }
+
+/* Dias desde 01/01/2000 para dia/mês/ano (algoritmo de calendário civil) */
+static void dias_para_data(uint64_t dias, Calendario *c) {
+    int64_t z = (int64_t)dias + 10957 + 719468;  /* deslocando para a época 0000-03-01 */
+    int64_t era = z / 146097;
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    int64_t d = doy - (153 * mp + 2) / 5 + 1;
+    int64_t m = mp < 10 ? mp + 3 : mp - 9;
+    int64_t y = yoe + era * 400 + (m <= 2);
+
+    c->dia = (uint8_t)d;
+    c->mes = (uint8_t)m;
+    c->ano = (uint8_t)(y - 2000);
+    /* 01/01/2000 foi um sábado; domingo = 1 */
+    c->dia_semana = (uint8_t)(((dias + 6) % 7) + 1);
+}
+
+static uint64_t data_para_dias(const Calendario *c) {
+    int64_t y = 2000 + c->ano - (c->mes <= 2);
+    int64_t era = y / 400;
+    int64_t yoe = y - era * 400;
+    int64_t mp = (c->mes + 9) % 12;
+    int64_t doy = (153 * mp + 2) / 5 + c->dia - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return (uint64_t)(era * 146097 + doe - 719468 - 10957);
+}
+
+static void segundos_para_calendario(uint64_t s, Calendario *c) {
+    dias_para_data(s / SEGUNDOS_POR_DIA, c);
+    uint32_t no_dia = (uint32_t)(s % SEGUNDOS_POR_DIA);
+    c->hora = (uint8_t)(no_dia / 3600);
+    c->min = (uint8_t)((no_dia / 60) % 60);
+    c->seg = (uint8_t)(no_dia % 60);
+}
+
+static uint64_t agora_s(void) {
+    return rtc.base_s + (sim_tempo_us() - rtc.base_us) / 1000000;
+}
+
+/* Instante (relógio virtual) em que o RTC passa a marcar o segundo s */
+static uint64_t segundo_para_us(uint64_t s) {
+    return rtc.base_us + (s - rtc.base_s) * 1000000;
+}
+
+
+/* ============================================================================
+ *  Alarmes e linha INT/SQW
+ * ============================================================================
+*/
+
+static bool int_ativo(void) {
+    uint8_t ctrl = rtc.regs[REG_CONTROLE];
+    uint8_t stat = rtc.regs[REG_STATUS];
+    if (!(ctrl & CTRL_INTCN)) return false;
+    return ((stat & STAT_A1F) && (ctrl & CTRL_A1IE)) || ((stat & STAT_A2F) && (ctrl & CTRL_A2IE));
+}
+
+/**
+ * @brief Verifica se o segundo s satisfaz o alarme (registradores a partir de reg).
+ * O alarme 2 não possui registrador de segundos e dispara no segundo 00.
+*/
+static bool alarme_coincide(uint8_t reg, bool tem_segundos, uint64_t s) {
+    Calendario c;
+    segundos_para_calendario(s, &c);
+    const uint8_t *a = &rtc.regs[reg];
+
+    if (tem_segundos) {
+        if (!(a[0] & 0x80) && de_bcd(a[0] & 0x7F) != c.seg) return false;
+        a++;
+    } else if (c.seg != 0) {
+        return false;
+    }
+
+    if (!(a[0] & 0x80) && de_bcd(a[0] & 0x7F) != c.min) return false;
+    if (!(a[1] & 0x80) && de_bcd(a[1] & 0x3F) != c.hora) return false;
+    if (!(a[2] & 0x80)) {
+        if (a[2] & 0x40) {
+            if ((a[2] & 0x0F) != c.dia_semana) return false;
+        } else if (de_bcd(a[2] & 0x3F) != c.dia) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Próximo segundo (> agora) em que o alarme dispara, ou UINT64_MAX */
+static uint64_t proximo_disparo(uint8_t reg, bool tem_segundos) {
+    uint64_t inicio = agora_s() + 1;
+    uint64_t passo = 1;
+
+    /* Com os segundos fixados, basta testar um candidato por minuto */
+    uint8_t seg_reg = rtc.regs[reg];
+    if (!tem_segundos || !(seg_reg & 0x80)) {
+        uint8_t alvo = tem_segundos ? de_bcd(seg_reg & 0x7F) : 0;
+        if (alvo >= 60) return UINT64_MAX;
+        while (inicio % 60 != alvo) inicio++;
+        passo = 60;
+    }
+
+    for (uint64_t s = inicio; s < inicio + BUSCA_MAXIMA_S; s += passo) {
+        if (alarme_coincide(reg, tem_segundos, s)) return s;
+    }
+    return UINT64_MAX;
+}
+
+/**
+ * @brief Próximo evento capaz de gerar borda de descida em INT/SQW.
+ *
+ * Se a linha já estiver em nível baixo (flag não limpa), um novo disparo não
+ * gera borda e, portanto, não desperta o microcontrolador.
+*/
+static uint64_t ds3231_proximo(void *ctx) {
+    (void)ctx;
+    uint8_t ctrl = rtc.regs[REG_CONTROLE];
+    if (!(ctrl & CTRL_INTCN) || int_ativo()) return UINT64_MAX;
+
+    uint64_t a1 = (ctrl & CTRL_A1IE) ? proximo_disparo(REG_ALARM1, true) : UINT64_MAX;
+    uint64_t a2 = (ctrl & CTRL_A2IE) ? proximo_disparo(REG_ALARM2, false) : UINT64_MAX;
+
+    if (a1 == UINT64_MAX && a2 == UINT64_MAX) return UINT64_MAX;
+    rtc.proximo_alarme = (a1 <= a2) ? 1 : 2;
+    return segundo_para_us((a1 <= a2) ? a1 : a2);
+}
+
+static void ds3231_dispara(void *ctx) {
+    (void)ctx;
+    bool antes = int_ativo();
+    rtc.regs[REG_STATUS] |= (rtc.proximo_alarme == 1) ? STAT_A1F : STAT_A2F;
+    if (!antes && int_ativo()) {
+        sim_gpio_evento(rtc.int_gpio, GPIO_IRQ_EDGE_FALL);
+    }
+}
+
+
+/* ============================================================================
+ *  Interface I2C
+ * ============================================================================
+*/
+
+/* Copia a hora atual para os registradores 0x00–0x06 (latch no START) */
+static void atualiza_registradores_hora(void) {
+    Calendario c;
+    segundos_para_calendario(agora_s(), &c);
+    rtc.regs[0x00] = para_bcd(c.seg);
+    rtc.regs[0x01] = para_bcd(c.min);
+    rtc.regs[0x02] = para_bcd(c.hora);
+    rtc.regs[0x03] = c.dia_semana;
+    rtc.regs[0x04] = para_bcd(c.dia);
+    rtc.regs[0x05] = para_bcd(c.mes);
+    rtc.regs[0x06] = para_bcd(c.ano);
+}
+
+static int ds3231_escrita(void *ctx, const uint8_t *src, size_t n, bool nostop) {
+    (void)ctx; (void)nostop;
+    if (n == 0) return 0;
+
+    rtc.ponteiro = src[0] % DS3231_NUM_REGS;
+    atualiza_registradores_hora();
+
+    bool escreveu_hora = false;
+    bool int_antes = int_ativo();
+
+    for (size_t i = 1; i < n; i++) {
+        uint8_t reg = rtc.ponteiro;
+        if (reg == REG_STATUS) {
+            /* A1F/A2F/OSF só podem ser zerados pela escrita */
+            uint8_t flags = STAT_A1F | STAT_A2F | 0x80;
+            rtc.regs[reg] = (uint8_t)((rtc.regs[reg] & src[i] & flags) | (src[i] & ~flags));
+        } else {
+            rtc.regs[reg] = src[i];
+        }
+        if (reg <= 0x06) escreveu_hora = true;
+        rtc.ponteiro = (uint8_t)((reg + 1) % DS3231_NUM_REGS);
+    }
+
+    if (escreveu_hora) {
+        Calendario c;
+        c.seg = de_bcd(rtc.regs[0x00] & 0x7F);
+        c.min = de_bcd(rtc.regs[0x01] & 0x7F);
+        c.hora = de_bcd(rtc.regs[0x02] & 0x3F);
+        c.dia = de_bcd(rtc.regs[0x04] & 0x3F);
+        c.mes = de_bcd(rtc.regs[0x05] & 0x1F);
+        c.ano = de_bcd(rtc.regs[0x06]);
+        rtc.base_s = data_para_dias(&c) * SEGUNDOS_POR_DIA + c.hora * 3600u + c.min * 60u + c.seg;
+        rtc.base_us = sim_tempo_us();
+    }
+
+    /* Limpar a flag libera a linha INT (borda de subida) */
+    if (int_antes && !int_ativo()) {
+        sim_gpio_nivel(rtc.int_gpio, true);
+    }
+    return (int)n;
+}
+
+static int ds3231_leitura(void *ctx, uint8_t *dst, size_t n, bool nostop) {
+    (void)ctx; (void)nostop;
+    atualiza_registradores_hora();
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = rtc.regs[rtc.ponteiro];
+        rtc.ponteiro = (uint8_t)((rtc.ponteiro + 1) % DS3231_NUM_REGS);
+    }
+    return (int)n;
+}
+
+void sim_ds3231_inicializa(i2c_inst_t *i2c, uint int_gpio) {
+    memset(&rtc, 0, sizeof(rtc));
+    rtc.regs[REG_CONTROLE] = 0x1C;   /* Valor de power-on: INTCN, RS2 e RS1 */
+    rtc.regs[REG_STATUS] = 0x88;     /* OSF e EN32kHz */
+    rtc.int_gpio = int_gpio;
+    rtc.base_us = sim_tempo_us();
+
+    /* Data inicial arbitrária: 01/01/2025 00:00:00 */
+    Calendario c = { 0, 0, 0, 0, 1, 1, 25 };
+    rtc.base_s = data_para_dias(&c) * SEGUNDOS_POR_DIA;
+    sim_gpio_nivel(int_gpio, true);
+
+    static const SimDispositivoI2C disp = { ds3231_escrita, ds3231_leitura, NULL };
+    sim_i2c_conecta(i2c, DS3231_ENDERECO, &disp);
+
+    static const SimFonteDespertar fonte = { ds3231_proximo, ds3231_dispara, NULL };
+    sim_registra_despertar(&fonte);
+}
@@ -0,0 +1,245 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  sim_i2c.c
+ *
+ *    Description:  Barramento I2C simulado com dispositivos programáveis.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 14:58:30
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include "pico_sim.h"
+#include "hardware/i2c.h"
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/dma.h"
+
+#define SIM_MAX_DISPOSITIVOS 8
+
+i2c_inst_t i2c0_inst = { .indice = 0, .dma_fim_us = UINT64_MAX };
+i2c_inst_t i2c1_inst = { .indice = 1, .dma_fim_us = UINT64_MAX };
+
+/* Pinos já ligados à função I2C (gpio_set_function): SDA nos pares, SCL nos ímpares */
+static bool pino_i2c[NUM_BANK0_GPIOS];
+
+typedef struct {
+    i2c_inst_t *i2c;
+    uint8_t endereco;
+    SimDispositivoI2C disp;
+} SimConexao;
+
+static SimConexao conexoes[SIM_MAX_DISPOSITIVOS];
+static uint num_conexoes = 0;
+
+void sim_i2c_conecta(i2c_inst_t *i2c, uint8_t endereco, const SimDispositivoI2C *disp) {
+    if (num_conexoes < SIM_MAX_DISPOSITIVOS) {
+        conexoes[num_conexoes].i2c = i2c;
+        conexoes[num_conexoes].endereco = endereco;
+        conexoes[num_conexoes].disp = *disp;
+        num_conexoes++;
+    }
+}
+
+uint32_t sim_i2c_transacoes(i2c_inst_t *i2c) { return i2c->transacoes; }
+void sim_i2c_zera_transacoes(i2c_inst_t *i2c) { i2c->transacoes = 0; }
+uint32_t sim_i2c_pulsos_scl(i2c_inst_t *i2c) { return i2c->pulsos_scl; }
+
+void sim_i2c_trava_barramento(i2c_inst_t *i2c, bool travado) {
+    i2c->travado = travado;
+    i2c->pulsos_para_liberar = travado ? SIM_I2C_PULSOS_LIBERACAO : 0;
+}
+
+static SimDispositivoI2C *procura(i2c_inst_t *i2c, uint8_t endereco) {
+    for (uint i = 0; i < num_conexoes; i++) {
+        if (conexoes[i].i2c == i2c && conexoes[i].endereco == endereco) return &conexoes[i].disp;
+    }
+    return NULL;
+}
+
+/* Tempo de barramento: 9 bits por byte (8 dados + ACK) mais o byte de endereço. Os divisores
+   de SCL valem para o clk_peri do i2c_init(): com outro clk_peri o SCL escala junto */
+static uint64_t duracao_us(i2c_inst_t *i2c, size_t len) {
+    uint64_t baud = i2c->baudrate ? i2c->baudrate : 100000;
+    if (i2c->baudrate && i2c->clk_peri_hz && clock_get_hz(clk_peri)) {
+        baud = baud * clock_get_hz(clk_peri) / i2c->clk_peri_hz;
+    }
+    return ((uint64_t)(len + 1) * 9 * 1000000 + baud - 1) / baud;
+}
+
+static int transfere(i2c_inst_t *i2c, uint8_t addr, uint8_t *buf, size_t len, bool nostop,
+                     bool leitura, uint64_t timeout_us) {
+    /* Uma transferência após outra sem STOP usa START repetido: mesma transação */
+    if (!i2c->sem_stop) i2c->transacoes++;
+    i2c->sem_stop = nostop;
+
+    /* Escravo segurando SDA: o mestre não consegue gerar START */
+    if (i2c->travado) {
+        if (timeout_us == UINT64_MAX) sim_encerra(1, "I2C travado em transferencia sem timeout");
+        sim_avanca_us(timeout_us);
+        return PICO_ERROR_TIMEOUT;
+    }
+
+    SimDispositivoI2C *disp = procura(i2c, addr);
+    sim_avanca_us(duracao_us(i2c, disp ? len : 0));
+    if (!disp) return PICO_ERROR_GENERIC;
+
+    int ret = leitura ? disp->leitura(disp->ctx, buf, len, nostop)
+                      : disp->escrita(disp->ctx, buf, len, nostop);
+    return (ret < 0) ? PICO_ERROR_GENERIC : ret;
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    i2c->clk_peri_hz = clock_get_hz(clk_peri);
+    return baudrate;
+}
+
+void i2c_deinit(i2c_inst_t *i2c) { i2c->baudrate = 0; }
+
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate) { return i2c_init(i2c, baudrate); }
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    return transfere(i2c, addr, (uint8_t *)src, len, nostop, false, UINT64_MAX);
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    return transfere(i2c, addr, dst, len, nostop, true, UINT64_MAX);
+}
+
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop, uint timeout_us) {
+    return transfere(i2c, addr, (uint8_t *)src, len, nostop, false, timeout_us);
+}
+
+int i2c_read_timeout_us(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop, uint timeout_us) {
+    return transfere(i2c, addr, dst, len, nostop, true, timeout_us);
+}
+
+
+/* ============================================================================
+ *  Pinos como GPIO (recuperação do barramento)
+ * ============================================================================
+*/
+
+/* Controlador de cada pino na função I2C do RP2040: GPIO 0/1 = i2c0, 2/3 = i2c1, ... */
+static i2c_inst_t *instancia_do_pino(uint gpio) {
+    return ((gpio / 2) % 2) ? i2c1 : i2c0;
+}
+
+void sim_i2c_registra_pino(uint gpio) {
+    if (gpio < NUM_BANK0_GPIOS) pino_i2c[gpio] = true;
+}
+
+/* Linhas com pull-up: SCL sempre sobe ao ser solta; SDA fica baixa com o escravo travado */
+bool sim_i2c_nivel_pino(uint gpio, bool *nivel) {
+    if (gpio >= NUM_BANK0_GPIOS || !pino_i2c[gpio]) return false;
+    *nivel = (gpio % 2) ? true : !instancia_do_pino(gpio)->travado;
+    return true;
+}
+
+/* Cada pulso de SCL deixa o escravo travado avançar um bit, até ele soltar SDA */
+void sim_i2c_scl_solto(uint gpio) {
+    if (gpio >= NUM_BANK0_GPIOS || !pino_i2c[gpio] || !(gpio % 2)) return;
+
+    i2c_inst_t *i2c = instancia_do_pino(gpio);
+    i2c->pulsos_scl++;
+    if (i2c->travado && i2c->pulsos_para_liberar && --i2c->pulsos_para_liberar == 0) {
+        i2c->travado = false;
+    }
+}
+
+
+/* ============================================================================
+ *  Transações por DMA
+ * ============================================================================
+*/
+
+static void dma_i2c_conclui(i2c_inst_t *i2c) {
+    i2c->dma_fim_us = UINT64_MAX;
+    i2c->hw.raw_intr_stat |= i2c->dma_intr;
+    if (i2c->hw.intr_mask & i2c->hw.raw_intr_stat) {
+        sim_irq_sinaliza(i2c->indice ? I2C1_IRQ : I2C0_IRQ);
+    }
+}
+
+static uint64_t dma_i2c_proximo(void *ctx) {
+    (void)ctx;
+    return (i2c0->dma_fim_us < i2c1->dma_fim_us) ? i2c0->dma_fim_us : i2c1->dma_fim_us;
+}
+
+static void dma_i2c_dispara(void *ctx) {
+    (void)ctx;
+    i2c_inst_t *i2c = (i2c0->dma_fim_us <= i2c1->dma_fim_us) ? i2c0 : i2c1;
+    dma_i2c_conclui(i2c);
+}
+
+/**
+ * @brief Executa as palavras de IC_DATA_CMD entregues ao canal TX.
+ *
+ * Os trechos de escrita e de leitura (separados por RESTART ou pela troca de
+ * direção) vão ao dispositivo na hora; os bytes lidos seguem pelo DREQ de RX.
+ * STOP_DET (e TX_ABRT, após um NACK) só aparece no fim do tempo de barramento,
+ * entregue como fonte de despertar. Com SDA travada não há START nem STOP.
+*/
+void sim_i2c_dma_dispara(uint dreq, uint canal) {
+    static bool fonte_registrada = false;
+    if (!fonte_registrada) {
+        SimFonteDespertar fonte = { dma_i2c_proximo, dma_i2c_dispara, NULL };
+        sim_registra_despertar(&fonte);
+        fonte_registrada = true;
+    }
+
+    i2c_inst_t *i2c = (dreq == DREQ_I2C1_TX) ? i2c1 : i2c0;
+    dma_channel_hw_t *tx = dma_channel_hw_addr(canal);
+    const uint32_t *comandos = (const uint32_t *)tx->read_addr;
+    size_t n = tx->transfer_count;
+    tx->transfer_count = 0;
+
+    i2c->hw.raw_intr_stat = 0;
+    i2c->transacoes++;
+    i2c->sem_stop = false;
+    i2c->dma_intr = I2C_IC_RAW_INTR_STAT_STOP_DET_BITS;
+    if (i2c->travado) return;
+
+    SimDispositivoI2C *disp = procura(i2c, (uint8_t)(i2c->hw.tar & 0x7F));
+    uint8_t buf[64];
+    size_t transferidos = 0, trechos = 0;
+
+    for (size_t i = 0; disp && i < n; ) {
+        /* Agrupando um trecho de mesma direção até RESTART, troca de direção ou STOP */
+        bool leitura = (comandos[i] & I2C_IC_DATA_CMD_CMD_BITS) != 0;
+        size_t k = 0;
+        bool stop = false;
+        do {
+            buf[k++] = (uint8_t)comandos[i];
+            stop = (comandos[i] & I2C_IC_DATA_CMD_STOP_BITS) != 0;
+            i++;
+        } while (!stop && i < n && k < sizeof(buf)
+                 && ((comandos[i] & I2C_IC_DATA_CMD_CMD_BITS) != 0) == leitura
+                 && !(comandos[i] & I2C_IC_DATA_CMD_RESTART_BITS));
+
+        int ret = leitura ? disp->leitura(disp->ctx, buf, k, !stop)
+                          : disp->escrita(disp->ctx, buf, k, !stop);
+        trechos++;
+        if (ret < (int)k) {
+            i2c->dma_intr |= I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+            break;
+        }
+        transferidos += k;
+        for (size_t j = 0; leitura && j < k; j++) sim_dma_entrega(dreq + 1, buf[j]);
+        if (stop) break;
+    }
+    if (!disp) i2c->dma_intr |= I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+
+    /* Um byte de endereço por trecho (START e cada START repetido) */
+    size_t bytes = transferidos + (trechos ? trechos - 1 : 0);
+    i2c->dma_fim_us = sim_tempo_us() + duracao_us(i2c, bytes);
+}
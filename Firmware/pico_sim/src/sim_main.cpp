@@ -0,0 +1,178 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  sim_main.cpp
+ *
+ *    Description:  Executor da simulação: conecta os modelos ao barramento, chama
+ *                  setup() e executa loop() por N ciclos de despertar, imprimindo
+ *                  o tempo acordado por ciclo ao final.
+ *
+ *                  Uso: program [ciclos] [tombos_por_hora] [-v] [-f nacks:crc] [-b bordas:us]
+ *                               [-t ciclo] [-w ciclo] [-e pulsos_por_hora]
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 16:05:51
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+
+#include <Arduino.h>
+#include "pico_sim.h"
+#include "hardware/i2c.h"
+
+/* Ligação padrão da miniestação (mesmos pinos dos firmwares) */
+#define SIM_WAKE_GPIO       28
+#define SIM_HALL_GPIO       7
+#define SIM_SHT30_ENDERECO  0x44
+
+static uint32_t ciclos_executados = 0;
+static uint64_t acordado_setup_us = 0;
+static uint32_t transacoes_setup = 0;
+static uint32_t ciclo_travamento = UINT32_MAX;
+static uint32_t ciclo_nucleo_travado = UINT32_MAX;
+
+/* Reset pelo watchdog: o executor volta ao setup() */
+static jmp_buf reinicio;
+static uint32_t resets_watchdog = 0;
+
+void sim_reinicia_pelo_watchdog(void) {
+    resets_watchdog++;
+    longjmp(reinicio, 1);
+}
+
+void sim_encerra(int codigo, const char *motivo) {
+    uint64_t acordado = sim_tempo_acordado_us() - acordado_setup_us;
+
+    printf("\n==== pico_sim ====\n");
+    if (motivo) printf("motivo: %s\n", motivo);
+    printf("ciclos: %u\n", ciclos_executados);
+    printf("tempo simulado: %.3f s (dormindo %.3f s, em dormant %.3f s)\n",
+           sim_tempo_us() / 1e6, sim_tempo_dormindo_us() / 1e6, sim_tempo_dormant_us() / 1e6);
+    printf("acordado no setup: %.3f ms\n", acordado_setup_us / 1e3);
+    if (ciclos_executados) {
+        printf("acordado por ciclo: %.3f ms\n", acordado / 1e3 / ciclos_executados);
+    }
+    printf("transacoes I2C: %u | bytes UART: %u\n",
+           sim_i2c_transacoes(i2c1), sim_uart_bytes());
+    if (sim_chuva_tombos()) {
+        printf("tombos gerados: %llu", (unsigned long long)sim_chuva_tombos());
+        if (sim_chuva_repiques()) printf(" (+%llu bordas de repique)", (unsigned long long)sim_chuva_repiques());
+        printf("\n");
+    }
+    if (sim_ruido_pulsos()) {
+        printf("bordas espurias no INT: %llu\n", (unsigned long long)sim_ruido_pulsos());
+    }
+    if (sim_rosc_contagens()) {
+        printf("rosc: %u kHz (codigo 0x%08x), %u contagens de frequencia\n",
+               sim_rosc_khz(), sim_rosc_codigo(), sim_rosc_contagens());
+    }
+    if (sim_adc_conversoes()) {
+        printf("adc: %u conversoes, %.3f ms ligado\n", sim_adc_conversoes(), sim_adc_ligado_us() / 1e3);
+    }
+    if (sim_vreg_trocas()) {
+        printf("vreg: %u trocas de tensao\n", sim_vreg_trocas());
+    }
+    if (sim_tempo_us()) {
+        printf("corrente media (modelo): %.1f uA\n", sim_carga_uas() * 1e6 / sim_tempo_us());
+    }
+    if (ciclo_travamento != UINT32_MAX) {
+        printf("barramento I2C travado antes do ciclo %u: %u pulsos de SCL gerados, %s\n",
+               ciclo_travamento, sim_i2c_pulsos_scl(i2c1), i2c1->travado ? "ainda travado" : "liberado");
+    }
+    if (ciclo_nucleo_travado != UINT32_MAX || resets_watchdog) {
+        printf("watchdog: %u resets", resets_watchdog);
+        if (ciclo_nucleo_travado != UINT32_MAX) printf(" (nucleo travado no ciclo %u)", ciclo_nucleo_travado);
+        printf("\n");
+    }
+    if (ciclos_executados) {
+        printf("transacoes I2C por ciclo: %.2f\n",
+               (double)(sim_i2c_transacoes(i2c1) - transacoes_setup) / ciclos_executados);
+    }
+    fflush(stdout);
+    exit(codigo);
+}
+
+/* Nos testes (pio test) o main() é o do executor da Unity e o firmware não é compilado */
+#ifndef PIO_UNIT_TESTING
+/* Estado lido depois do longjmp() do watchdog fica em estáticas: locais não voláteis
+   alterados após o setjmp() ficam indeterminados */
+static uint32_t ciclos_solicitados = 10;
+static bool em_setup = false;
+
+int main(int argc, char **argv) {
+    uint32_t tombos_por_hora = 0;
+    uint32_t falhas_nack = 0, falhas_crc = 0;
+    uint32_t repique_bordas = 0, repique_us = 2000;
+    uint32_t ruido_por_hora = 0;
+    int posicional = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) {
+            sim_uart_eco(true);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            /* -f nacks:crc -> falhas injetadas no SHT30 */
+            char *fim;
+            falhas_nack = (uint32_t)strtoul(argv[++i], &fim, 10);
+            if (*fim == ':') falhas_crc = (uint32_t)strtoul(fim + 1, NULL, 10);
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            /* -b bordas:us -> repique do ímã após cada tombo */
+            char *fim;
+            repique_bordas = (uint32_t)strtoul(argv[++i], &fim, 10);
+            if (*fim == ':') repique_us = (uint32_t)strtoul(fim + 1, NULL, 10);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            /* -t ciclo -> escravo segurando SDA a partir desse ciclo (0 = antes do setup) */
+            ciclo_travamento = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            /* -w ciclo -> núcleo preso em um laço ao despertar nesse ciclo */
+            ciclo_nucleo_travado = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            /* -e pulsos_por_hora -> ruído (bordas espúrias) no INT do DS3231 */
+            ruido_por_hora = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (posicional == 0) {
+            ciclos_solicitados = (uint32_t)strtoul(argv[i], NULL, 10);
+            posicional++;
+        } else {
+            tombos_por_hora = (uint32_t)strtoul(argv[i], NULL, 10);
+        }
+    }
+
+    sim_ds3231_inicializa(i2c1, SIM_WAKE_GPIO);
+    sim_sht30_inicializa(i2c1, SIM_SHT30_ENDERECO);
+    sim_sht30_injeta_falhas(falhas_nack, falhas_crc);
+    sim_chuva_taxa(SIM_HALL_GPIO, tombos_por_hora);
+    sim_chuva_repique(repique_bordas, repique_us);
+    sim_ruido_gpio(SIM_WAKE_GPIO, ruido_por_hora);
+
+    if (ciclo_travamento == 0) sim_i2c_trava_barramento(i2c1, true);
+
+    /* Depois de um reset o ciclo interrompido conta como executado */
+    if (setjmp(reinicio) && !em_setup) ciclos_executados++;
+
+    em_setup = true;
+    setup();
+    em_setup = false;
+    if (!resets_watchdog) {
+        acordado_setup_us = sim_tempo_acordado_us();
+        transacoes_setup = sim_i2c_transacoes(i2c1);
+    }
+
+    while (ciclos_executados < ciclos_solicitados) {
+        if (ciclos_executados + 1 == ciclo_travamento) sim_i2c_trava_barramento(i2c1, true);
+        if (ciclos_executados + 1 == ciclo_nucleo_travado) sim_trava_nucleo();
+        loop();
+        ciclos_executados++;
+    }
+
+    sim_encerra(0, NULL);
+}
+#endif
@@ -0,0 +1,364 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  sim_pio_dma.c
+ *
+ *    Description:  Modelo da PIO (programas de carimbo de tempo e de contagem das
+ *                  bordas) e dos canais de DMA que esvaziam a FIFO RX em um anel na RAM.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 19:02:37
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include <string.h>
+
+#include "pico_sim.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/clocks.h"
+#include "hardware/i2c.h"
+
+#define SIM_FIFO_RX_MAX 8
+
+pio_hw_t pio0_sim_hw = { 0, { 0 } };
+pio_hw_t pio1_sim_hw = { 1, { 0 } };
+
+/* Estado de cada máquina de estados */
+typedef struct {
+    bool reservada;
+    bool habilitada;
+    bool configurada;
+    bool contador;              /* Programa conta_tombo: X só muda nas bordas aceitas */
+    pio_sm_config cfg;
+    uint32_t x;
+    uint32_t osr;
+    uint32_t txf;
+    bool tx_cheia;              /* Uma posição basta para carregar o OSR */
+    uint64_t bloqueio;          /* Ticks restantes em que o pino é ignorado */
+    double fracao;              /* Ciclos de PIO ainda não convertidos em decremento */
+    uint64_t t_base_us;         /* Instante até o qual x está atualizado */
+    uint32_t fifo[SIM_FIFO_RX_MAX];
+    uint fifo_nivel;
+} SimSm;
+
+static SimSm sms[2][NUM_PIO_STATE_MACHINES];
+static uint instrucoes_usadas[2];
+
+/* Programa carregado em cada offset, para identificar o modelo da SM no pio_sm_init() */
+static const struct pio_program *programas[2][PIO_INSTRUCTION_COUNT];
+
+/* Estado de cada canal de DMA */
+typedef struct {
+    bool reservado;
+    dma_channel_config cfg;
+    dma_channel_hw_t hw;
+} SimDma;
+
+static SimDma canais[NUM_DMA_CHANNELS];
+
+
+/* ============================================================================
+ *  Contador X (relógio da SM)
+ * ============================================================================
+*/
+
+/* A SM só recebe clock no sono se clk_sys da PIO estiver em SLEEP_EN0 (nunca em dormant) */
+static bool sm_com_clock(uint pio, const SimSm *s) {
+    uint32_t bit = pio ? CLOCKS_SLEEP_EN0_CLK_SYS_PIO1_BITS : CLOCKS_SLEEP_EN0_CLK_SYS_PIO0_BITS;
+    return s->habilitada && (!sim_dormindo() || (!sim_dormant() && (clocks_hw->sleep_en0 & bit)));
+}
+
+/* Avança X até o instante atual: um decremento a cada 2 ciclos da SM (no contador, só o bloqueio) */
+static void atualiza_sm(uint pio, SimSm *s) {
+    uint64_t agora = sim_tempo_us();
+    if (sm_com_clock(pio, s) && s->cfg.clkdiv > 0.0f) {
+        double ciclos = (double)(agora - s->t_base_us) * clock_get_hz(clk_sys) / 1e6 / s->cfg.clkdiv;
+        s->fracao += ciclos / 2.0;
+        uint64_t decrementos = (uint64_t)s->fracao;
+        s->fracao -= (double)decrementos;
+        if (!s->contador) s->x -= (uint32_t)decrementos;
+        s->bloqueio = (s->bloqueio > decrementos) ? s->bloqueio - decrementos : 0;
+    }
+    s->t_base_us = agora;
+}
+
+void sim_pio_sincroniza(void) {
+    for (uint p = 0; p < 2; p++) {
+        for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++) atualiza_sm(p, &sms[p][sm]);
+    }
+}
+
+
+/* ============================================================================
+ *  DMA
+ * ============================================================================
+*/
+
+static bool dma_com_clock(void) {
+    return !sim_dormindo() || (!sim_dormant() && (clocks_hw->sleep_en0 & CLOCKS_SLEEP_EN0_CLK_SYS_DMA_BITS));
+}
+
+/* Tenta entregar um valor da FIFO RX a um canal com o DREQ correspondente */
+static bool dma_transfere(uint dreq, uint32_t valor) {
+    if (!dma_com_clock()) return false;
+
+    for (uint c = 0; c < NUM_DMA_CHANNELS; c++) {
+        SimDma *d = &canais[c];
+        if (!d->reservado || d->cfg.dreq != dreq || d->hw.transfer_count == 0) continue;
+
+        uintptr_t passo = (uintptr_t)1 << d->cfg.tamanho;
+        memcpy((void *)d->hw.write_addr, &valor, passo);
+
+        if (d->cfg.incrementa_escrita) {
+            uintptr_t proximo = d->hw.write_addr + passo;
+            if (d->cfg.anel_na_escrita && d->cfg.bits_anel) {
+                uintptr_t mascara = ((uintptr_t)1 << d->cfg.bits_anel) - 1;
+                proximo = (d->hw.write_addr & ~mascara) | (proximo & mascara);
+            }
+            d->hw.write_addr = proximo;
+        }
+        d->hw.transfer_count--;
+        return true;
+    }
+    return false;
+}
+
+bool sim_dma_entrega(uint dreq, uint32_t valor) { return dma_transfere(dreq, valor); }
+
+int dma_claim_unused_channel(bool required) {
+    for (uint c = 0; c < NUM_DMA_CHANNELS; c++) {
+        if (!canais[c].reservado) {
+            canais[c].reservado = true;
+            return (int)c;
+        }
+    }
+    if (required) sim_encerra(1, "nenhum canal de DMA livre");
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel) { memset(&canais[channel], 0, sizeof(canais[channel])); }
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    (void)channel;
+    dma_channel_config c = { DMA_SIZE_32, true, false, false, 0, 0x3f };
+    return c;
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) { c->tamanho = size; }
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) { c->incrementa_leitura = incr; }
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) { c->incrementa_escrita = incr; }
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) { c->dreq = dreq; }
+
+void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits) {
+    c->anel_na_escrita = write;
+    c->bits_anel = size_bits;
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint32_t transfer_count, bool trigger) {
+    SimDma *d = &canais[channel];
+    d->cfg = *config;
+    d->hw.write_addr = (uintptr_t)write_addr;
+    d->hw.read_addr = (uintptr_t)read_addr;
+    d->hw.transfer_count = trigger ? transfer_count : 0;
+
+    /* Canal TX de um controlador I2C: a FIFO consome as palavras de comando e a transação começa */
+    if (trigger && (config->dreq == DREQ_I2C0_TX || config->dreq == DREQ_I2C1_TX)) {
+        sim_i2c_dma_dispara(config->dreq, channel);
+    }
+}
+
+void dma_channel_abort(uint channel) { canais[channel].hw.transfer_count = 0; }
+bool dma_channel_is_busy(uint channel) { return canais[channel].hw.transfer_count != 0; }
+dma_channel_hw_t *dma_channel_hw_addr(uint channel) { return &canais[channel].hw; }
+
+
+/* ============================================================================
+ *  PIO
+ * ============================================================================
+*/
+
+/**
+ * @brief Borda de descida em um pino: cada SM habilitada com esse jmp_pin empurra ~X.
+ *
+ * O caminho da borda custa 4 ciclos sem decremento (2 ticks), como no programa
+ * real, e é seguido do bloqueio de OSR + 1 ticks: bordas nesse intervalo
+ * (repique) não geram carimbo. Sem DMA ativo o valor fica na FIFO RX e é
+ * descartado quando ela está cheia (push noblock). No conta_tombo a borda só
+ * decrementa X e o bloqueio começa 2 ciclos (1 tick) depois dela.
+*/
+void sim_pio_borda_descida(uint gpio) {
+    for (uint p = 0; p < 2; p++) {
+        for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++) {
+            SimSm *s = &sms[p][sm];
+            if (!s->configurada || s->cfg.jmp_pin != gpio) continue;
+
+            atualiza_sm(p, s);
+            if (!sm_com_clock(p, s) || s->bloqueio) continue;
+
+            if (s->contador) {
+                s->x--;
+                s->bloqueio = (uint64_t)s->osr + 2;
+                continue;
+            }
+            uint32_t carimbo = ~s->x;
+            s->x += 2;
+            s->bloqueio = (uint64_t)s->osr + 3;
+
+            if (dma_transfere(p * 8u + 4u + sm, carimbo)) continue;
+            uint capacidade = (s->cfg.join == PIO_FIFO_JOIN_RX) ? 8 : 4;
+            if (s->fifo_nivel < capacidade) s->fifo[s->fifo_nivel++] = carimbo;
+        }
+    }
+}
+
+pio_sm_config pio_get_default_sm_config(void) {
+    pio_sm_config c = { 1.0f, 0xFFFFFFFFu, 0, 31, PIO_FIFO_JOIN_NONE, false };
+    return c;
+}
+
+void sm_config_set_wrap(pio_sm_config *c, uint wrap_target, uint wrap) {
+    c->wrap_target = wrap_target;
+    c->wrap = wrap;
+}
+
+void sm_config_set_jmp_pin(pio_sm_config *c, uint pin) { c->jmp_pin = pin; }
+void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join) { c->join = join; }
+void sm_config_set_clkdiv(pio_sm_config *c, float div) { c->clkdiv = div; }
+
+/* Só o autopush de 32 bits é modelado: cada IN de 32 bits vai direto para a FIFO RX */
+void sm_config_set_in_shift(pio_sm_config *c, bool shift_right, bool autopush, uint push_threshold) {
+    (void)shift_right;
+    c->autopush = autopush && (push_threshold == 32 || push_threshold == 0);
+}
+
+bool pio_can_add_program(PIO pio, const struct pio_program *program) {
+    return instrucoes_usadas[pio->indice] + program->length <= PIO_INSTRUCTION_COUNT;
+}
+
+uint pio_add_program(PIO pio, const struct pio_program *program) {
+    if (!pio_can_add_program(pio, program)) sim_encerra(1, "memoria de instrucoes da PIO cheia");
+    uint offset = instrucoes_usadas[pio->indice];
+    instrucoes_usadas[pio->indice] += program->length;
+    programas[pio->indice][offset] = program;
+    return offset;
+}
+
+int pio_claim_unused_sm(PIO pio, bool required) {
+    for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++) {
+        if (!sms[pio->indice][sm].reservada) {
+            sms[pio->indice][sm].reservada = true;
+            return (int)sm;
+        }
+    }
+    if (required) sim_encerra(1, "nenhuma SM livre na PIO");
+    return -1;
+}
+
+/* O programa é o que contém initial_pc; um que começa com "jmp pin" é o conta_tombo */
+static bool programa_contador(uint pio, uint pc) {
+    for (int offset = (int)pc; offset >= 0; offset--) {
+        const struct pio_program *prog = programas[pio][offset];
+        if (!prog) continue;
+        if (pc >= (uint)offset + prog->length) return false;
+        return (prog->instructions[0] & 0xE0E0u) == 0x00C0u;
+    }
+    return false;
+}
+
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config) {
+    SimSm *s = &sms[pio->indice][sm];
+    s->cfg = *config;
+    s->configurada = true;
+    s->contador = programa_contador(pio->indice, initial_pc);
+    s->habilitada = false;
+    s->x = 0;
+    s->osr = 0;
+    s->tx_cheia = false;
+    s->bloqueio = 0;
+    s->fracao = 0.0;
+    s->fifo_nivel = 0;
+    s->t_base_us = sim_tempo_us();
+}
+
+/* Trocar a união das FIFOs as esvazia; X, Y e OSR são preservados */
+void pio_sm_set_config(PIO pio, uint sm, const pio_sm_config *config) {
+    SimSm *s = &sms[pio->indice][sm];
+    atualiza_sm(pio->indice, s);
+    if (config->join != s->cfg.join) {
+        s->fifo_nivel = 0;
+        s->tx_cheia = false;
+    }
+    s->cfg = *config;
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled) {
+    SimSm *s = &sms[pio->indice][sm];
+    atualiza_sm(pio->indice, s);
+    s->habilitada = enabled;
+}
+
+void pio_sm_set_clkdiv(PIO pio, uint sm, float div) {
+    SimSm *s = &sms[pio->indice][sm];
+    atualiza_sm(pio->indice, s);
+    s->cfg.clkdiv = div;
+}
+
+/* Apenas PULL, IN de X com autopush e MOV para X a partir de NULL (com ou sem inversão)
+   são interpretados */
+void pio_sm_exec(PIO pio, uint sm, uint instr) {
+    SimSm *s = &sms[pio->indice][sm];
+    if ((instr & 0xE0FFu) == (0x4000u | ((uint)pio_x << 5))) {
+        atualiza_sm(pio->indice, s);
+        uint capacidade = (s->cfg.join == PIO_FIFO_JOIN_RX) ? 8 : 4;
+        if (s->cfg.autopush && s->fifo_nivel < capacidade) s->fifo[s->fifo_nivel++] = s->x;
+        return;
+    }
+    if ((instr & 0xE080u) == 0x8080u) {
+        if (s->tx_cheia) s->osr = s->txf;
+        s->tx_cheia = false;
+        return;
+    }
+    if ((instr & 0xE000u) != 0xA000u || (instr & 0x7u) != pio_null) return;
+
+    uint32_t valor = (instr & 0x18u) == 0x08u ? 0xFFFFFFFFu : 0;
+    if (((instr >> 5) & 0x7u) == pio_x) {
+        atualiza_sm(pio->indice, s);
+        s->x = valor;
+        s->fracao = 0.0;
+    }
+}
+
+/* Com a FIFO RX unida a TX não existe: o valor é descartado */
+void pio_sm_put(PIO pio, uint sm, uint32_t data) {
+    SimSm *s = &sms[pio->indice][sm];
+    if (s->cfg.join == PIO_FIFO_JOIN_RX) return;
+    s->txf = data;
+    s->tx_cheia = true;
+}
+
+uint pio_sm_get_rx_fifo_level(PIO pio, uint sm) { return sms[pio->indice][sm].fifo_nivel; }
+
+/* Com a FIFO RX vazia o núcleo ficaria preso para sempre */
+uint32_t pio_sm_get_blocking(PIO pio, uint sm) {
+    if (sms[pio->indice][sm].fifo_nivel == 0) sim_encerra(1, "pio_sm_get_blocking com a FIFO RX vazia");
+    return pio_sm_get(pio, sm);
+}
+
+uint32_t pio_sm_get(PIO pio, uint sm) {
+    SimSm *s = &sms[pio->indice][sm];
+    if (s->fifo_nivel == 0) return 0;
+    uint32_t valor = s->fifo[0];
+    memmove(&s->fifo[0], &s->fifo[1], (s->fifo_nivel - 1) * sizeof(uint32_t));
+    s->fifo_nivel--;
+    return valor;
+}
+
+/*****************************END OF FILE**************************************/
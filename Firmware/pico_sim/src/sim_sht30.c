@@ -0,0 +1,194 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  sim_sht30.c
+ *
+ *    Description:  Modelo do sensor SHT30: comandos de medição single shot (com e
+ *                  sem clock stretching), soft reset e injeção de falhas.
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 15:42:09
+ *       Revision:  none
+ *       Compiler:  -
+ *
+ *         Author:  Isaac Vinicius, isaacvinicius2121@alu.ufc.br
+ *   Organization:  UFC-Quixadá
+ *
+ * =====================================================================================
+*/
+
+#include <string.h>
+
+#include "pico_sim.h"
+#include "hardware/i2c.h"
+
+typedef struct {
+    float temperatura;
+    float umidade;
+    bool medicao_pendente;   /* Conversão iniciada e ainda não lida */
+    bool stretching;         /* Comando com clock stretching */
+    uint64_t pronto_us;      /* Instante em que a conversão termina */
+    uint64_t ocupado_ate_us; /* Soft reset em andamento */
+    bool periodico;          /* Aquisição periódica ativa */
+    uint64_t periodo_us;     /* Intervalo entre amostras do modo periódico */
+    uint64_t inicio_us;      /* Início do modo periódico */
+    uint64_t amostra_lida;   /* Índice da última amostra coletada (0 = nenhuma) */
+    bool fetch_pendente;     /* Fetch Data (0xE000) recebido, aguardando leitura */
+    uint32_t nacks;
+    uint32_t crc_corrompidos;
+} SimSHT30;
+
+static SimSHT30 sht;
+
+/* CRC-8 do SHT3x: polinômio 0x31, valor inicial 0xFF */
+static uint8_t crc8(const uint8_t *dados, size_t n) {
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < n; i++) {
+        crc ^= dados[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/* Duração máxima da medição por repetibilidade (datasheet SHT3x-DIS, tabela 4) */
+static uint64_t duracao_medicao_us(uint8_t lsb) {
+    switch (lsb) {
+        case 0x06: case 0x00: return 15500;   /* alta */
+        case 0x0D: case 0x0B: return 6500;    /* média */
+        default:              return 4500;    /* baixa (0x10 / 0x16) */
+    }
+}
+
+/* Período do modo periódico pelo MSB do comando (0x20..0x23, 0x27) */
+static uint64_t periodo_periodico_us(uint8_t msb) {
+    switch (msb) {
+        case 0x20: return 2000000;
+        case 0x21: return 1000000;
+        case 0x22: return 500000;
+        case 0x23: return 250000;
+        case 0x27: return 100000;
+        default:   return 0;
+    }
+}
+
+/* Índice da última amostra concluída no modo periódico (0 = nenhuma ainda) */
+static uint64_t amostra_periodica_atual(uint64_t agora) {
+    /* Cada amostra fica pronta ao fim da conversão (alta repetibilidade, pior caso) */
+    if (agora < sht.inicio_us + 15500) return 0;
+    return (agora - sht.inicio_us - 15500) / sht.periodo_us + 1;
+}
+
+static int sht30_escrita(void *ctx, const uint8_t *src, size_t n, bool nostop) {
+    (void)ctx; (void)nostop;
+    uint64_t agora = sim_tempo_us();
+
+    if (agora < sht.ocupado_ate_us) return -1;
+    if (sht.nacks) { sht.nacks--; return -1; }
+    if (n != 2) return -1;
+
+    uint16_t cmd = (uint16_t)((src[0] << 8) | src[1]);
+
+    /* No modo periódico só são aceitos Fetch Data, Break e soft reset */
+    if (sht.periodico) {
+        if (cmd == 0xE000) { sht.fetch_pendente = true; return 2; }
+        if (cmd == 0x3093) { sht.periodico = false; sht.ocupado_ate_us = agora + 1000; return 2; }
+        if (cmd != 0x30A2) return -1;
+        sht.periodico = false;
+    }
+
+    if (periodo_periodico_us(src[0])) {
+        sht.periodico = true;
+        sht.periodo_us = periodo_periodico_us(src[0]);
+        sht.inicio_us = agora;
+        sht.amostra_lida = 0;
+        sht.fetch_pendente = false;
+        sht.medicao_pendente = false;
+        return 2;
+    }
+
+    switch (cmd) {
+        case 0x2C06: case 0x2C0D: case 0x2C10:
+        case 0x2400: case 0x240B: case 0x2416:
+            /* Medição single shot */
+            if (sht.medicao_pendente && agora < sht.pronto_us) return -1;
+            sht.medicao_pendente = true;
+            sht.stretching = (src[0] == 0x2C);
+            sht.pronto_us = agora + duracao_medicao_us(src[1]);
+            return 2;
+
+        case 0x30A2:
+            /* Soft reset: o sensor não responde por até 1,5 ms */
+            sht.medicao_pendente = false;
+            sht.ocupado_ate_us = agora + 1500;
+            return 2;
+
+        default:
+            return -1;
+    }
+}
+
+static int sht30_leitura(void *ctx, uint8_t *dst, size_t n, bool nostop) {
+    (void)ctx; (void)nostop;
+
+    if (sht.nacks) { sht.nacks--; return -1; }
+
+    if (sht.periodico) {
+        /* Após Fetch Data: NACK se não houver amostra nova desde a última coleta */
+        uint64_t amostra = amostra_periodica_atual(sim_tempo_us());
+        if (!sht.fetch_pendente || amostra == 0 || amostra == sht.amostra_lida) {
+            sht.fetch_pendente = false;
+            return -1;
+        }
+        sht.fetch_pendente = false;
+        sht.amostra_lida = amostra;
+        sht.medicao_pendente = true;
+        sht.pronto_us = 0;
+    }
+    if (!sht.medicao_pendente) return -1;
+
+    if (sim_tempo_us() < sht.pronto_us) {
+        /* Sem stretching o sensor responde NACK enquanto converte */
+        if (!sht.stretching) return -1;
+        sim_avanca_us(sht.pronto_us - sim_tempo_us());
+    }
+
+    uint16_t raw_t = (uint16_t)((sht.temperatura + 45.0f) * 65535.0f / 175.0f + 0.5f);
+    uint16_t raw_h = (uint16_t)(sht.umidade * 65535.0f / 100.0f + 0.5f);
+    uint8_t quadro[6] = {
+        (uint8_t)(raw_t >> 8), (uint8_t)raw_t, 0,
+        (uint8_t)(raw_h >> 8), (uint8_t)raw_h, 0,
+    };
+    quadro[2] = crc8(&quadro[0], 2);
+    quadro[5] = crc8(&quadro[3], 2);
+
+    if (sht.crc_corrompidos) {
+        sht.crc_corrompidos--;
+        quadro[2] ^= 0x5A;
+    }
+
+    sht.medicao_pendente = false;
+    size_t m = (n < sizeof(quadro)) ? n : sizeof(quadro);
+    memcpy(dst, quadro, m);
+    return (int)n;
+}
+
+void sim_sht30_inicializa(i2c_inst_t *i2c, uint8_t endereco) {
+    memset(&sht, 0, sizeof(sht));
+    sht.temperatura = 25.0f;
+    sht.umidade = 50.0f;
+
+    static const SimDispositivoI2C disp = { sht30_escrita, sht30_leitura, NULL };
+    sim_i2c_conecta(i2c, endereco, &disp);
+}
+
+void sim_sht30_define(float temperatura, float umidade) {
+    sht.temperatura = temperatura;
+    sht.umidade = umidade;
+}
+
+void sim_sht30_injeta_falhas(uint32_t nacks, uint32_t crc_corrompidos) {
+    sht.nacks = nacks;
+    sht.crc_corrompidos = crc_corrompidos;
+}